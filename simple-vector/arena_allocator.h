@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Монотонная арена: раздаёт память из крупных блоков сдвигом указателя
+// и освобождает всё разом в Release() или в деструкторе.
+// Отдельные освобождения игнорируются, поэтому арена подходит для
+// короткоживущих векторов, например на время обработки одного запроса
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t initial_block_size = 4096) noexcept
+        : next_block_size_(std::max<size_t>(initial_block_size, 64)) {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        Release();
+    }
+
+    // Возвращает bytes байт, выровненных по alignment
+    void* Allocate(size_t bytes, size_t alignment) {
+        assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+        std::uintptr_t current = reinterpret_cast<std::uintptr_t>(current_);
+        std::uintptr_t aligned = (current + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        if (current_ == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(end_)) {
+            AllocateBlock(bytes + alignment);
+            current = reinterpret_cast<std::uintptr_t>(current_);
+            aligned = (current + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        }
+        current_ = reinterpret_cast<std::byte*>(aligned + bytes);
+        bytes_allocated_ += bytes;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    // Освобождает все блоки арены. Выданная ранее память становится недействительной
+    void Release() noexcept {
+        while (blocks_ != nullptr) {
+            Block* next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+        current_ = nullptr;
+        end_ = nullptr;
+    }
+
+    // Количество блоков, запрошенных у глобального operator new за время жизни арены
+    size_t GetBlockCount() const noexcept {
+        return block_count_;
+    }
+
+    // Суммарный объём памяти, выданной пользователям арены
+    size_t GetBytesAllocated() const noexcept {
+        return bytes_allocated_;
+    }
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block* next;
+    };
+
+    void AllocateBlock(size_t min_bytes) {
+        const size_t size = std::max(next_block_size_, min_bytes);
+        void* memory = ::operator new(sizeof(Block) + size);
+        blocks_ = new (memory) Block{blocks_};
+        current_ = reinterpret_cast<std::byte*>(blocks_ + 1);
+        end_ = current_ + size;
+        ++block_count_;
+        if (next_block_size_ <= std::numeric_limits<size_t>::max() / 2) {
+            next_block_size_ *= 2;
+        }
+    }
+
+    Block* blocks_ = nullptr;
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+    size_t next_block_size_;
+    size_t block_count_ = 0;
+    size_t bytes_allocated_ = 0;
+};
+
+// Аллокатор с состоянием, выдающий память из MonotonicArena.
+// Как и у std::pmr, аллокатор не распространяется при копировании, перемещении и обмене:
+// контейнер остаётся привязанным к арене, в которой был создан.
+// Арена должна пережить все контейнеры, использующие её
+template <typename Type>
+class ArenaAllocator {
+public:
+    using value_type = Type;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    ArenaAllocator(MonotonicArena& arena) noexcept
+        : arena_(&arena) {
+    }
+
+    template <typename Other>
+    ArenaAllocator(const ArenaAllocator<Other>& other) noexcept
+        : arena_(other.GetArena()) {
+    }
+
+    Type* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<Type*>(arena_->Allocate(n * sizeof(Type), alignof(Type)));
+    }
+
+    void deallocate(Type*, size_t) noexcept {
+    }
+
+    MonotonicArena* GetArena() const noexcept {
+        return arena_;
+    }
+
+private:
+    MonotonicArena* arena_;
+};
+
+template <typename Lhs, typename Rhs>
+bool operator==(const ArenaAllocator<Lhs>& lhs, const ArenaAllocator<Rhs>& rhs) noexcept {
+    return lhs.GetArena() == rhs.GetArena();
+}
+
+template <typename Lhs, typename Rhs>
+bool operator!=(const ArenaAllocator<Lhs>& lhs, const ArenaAllocator<Rhs>& rhs) noexcept {
+    return !(lhs == rhs);
+}
@@ -2,87 +2,182 @@
 
 #include <cassert>
 #include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
-template <typename Type>
+#include "relocate.h"
+
+#ifdef SIMPLE_VECTOR_CHECKED
+#include "checked.h"
+#endif
+
+// Владеет сырой памятью под массив элементов типа Type, полученной от аллокатора.
+// Память не инициализируется: конструирование и разрушение элементов
+// выполняет владелец (SimpleVector), и только для реально живых объектов.
+// Аллокатор хранится вместе с памятью и всегда перемещается/обменивается вместе с ней,
+// решения о propagate_on_container_* принимает владелец
+template <typename Type, typename Allocator = std::allocator<Type>>
 class ArrayPtr {
+    using AllocTraits = std::allocator_traits<Allocator>;
+    static_assert(std::is_same_v<typename AllocTraits::value_type, Type>,
+                  "Allocator::value_type must be the same as Type");
+
 public:
     // Инициализирует ArrayPtr нулевым указателем
-    ArrayPtr() = default;
+    constexpr ArrayPtr() = default;
+
+    constexpr explicit ArrayPtr(const Allocator& alloc) noexcept
+        : alloc_(alloc) {
+    }
 
-    // Создаёт в куче массив из size элементов типа Type.
+    // Выделяет память под size элементов типа Type, не создавая их.
     // Если size == 0, поле raw_ptr_ должно быть равно nullptr
-    explicit ArrayPtr(size_t size) {
+    constexpr explicit ArrayPtr(size_t size, const Allocator& alloc = Allocator())
+        : alloc_(alloc) {
         if (size != 0) {
-            raw_ptr_ = new Type[size];
+            raw_ptr_ = AllocTraits::allocate(alloc_, size);
+            size_ = size;
+            TrackAllocate();
         }
     }
 
-    // Конструктор из сырого указателя, хранящего адрес массива в куче либо nullptr
-    explicit ArrayPtr(Type* raw_ptr) noexcept {
-        raw_ptr_ = raw_ptr;
+    // Принимает во владение память под size элементов, полученную от alloc, либо nullptr
+    constexpr ArrayPtr(Type* raw_ptr, size_t size, const Allocator& alloc = Allocator()) noexcept
+        : alloc_(alloc),
+        raw_ptr_(raw_ptr),
+        size_(raw_ptr ? size : 0) {
+        TrackAllocate();
     }
 
     // Запрещаем копирование
     ArrayPtr(const ArrayPtr&) = delete;
     // Запрещаем присваивание
     ArrayPtr& operator=(const ArrayPtr&) = delete;
-    //Лучше добавить move семантику в этот класс, чтобы он мог служить, как полноценный умный указатель.
-    //ArrayPtr(ArrayPtr&&) = default;
-    //ArrayPtr& operator=(ArrayPtr&&) = default;
 
-    ArrayPtr(ArrayPtr&& other) {
-        raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
-    };
+    constexpr ArrayPtr(ArrayPtr&& other) noexcept
+        : alloc_(std::move(other.alloc_)),
+        raw_ptr_(std::exchange(other.raw_ptr_, nullptr)),
+        size_(std::exchange(other.size_, 0)) {
+    }
 
-    ArrayPtr& operator=(ArrayPtr&& other) {
+    constexpr ArrayPtr& operator=(ArrayPtr&& other) noexcept {
         if (this == &other)
             return *this;
-        delete raw_ptr_;
+        Deallocate();
+        alloc_ = std::move(other.alloc_);
         raw_ptr_ = std::exchange(other.raw_ptr_, nullptr);
+        size_ = std::exchange(other.size_, 0);
         return *this;
     }
 
-    ~ArrayPtr() {
-        delete[] raw_ptr_;
+    // Освобождает память. Элементы к этому моменту должны быть уже разрушены
+    constexpr ~ArrayPtr() {
+        Deallocate();
     }
 
     // Прекращает владением массивом в памяти, возвращает значение адреса массива
     // После вызова метода указатель на массив должен обнулиться
-    [[nodiscard]] Type* Release() noexcept {
-        Type* tmp = raw_ptr_;
-        raw_ptr_ = nullptr;
-        return tmp;
+    [[nodiscard]] constexpr Type* Release() noexcept {
+        TrackDeallocate();
+        size_ = 0;
+        return std::exchange(raw_ptr_, nullptr);
     }
 
     // Возвращает ссылку на элемент массива с индексом index
-    Type& operator[](size_t index) noexcept {
+    constexpr Type& operator[](size_t index) noexcept {
         return *(raw_ptr_ + index);
     }
 
     // Возвращает константную ссылку на элемент массива с индексом index
-    const Type& operator[](size_t index) const noexcept {
+    constexpr const Type& operator[](size_t index) const noexcept {
         return *(raw_ptr_ + index);
     }
 
     // Возвращает true, если указатель ненулевой, и false в противном случае
-    explicit operator bool() const {
-        // Заглушка. Реализуйте операцию самостоятельно
-        return !raw_ptr_ == 0;
+    constexpr explicit operator bool() const {
+        return raw_ptr_ != nullptr;
     }
 
     // Возвращает значение сырого указателя, хранящего адрес начала массива
-    Type* Get() const noexcept {
+    constexpr Type* Get() const noexcept {
         return raw_ptr_;
     }
 
-    // Обменивается значениям указателя на массив с объектом other
-    void swap(ArrayPtr& other) noexcept {
-        std::swap(raw_ptr_,other.raw_ptr_);
-       // Type* tmp = raw_ptr_;
-       // raw_ptr_ = other.raw_ptr_;
-       // other.raw_ptr_ = tmp;
+    // Возвращает количество элементов, под которое выделена память
+    constexpr size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    constexpr const Allocator& GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    constexpr Allocator& GetAllocator() noexcept {
+        return alloc_;
+    }
+
+    // Создаёт элемент в ячейке p через аллокатор
+    template <typename... Args>
+    constexpr void Construct(Type* p, Args&&... args) {
+        AllocTraits::construct(alloc_, p, std::forward<Args>(args)...);
+    }
+
+    // Разрушает count элементов, начиная с first, через аллокатор
+    constexpr void Destroy(Type* first, size_t count) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            AllocTraits::destroy(alloc_, first + i);
+        }
+    }
+
+    // Изменяет размер блока до new_size элементов через Allocator::reallocate,
+    // побайтно сохраняя содержимое. Подходит только для тривиально перемещаемых типов
+    // При исключении прежний блок остаётся во владении и в учёте проверяемого режима
+    constexpr void Reallocate(size_t new_size) requires ReallocatingAllocator<Allocator> {
+        Type* new_ptr = raw_ptr_ == nullptr ? AllocTraits::allocate(alloc_, new_size)
+                                            : alloc_.reallocate(raw_ptr_, size_, new_size);
+        TrackDeallocate();
+        raw_ptr_ = new_ptr;
+        size_ = new_size;
+        TrackAllocate();
+    }
+
+    // Обменивается значениям указателя на массив и аллокатором с объектом other
+    constexpr void swap(ArrayPtr& other) noexcept {
+        using std::swap;
+        swap(alloc_, other.alloc_);
+        swap(raw_ptr_, other.raw_ptr_);
+        swap(size_, other.size_);
     }
 
 private:
+    constexpr void Deallocate() noexcept {
+        if (raw_ptr_ != nullptr) {
+            TrackDeallocate();
+            AllocTraits::deallocate(alloc_, raw_ptr_, size_);
+        }
+    }
+
+    // В проверяемом режиме (checked.h) блоки учитываются по типу элементов,
+    // кроме выделенных при вычислении на этапе компиляции.
+    // Память, отданная через Release, перестаёт учитываться, пока её не примет другой ArrayPtr
+    constexpr void TrackAllocate() const noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        if (raw_ptr_ != nullptr && !std::is_constant_evaluated()) {
+            checked::AllocationRegistry::Instance().OnAllocate(typeid(Type), size_ * sizeof(Type));
+        }
+#endif
+    }
+
+    constexpr void TrackDeallocate() const noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        if (raw_ptr_ != nullptr && !std::is_constant_evaluated()) {
+            checked::AllocationRegistry::Instance().OnDeallocate(typeid(Type), size_ * sizeof(Type));
+        }
+#endif
+    }
+
+    [[no_unique_address]] Allocator alloc_ = Allocator();
     Type* raw_ptr_ = nullptr;
+    size_t size_ = 0;
 };
@@ -0,0 +1,1460 @@
+#include "arena_allocator.h"
+#include "bit_vector.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "de_vector.h"
+#include "flat_map.h"
+#include "benchmark.h"
+#include "mapped_vector.h"
+#include "parallel_algorithms.h"
+#include "serialization.h"
+#include "simd.h"
+#include "simple_span.h"
+#include "simple_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// Крупный тривиально копируемый элемент
+struct Pod256 {
+    uint64_t key;
+    char payload[248];
+};
+
+bool operator==(const Pod256& lhs, const Pod256& rhs) {
+    return memcmp(&lhs, &rhs, sizeof(Pod256)) == 0;
+}
+
+bool operator<(const Pod256& lhs, const Pod256& rhs) {
+    return memcmp(&lhs, &rhs, sizeof(Pod256)) < 0;
+}
+
+// Некопируемый элемент, как X в тестах
+class MoveOnly {
+public:
+    explicit MoveOnly(size_t x = 0)
+        : x_(x) {
+    }
+    MoveOnly(const MoveOnly&) = delete;
+    MoveOnly& operator=(const MoveOnly&) = delete;
+    MoveOnly(MoveOnly&& other) noexcept
+        : x_(exchange(other.x_, 0)) {
+    }
+    MoveOnly& operator=(MoveOnly&& other) noexcept {
+        x_ = exchange(other.x_, 0);
+        return *this;
+    }
+    size_t GetX() const {
+        return x_;
+    }
+
+private:
+    size_t x_;
+};
+
+template <typename Type>
+Type MakeValue(size_t i) {
+    if constexpr (is_same_v<Type, int>) {
+        return static_cast<int>(i);
+    }
+    else if constexpr (is_same_v<Type, string>) {
+        // Длиннее буфера малых строк, чтобы копирование обращалось к куче
+        return "benchmark-value-"s + to_string(i) + string(16, 'x');
+    }
+    else if constexpr (is_same_v<Type, Pod256>) {
+        Pod256 pod{};
+        pod.key = i;
+        return pod;
+    }
+    else {
+        return Type(i);
+    }
+}
+
+template <typename Type>
+size_t KeyOf(const Type& value) {
+    if constexpr (is_same_v<Type, int>) {
+        return static_cast<size_t>(value);
+    }
+    else if constexpr (is_same_v<Type, string>) {
+        return value.size();
+    }
+    else if constexpr (is_same_v<Type, Pod256>) {
+        return value.key;
+    }
+    else {
+        return value.GetX();
+    }
+}
+
+template <typename Type>
+string_view ElementName() {
+    if constexpr (is_same_v<Type, int>) {
+        return "int";
+    }
+    else if constexpr (is_same_v<Type, string>) {
+        return "string";
+    }
+    else if constexpr (is_same_v<Type, Pod256>) {
+        return "pod256";
+    }
+    else if constexpr (is_same_v<Type, uint8_t>) {
+        return "uint8";
+    }
+    else if constexpr (is_same_v<Type, int64_t>) {
+        return "int64";
+    }
+    else {
+        return "move_only";
+    }
+}
+
+// Единый интерфейс к SimpleVector и std::vector для общих замеров
+template <typename Type>
+struct SimpleVectorOps {
+    using Container = SimpleVector<Type>;
+    static constexpr string_view kName = "SimpleVector";
+
+    static void PushBack(Container& v, Type&& value) {
+        v.PushBack(move(value));
+    }
+    static void Reserve(Container& v, size_t n) {
+        v.Reserve(n);
+    }
+    static void Resize(Container& v, size_t n) {
+        v.Resize(n);
+    }
+    static void InsertAt(Container& v, size_t index, Type&& value) {
+        v.Insert(v.begin() + index, move(value));
+    }
+    static void EraseAt(Container& v, size_t index) {
+        v.Erase(v.begin() + index);
+    }
+    static size_t Size(const Container& v) {
+        return v.GetSize();
+    }
+};
+
+template <typename Type>
+struct StdVectorOps {
+    using Container = vector<Type>;
+    static constexpr string_view kName = "std::vector";
+
+    static void PushBack(Container& v, Type&& value) {
+        v.push_back(move(value));
+    }
+    static void Reserve(Container& v, size_t n) {
+        v.reserve(n);
+    }
+    static void Resize(Container& v, size_t n) {
+        v.resize(n);
+    }
+    static void InsertAt(Container& v, size_t index, Type&& value) {
+        v.insert(v.begin() + index, move(value));
+    }
+    static void EraseAt(Container& v, size_t index) {
+        v.erase(v.begin() + index);
+    }
+    static size_t Size(const Container& v) {
+        return v.size();
+    }
+};
+
+template <typename Type, typename Ops>
+typename Ops::Container MakeFilled(size_t n) {
+    typename Ops::Container v;
+    Ops::Reserve(v, n);
+    for (size_t i = 0; i < n; ++i) {
+        Ops::PushBack(v, MakeValue<Type>(i));
+    }
+    return v;
+}
+
+template <typename Type, template <typename> class OpsTemplate>
+void RunContainerSuite(BenchmarkReporter& reporter) {
+    using Ops = OpsTemplate<Type>;
+    using Container = typename Ops::Container;
+    const bool quick = reporter.GetOptions().quick;
+    const size_t n = quick ? 1000 : 100000;
+    const size_t shift_n = quick ? 200 : 2000;
+
+    auto report = [&](string_view name, size_t size, double ns) {
+        reporter.Report({"container", string(name), string(Ops::kName), string(ElementName<Type>()), size, ns, {}});
+    };
+
+    if (reporter.Enabled("container", "push_back")) {
+        report("push_back", n, reporter.Measure([&](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                Container v;
+                for (size_t i = 0; i < n; ++i) {
+                    Ops::PushBack(v, MakeValue<Type>(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        }));
+    }
+    if (reporter.Enabled("container", "push_back_reserved")) {
+        report("push_back_reserved", n, reporter.Measure([&](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                Container v;
+                Ops::Reserve(v, n);
+                for (size_t i = 0; i < n; ++i) {
+                    Ops::PushBack(v, MakeValue<Type>(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        }));
+    }
+    if (reporter.Enabled("container", "insert_front")) {
+        report("insert_front", shift_n, reporter.Measure([&](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                Container v;
+                for (size_t i = 0; i < shift_n; ++i) {
+                    Ops::InsertAt(v, 0, MakeValue<Type>(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * shift_n;
+        }));
+    }
+    if (reporter.Enabled("container", "insert_middle")) {
+        report("insert_middle", shift_n, reporter.Measure([&](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                Container v;
+                for (size_t i = 0; i < shift_n; ++i) {
+                    Ops::InsertAt(v, Ops::Size(v) / 2, MakeValue<Type>(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * shift_n;
+        }));
+    }
+    if (reporter.Enabled("container", "erase_front")) {
+        report("erase_front", shift_n, reporter.Measure([&](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                Container v = MakeFilled<Type, Ops>(shift_n);
+                while (Ops::Size(v) != 0) {
+                    Ops::EraseAt(v, 0);
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * shift_n;
+        }));
+    }
+    if constexpr (is_default_constructible_v<Type>) {
+        if (reporter.Enabled("container", "resize")) {
+            report("resize", n, reporter.Measure([&](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    Container v;
+                    Ops::Resize(v, n);
+                    DoNotOptimize(v);
+                }
+                return iterations * n;
+            }));
+        }
+    }
+    const Container source = MakeFilled<Type, Ops>(n);
+    if constexpr (is_copy_constructible_v<Type>) {
+        if (reporter.Enabled("container", "copy")) {
+            report("copy", n, reporter.Measure([&](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    Container copy(source);
+                    DoNotOptimize(copy);
+                }
+                return iterations * n;
+            }));
+        }
+    }
+    if (reporter.Enabled("container", "move")) {
+        Container moving = MakeFilled<Type, Ops>(n);
+        report("move", n, reporter.Measure([&](size_t iterations) {
+            for (size_t it = 0; it < iterations; ++it) {
+                Container moved(move(moving));
+                moving = move(moved);
+                DoNotOptimize(moving);
+            }
+            return iterations;
+        }));
+    }
+    if (reporter.Enabled("container", "iterate")) {
+        report("iterate", n, reporter.Measure([&](size_t iterations) {
+            size_t sum = 0;
+            for (size_t it = 0; it < iterations; ++it) {
+                for (const Type& value : source) {
+                    sum += KeyOf(value);
+                }
+                DoNotOptimize(sum);
+            }
+            return iterations * n;
+        }));
+    }
+    if constexpr (is_copy_constructible_v<Type>) {
+        const Container other(source);
+        if (reporter.Enabled("container", "equal")) {
+            report("equal", n, reporter.Measure([&](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    bool equal = source == other;
+                    DoNotOptimize(equal);
+                }
+                return iterations * n;
+            }));
+        }
+        if (reporter.Enabled("container", "less")) {
+            report("less", n, reporter.Measure([&](size_t iterations) {
+                for (size_t it = 0; it < iterations; ++it) {
+                    bool less = source < other;
+                    DoNotOptimize(less);
+                }
+                return iterations * n;
+            }));
+        }
+    }
+}
+
+template <typename Type>
+void RunContainerSuites(BenchmarkReporter& reporter) {
+    RunContainerSuite<Type, SimpleVectorOps>(reporter);
+    RunContainerSuite<Type, StdVectorOps>(reporter);
+}
+
+// Обёртка над std::allocator, считающая обращения к куче
+template <typename Type>
+struct CountingAllocator : std::allocator<Type> {
+    using value_type = Type;
+
+    CountingAllocator() = default;
+    template <typename Other>
+    CountingAllocator(const CountingAllocator<Other>&) noexcept {
+    }
+
+    Type* allocate(size_t n) {
+        ++allocations;
+        return std::allocator<Type>::allocate(n);
+    }
+
+    inline static size_t allocations = 0;
+};
+
+// Сравнивает число обращений к куче для множества короткоживущих векторов
+void RunArenaSuite(BenchmarkReporter& reporter) {
+    if (!reporter.Enabled("arena", "push_back")) {
+        return;
+    }
+    const size_t vectors_per_request = 4;
+    const size_t items_per_vector = 100;
+    const size_t ops_per_request = vectors_per_request * items_per_vector;
+
+    CountingAllocator<int>::allocations = 0;
+    size_t requests = 0;
+    const double heap_ns = reporter.Measure([&](size_t iterations) {
+        for (size_t r = 0; r < iterations; ++r) {
+            for (size_t k = 0; k < vectors_per_request; ++k) {
+                SimpleVector<int, CountingAllocator<int>> v;
+                for (size_t i = 0; i < items_per_vector; ++i) {
+                    v.PushBack(static_cast<int>(i));
+                }
+                DoNotOptimize(v);
+            }
+        }
+        requests += iterations;
+        return iterations * ops_per_request;
+    });
+    reporter.Report({"arena", "push_back", "SimpleVector", "int", items_per_vector, heap_ns,
+                     {{"allocations_per_request", double(CountingAllocator<int>::allocations) / requests}}});
+
+    size_t blocks = 0;
+    requests = 0;
+    const double arena_ns = reporter.Measure([&](size_t iterations) {
+        for (size_t r = 0; r < iterations; ++r) {
+            MonotonicArena arena;
+            for (size_t k = 0; k < vectors_per_request; ++k) {
+                SimpleVector<int, ArenaAllocator<int>> v(arena);
+                for (size_t i = 0; i < items_per_vector; ++i) {
+                    v.PushBack(static_cast<int>(i));
+                }
+                DoNotOptimize(v);
+            }
+            blocks += arena.GetBlockCount();
+        }
+        requests += iterations;
+        return iterations * ops_per_request;
+    });
+    reporter.Report({"arena", "push_back", "SimpleVector<ArenaAllocator>", "int", items_per_vector, arena_ns,
+                     {{"allocations_per_request", double(blocks) / requests}}});
+}
+
+// Сравнивает циклы создание/заполнение/разрушение маленьких векторов
+void RunSmallVectorSuite(BenchmarkReporter& reporter) {
+    if (!reporter.Enabled("small_vector", "construct_append_destroy")) {
+        return;
+    }
+    for (size_t items : {1, 4, 8, 16}) {
+        const double simple_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SimpleVector<int> v;
+                for (size_t i = 0; i < items; ++i) {
+                    v.PushBack(static_cast<int>(i + r));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations;
+        });
+        reporter.Report({"small_vector", "construct_append_destroy", "SimpleVector", "int", items, simple_ns, {}});
+
+        const double small_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SmallVector<int, 8> v;
+                for (size_t i = 0; i < items; ++i) {
+                    v.PushBack(static_cast<int>(i + r));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations;
+        });
+        reporter.Report({"small_vector", "construct_append_destroy", "SmallVector<8>", "int", items, small_ns, {}});
+
+        const double static_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                StaticVector<int, 16> v;
+                for (size_t i = 0; i < items; ++i) {
+                    v.PushBack(static_cast<int>(i + r));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations;
+        });
+        reporter.Report({"small_vector", "construct_append_destroy", "StaticVector<16>", "int", items, static_ns, {}});
+    }
+}
+
+// Сравнивает однопроходный EraseIf с удалением по одному элементу
+void RunEraseIfSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? 2000 : 50000;
+    auto is_odd = [](int x) { return x % 2 != 0; };
+    SimpleVector<int> source(n);
+    iota(source.begin(), source.end(), 0);
+
+    if (reporter.Enabled("erase_if", "repeated_erase")) {
+        const double ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SimpleVector<int> v(source);
+                for (auto it = v.begin(); it != v.end();) {
+                    it = is_odd(*it) ? v.Erase(it) : it + 1;
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"erase_if", "repeated_erase", "SimpleVector", "int", n, ns, {}});
+    }
+    if (reporter.Enabled("erase_if", "erase_if")) {
+        const double ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SimpleVector<int> v(source);
+                v.EraseIf(is_odd);
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"erase_if", "erase_if", "SimpleVector", "int", n, ns, {}});
+    }
+}
+
+// Масштабирование параллельных алгоритмов от одного потока до всех аппаратных.
+// counters: threads — число потоков, speedup — ускорение относительно одного потока
+void RunParallelSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 18) : (size_t(1) << 24);
+    const size_t max_threads = max(1u, thread::hardware_concurrency());
+    SimpleVector<int> thread_counts;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.PushBack(static_cast<int>(threads));
+    }
+    thread_counts.PushBack(static_cast<int>(max_threads));
+
+    SimpleVector<int> source(n);
+    for (size_t i = 0; i < n; ++i) {
+        source[i] = static_cast<int>((i * 2654435761u) % n);
+    }
+
+    // Запускает замер name на пулах всех размеров; run(pool) обрабатывает n элементов
+    auto measure = [&](const char* name, auto run) {
+        if (!reporter.Enabled("parallel", name)) {
+            return;
+        }
+        double single_thread_ns = 0;
+        for (const int threads : thread_counts) {
+            ThreadPool pool(threads);
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    run(pool);
+                }
+                return iterations * n;
+            });
+            if (threads == 1) {
+                single_thread_ns = ns;
+            }
+            reporter.Report({"parallel", name, "SimpleVector", "int", n, ns,
+                             {{"threads", threads}, {"speedup", single_thread_ns / ns}}});
+        }
+    };
+
+    SimpleVector<int> work(source);
+    measure("for_each", [&](ThreadPool& pool) {
+        ParallelForEach(work, [](int& x) { x = x * 3 + 1; }, pool);
+        DoNotOptimize(work[0]);
+    });
+    measure("transform", [&](ThreadPool& pool) {
+        DoNotOptimize(ParallelTransform(source, [](int x) { return int64_t(x) * x; }, pool));
+    });
+    measure("reduce", [&](ThreadPool& pool) {
+        DoNotOptimize(ParallelReduce(source, int64_t(0), plus<>{}, pool));
+    });
+    measure("inclusive_scan", [&](ThreadPool& pool) {
+        ParallelInclusiveScan(source.begin(), source.end(), work.begin(), plus<>{}, pool);
+        DoNotOptimize(work[n - 1]);
+    });
+    measure("sort", [&](ThreadPool& pool) {
+        copy(source.begin(), source.end(), work.begin());
+        ParallelSort(work, less<>{}, pool);
+        DoNotOptimize(work[0]);
+    });
+    measure("filter", [&](ThreadPool& pool) {
+        DoNotOptimize(ParallelFilter(source, [](int x) { return x % 3 == 0; }, pool));
+    });
+}
+
+// Сравнивает однопоточный SimpleVector(size, value) с параллельной инициализацией
+// при размещениях kLocal и kInterleave: полосу записи при первом касании страниц
+// и последующий параллельный проход по вектору тем же пулом
+void RunFirstTouchSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 20) : (size_t(1) << 24);
+    const int threads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    ThreadPool pool(threads);
+    auto gb_per_s = [](double ns_per_element) {
+        return double(sizeof(double)) / ns_per_element;
+    };
+
+    struct Variant {
+        const char* container;
+        // Создаёт вектор из n копий 1.0
+        SimpleVector<double> (*make)(size_t n, ThreadPool& pool);
+    };
+    const Variant variants[] = {
+        {"SimpleVector", [](size_t n, ThreadPool&) { return SimpleVector<double>(n, 1.0); }},
+        {"ParallelMakeVector/local",
+         [](size_t n, ThreadPool& pool) { return ParallelMakeVector<double>(n, 1.0, Placement::kLocal, pool); }},
+        {"ParallelMakeVector/interleave",
+         [](size_t n, ThreadPool& pool) { return ParallelMakeVector<double>(n, 1.0, Placement::kInterleave, pool); }},
+    };
+    for (const Variant& variant : variants) {
+        if (reporter.Enabled("first_touch", "init")) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    DoNotOptimize(variant.make(n, pool));
+                }
+                return iterations * n;
+            });
+            reporter.Report({"first_touch", "init", variant.container, "double", n, ns,
+                             {{"threads", threads}, {"gb_per_s", gb_per_s(ns)}}});
+        }
+        if (reporter.Enabled("first_touch", "parallel_scan")) {
+            const SimpleVector<double> v = variant.make(n, pool);
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    DoNotOptimize(ParallelReduce(v, 0.0, plus<>{}, pool));
+                }
+                return iterations * n;
+            });
+            reporter.Report({"first_touch", "parallel_scan", variant.container, "double", n, ns,
+                             {{"threads", threads}, {"gb_per_s", gb_per_s(ns)}}});
+        }
+    }
+}
+
+// Сравнивает векторные ядра simd.h на каждом наборе инструкций со стандартными алгоритмами.
+// Имя замера: операция/реализация, где реализация — std, scalar, sse2 или avx2
+template <typename Type>
+void RunSimdSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? 4096 : (size_t(1) << 20);
+    // Равные векторы сравниваются до конца, а отсутствующее значение ищется по всему вектору
+    const Type absent = 0;
+    SimpleVector<Type> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        v[i] = static_cast<Type>((i * 2654435761u) >> 7);
+        if (v[i] == absent) {
+            v[i] = 1;
+        }
+    }
+    const SimpleVector<Type> w(v);
+
+    auto measure = [&](string_view op, string_view impl, auto run) {
+        const string name = string(op) + '/' + string(impl);
+        if (!reporter.Enabled("simd", name)) {
+            return;
+        }
+        const double ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                DoNotOptimize(run());
+            }
+            return iterations * n;
+        });
+        reporter.Report({"simd", name, "SimpleVector", string(ElementName<Type>()), n, ns, {}});
+    };
+
+    measure("equal", "std", [&] { return equal(v.begin(), v.end(), w.begin(), w.end()); });
+    measure("less", "std", [&] { return lexicographical_compare(v.begin(), v.end(), w.begin(), w.end()); });
+    measure("find", "std", [&] { return find(v.begin(), v.end(), absent); });
+    measure("count", "std", [&] { return count(v.begin(), v.end(), v[0]); });
+    measure("min", "std", [&] { return min_element(v.begin(), v.end()); });
+    measure("sum", "std", [&] { return accumulate(v.begin(), v.end(), simd::SumType<Type>{0}); });
+
+    const simd::SimdLevel detected = simd::DetectSimdLevel();
+    const pair<simd::SimdLevel, string_view> levels[] = {
+        {simd::SimdLevel::kScalar, "scalar"}, {simd::SimdLevel::kSse2, "sse2"}, {simd::SimdLevel::kAvx2, "avx2"}};
+    for (const auto& [level, impl] : levels) {
+        if (level > detected) {
+            continue;
+        }
+        simd::SetSimdLevel(level);
+        measure("equal", impl, [&] { return v == w; });
+        measure("less", impl, [&] { return v < w; });
+        measure("find", impl, [&] { return Find(v, absent); });
+        measure("count", impl, [&] { return Count(v, v[0]); });
+        measure("min", impl, [&] { return MinElement(v); });
+        measure("sum", impl, [&] { return Sum(v); });
+    }
+    simd::SetSimdLevel(detected);
+}
+
+// Пропускная способность добавления из нескольких потоков:
+// ConcurrentSimpleVector против SimpleVector под мьютексом.
+// Потоков бывает больше, чем ядер: так видно, как мьютекс простаивает при вытеснении владельца
+void RunConcurrentSuite(BenchmarkReporter& reporter) {
+    const size_t total = reporter.GetOptions().quick ? (size_t(1) << 16) : (size_t(1) << 21);
+    const size_t max_threads = max<size_t>(4, thread::hardware_concurrency());
+
+    // Запускает threads потоков, каждый из которых вызывает push(value) для своей доли элементов
+    auto run_threads = [total](size_t threads, auto push) {
+        vector<thread> workers;
+        for (size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([&push, t, threads, total] {
+                for (size_t i = t; i < total; i += threads) {
+                    push(static_cast<int64_t>(i));
+                }
+            });
+        }
+        for (thread& worker : workers) {
+            worker.join();
+        }
+    };
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        if (reporter.Enabled("concurrent", "push_back/lock_free")) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    ConcurrentSimpleVector<int64_t> v;
+                    run_threads(threads, [&v](int64_t x) { v.PushBack(x); });
+                    DoNotOptimize(v.GetSize());
+                }
+                return iterations * total;
+            });
+            reporter.Report({"concurrent", "push_back/lock_free", "ConcurrentSimpleVector", "int64", total, ns,
+                             {{"threads", double(threads)}}});
+        }
+        if (reporter.Enabled("concurrent", "push_back/mutex")) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    SimpleVector<int64_t> v;
+                    mutex m;
+                    run_threads(threads, [&v, &m](int64_t x) {
+                        lock_guard guard(m);
+                        v.PushBack(x);
+                    });
+                    DoNotOptimize(v.GetSize());
+                }
+                return iterations * total;
+            });
+            reporter.Report({"concurrent", "push_back/mutex", "SimpleVector+mutex", "int64", total, ns,
+                             {{"threads", double(threads)}}});
+        }
+    }
+}
+
+// Снимки большого вектора, которые раздаются читателям: SimpleVector копирует элементы
+// при каждом снимке, CowSimpleVector — только когда снимок изменяют.
+// В замере snapshot каждый снимок только читается, в snapshot_mutate изменяется
+// каждый шестнадцатый. counters: copies — доля снимков, потребовавших копирования
+void RunCowSuite(BenchmarkReporter& reporter) {
+    const size_t kMutateEvery = 16;
+    for (size_t n : {size_t(1000), reporter.GetOptions().quick ? size_t(10000) : size_t(1000000)}) {
+        SimpleVector<int> plain(n);
+        iota(plain.begin(), plain.end(), 0);
+        const CowSimpleVector<int> cow{SimpleVector<int>(plain)};
+
+        // Снимок, чтение одного элемента и изменение, если mutate
+        auto run = [&](const auto& source, size_t iterations, bool mutate) {
+            for (size_t r = 0; r < iterations; ++r) {
+                auto snapshot = source;
+                DoNotOptimize(as_const(snapshot)[r % n]);
+                if (mutate && r % kMutateEvery == 0) {
+                    snapshot[r % n] = 0;
+                    DoNotOptimize(snapshot);
+                }
+            }
+            return iterations;
+        };
+
+        for (bool mutate : {false, true}) {
+            const string name = mutate ? "snapshot_mutate"s : "snapshot"s;
+            if (!reporter.Enabled("cow", name)) {
+                continue;
+            }
+            const double plain_ns = reporter.Measure([&](size_t iterations) { return run(plain, iterations, mutate); });
+            reporter.Report({"cow", name, "SimpleVector", "int", n, plain_ns, {{"copies", 1.0}}});
+            const double cow_ns = reporter.Measure([&](size_t iterations) { return run(cow, iterations, mutate); });
+            reporter.Report({"cow", name, "CowSimpleVector", "int", n, cow_ns, {{"copies", mutate ? 1.0 / kMutateEvery : 0.0}}});
+        }
+    }
+}
+
+// Вектор в файле, отображённом в память. open — время открытия существующего файла,
+// которое не должно зависеть от его размера; push_back — добавление в файл
+// против SimpleVector в памяти; scan — полный проход по только что открытому файлу
+void RunMappedSuite(BenchmarkReporter& reporter) {
+    struct Record {
+        int64_t id;
+        double value;
+    };
+    const string path = (filesystem::temp_directory_path() / "simple_vector_mapped_benchmark.bin"s).string();
+    const size_t large = reporter.GetOptions().quick ? 100000 : 4000000;
+    for (size_t n : {size_t(1000), large}) {
+        filesystem::remove(path);
+        if (reporter.Enabled("mapped", "push_back")) {
+            const double mapped_ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    MappedSimpleVector<Record> v(path);
+                    v.Clear();
+                    for (size_t i = 0; i < n; ++i) {
+                        v.PushBack({int64_t(i), double(i)});
+                    }
+                    DoNotOptimize(v.GetSize());
+                }
+                return iterations * n;
+            });
+            reporter.Report({"mapped", "push_back", "MappedSimpleVector", "record16", n, mapped_ns, {}});
+            const double memory_ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    SimpleVector<Record> v;
+                    for (size_t i = 0; i < n; ++i) {
+                        v.PushBack({int64_t(i), double(i)});
+                    }
+                    DoNotOptimize(v.GetSize());
+                }
+                return iterations * n;
+            });
+            reporter.Report({"mapped", "push_back", "SimpleVector", "record16", n, memory_ns, {}});
+        }
+
+        {
+            MappedSimpleVector<Record> v(path);
+            v.Resize(n, {1, 1.0});
+        }
+        if (reporter.Enabled("mapped", "open")) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    MappedSimpleVector<Record> v(path, MapMode::kReadOnly);
+                    DoNotOptimize(v.GetSize());
+                }
+                return iterations;
+            });
+            reporter.Report({"mapped", "open", "MappedSimpleVector", "record16", n, ns, {}});
+        }
+        if (reporter.Enabled("mapped", "scan")) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    const MappedSimpleVector<Record> v(path, MapMode::kReadOnly);
+                    int64_t sum = 0;
+                    for (const Record& record : v) {
+                        sum += record.id;
+                    }
+                    DoNotOptimize(sum);
+                }
+                return iterations * n;
+            });
+            reporter.Report({"mapped", "scan", "MappedSimpleVector", "record16", n, ns, {}});
+        }
+    }
+    filesystem::remove(path);
+}
+
+// Пропускная способность сериализации int64: запись в файл и чтение из него
+// (обычно из кеша страниц), представление поверх буфера с проверкой контрольной суммы и без неё,
+// а также CRC32C отдельно. counters: gb_per_s — гигабайт данных в секунду
+void RunSerializationSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 14) : (size_t(1) << 22);
+    const double bytes = double(n * sizeof(int64_t));
+    SimpleVector<int64_t> v(n);
+    iota(v.begin(), v.end(), 0);
+    stringstream serialized;
+    Serialize(serialized, v);
+    const string buffer_bytes = serialized.str();
+    SimpleVector<int64_t> buffer(buffer_bytes.size() / sizeof(int64_t));
+    memcpy(buffer.GetData(), buffer_bytes.data(), buffer_bytes.size());
+
+    auto report = [&](string_view name, string_view container, auto run) {
+        if (!reporter.Enabled("serialization", name)) {
+            return;
+        }
+        const double ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                run();
+            }
+            return iterations * n;
+        });
+        reporter.Report({"serialization", string(name), string(container), "int64", n, ns,
+                         {{"gb_per_s", bytes / (ns * n)}}});
+    };
+
+    const string path = (filesystem::temp_directory_path() / "simple_vector_serialized_benchmark.bin"s).string();
+    report("serialize", "SimpleVector", [&] {
+        ofstream out(path, ios::binary | ios::trunc);
+        Serialize(out, v);
+        DoNotOptimize(out.tellp());
+    });
+    report("deserialize", "SimpleVector", [&] {
+        ifstream in(path, ios::binary);
+        DoNotOptimize(Deserialize<int64_t>(in).GetSize());
+    });
+    filesystem::remove(path);
+    report("view/checked", "SerializedView", [&] {
+        const SerializedView<int64_t> view(buffer.GetData(), buffer_bytes.size());
+        DoNotOptimize(view.GetSize());
+    });
+    report("view/unchecked", "SerializedView", [&] {
+        const SerializedView<int64_t> view(buffer.GetData(), buffer_bytes.size(), false);
+        DoNotOptimize(view.GetSize());
+    });
+    report("crc32c/hardware", "Crc32c", [&] {
+        DoNotOptimize(ComputeCrc32c(v.GetData(), n * sizeof(int64_t)));
+    });
+    const simd::SimdLevel level = simd::GetSimdLevel();
+    simd::SetSimdLevel(simd::SimdLevel::kScalar);
+    report("crc32c/scalar", "Crc32c", [&] {
+        DoNotOptimize(ComputeCrc32c(v.GetData(), n * sizeof(int64_t)));
+    });
+    simd::SetSimdLevel(level);
+}
+
+// Сумма по скользящим срезам большого буфера: копия среза в новый вектор против
+// представления SimpleSpan без выделения памяти
+void RunSpanSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 14) : (size_t(1) << 20);
+    SimpleVector<int> buffer(n);
+    iota(buffer.begin(), buffer.end(), 0);
+    for (size_t slice : {size_t(64), size_t(4096)}) {
+        if (reporter.Enabled("span", "slice_sum/copy")) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    const size_t offset = (r * 997) % (n - slice);
+                    SimpleVector<int> copy;
+                    copy.Insert(copy.end(), buffer.begin() + offset, buffer.begin() + offset + slice);
+                    DoNotOptimize(Sum(copy));
+                }
+                return iterations;
+            });
+            reporter.Report({"span", "slice_sum/copy", "SimpleVector", "int", slice, ns, {}});
+        }
+        if (reporter.Enabled("span", "slice_sum/span")) {
+            const ConstSimpleSpan<int> all = buffer;
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    const size_t offset = (r * 997) % (n - slice);
+                    DoNotOptimize(Sum(all.Subspan(offset, slice)));
+                }
+                return iterations;
+            });
+            reporter.Report({"span", "slice_sum/span", "SimpleSpan", "int", slice, ns, {}});
+        }
+    }
+}
+
+// Проход по одному-двум полям записи из восьми полей: массив структур SimpleVector<Particle>
+// против структуры массивов SoaVector. sum_mass читает одно поле, integrate — обновляет
+// координату по скорости. counters: bytes_per_row — сколько байт записи читает проход
+void RunSoaSuite(BenchmarkReporter& reporter) {
+    struct Particle {
+        double x, y, z;
+        double vx, vy, vz;
+        double mass;
+        int64_t id;
+    };
+    using Particles = SoaVector<double, double, double, double, double, double, double, int64_t>;
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 14) : (size_t(1) << 21);
+    SimpleVector<Particle> aos;
+    Particles soa;
+    aos.Reserve(n);
+    soa.Reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        const double f = double(i);
+        aos.PushBack({f, f, f, 1.0, 1.0, 1.0, 1.0 + f / n, int64_t(i)});
+        soa.EmplaceBack(f, f, f, 1.0, 1.0, 1.0, 1.0 + f / n, int64_t(i));
+    }
+
+    if (reporter.Enabled("soa", "sum_mass")) {
+        const double aos_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                double total = 0;
+                for (const Particle& p : aos) {
+                    total += p.mass;
+                }
+                DoNotOptimize(total);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"soa", "sum_mass", "SimpleVector", "particle64", n, aos_ns,
+                         {{"bytes_per_row", double(sizeof(Particle))}}});
+        const double soa_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                double total = 0;
+                for (double mass : soa.Column<6>()) {
+                    total += mass;
+                }
+                DoNotOptimize(total);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"soa", "sum_mass", "SoaVector", "particle64", n, soa_ns, {{"bytes_per_row", 8.0}}});
+    }
+    if (reporter.Enabled("soa", "integrate")) {
+        const double aos_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                for (Particle& p : aos) {
+                    p.x += p.vx * 0.001;
+                }
+                DoNotOptimize(aos[0]);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"soa", "integrate", "SimpleVector", "particle64", n, aos_ns,
+                         {{"bytes_per_row", double(sizeof(Particle))}}});
+        const double soa_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SimpleSpan<double> x = soa.Column<0>();
+                ConstSimpleSpan<double> vx = soa.Column<3>();
+                for (size_t i = 0; i < x.GetSize(); ++i) {
+                    x[i] += vx[i] * 0.001;
+                }
+                DoNotOptimize(x[0]);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"soa", "integrate", "SoaVector", "particle64", n, soa_ns, {{"bytes_per_row", 16.0}}});
+        const double proxy_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                for (auto [x, y, z, vx, vy, vz, mass, id] : soa) {
+                    x += vx * 0.001;
+                }
+                DoNotOptimize(soa.Column<0>()[0]);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"soa", "integrate/proxy", "SoaVector", "particle64", n, proxy_ns, {{"bytes_per_row", 16.0}}});
+    }
+}
+
+// Горячий путь добавления в конец: сколько стоит PushBack, когда места хватает
+// и когда вектор растёт. Если доступны счётчики perf, сообщает ещё инструкции и такты
+// на одну операцию — они точнее времени показывают, во что обходится проверка вместимости
+void RunHotPathSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 12) : (size_t(1) << 16);
+    // Повторяет замер под счётчиками: iterations повторов run, метрики на одну операцию
+    auto count = [](auto run, size_t iterations) {
+        std::vector<std::pair<std::string, double>> counters;
+        PerfCounters perf;
+        if (perf.IsAvailable()) {
+            perf.Start();
+            const size_t ops = run(iterations);
+            const PerfCounters::Sample sample = perf.Stop();
+            counters.emplace_back("instructions_per_op", double(sample.instructions) / double(ops));
+            counters.emplace_back("cycles_per_op", double(sample.cycles) / double(ops));
+        }
+        return counters;
+    };
+
+    if (reporter.Enabled("hot_path", "push_back/reserved")) {
+        SimpleVector<int> v;
+        v.Reserve(n);
+        auto run = [&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                v.Clear();
+                for (size_t i = 0; i < n; ++i) {
+                    v.PushBack(int(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        };
+        reporter.Report({"hot_path", "push_back/reserved", "SimpleVector", "int", n, reporter.Measure(run), count(run, 64)});
+    }
+    if (reporter.Enabled("hot_path", "push_back/growing")) {
+        auto run = [&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SimpleVector<int> v;
+                for (size_t i = 0; i < n; ++i) {
+                    v.PushBack(int(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        };
+        reporter.Report({"hot_path", "push_back/growing", "SimpleVector", "int", n, reporter.Measure(run), count(run, 64)});
+    }
+    if (reporter.Enabled("hot_path", "emplace_back/reserved")) {
+        SimpleVector<std::pair<int64_t, double>> v;
+        v.Reserve(n);
+        auto run = [&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                v.Clear();
+                for (size_t i = 0; i < n; ++i) {
+                    v.EmplaceBack(int64_t(i), double(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        };
+        reporter.Report({"hot_path", "emplace_back/reserved", "SimpleVector", "pair16", n, reporter.Measure(run), count(run, 64)});
+    }
+    if (reporter.Enabled("hot_path", "insert_end/reserved")) {
+        SimpleVector<int> v;
+        v.Reserve(n);
+        auto run = [&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                v.Clear();
+                for (size_t i = 0; i < n; ++i) {
+                    v.Insert(v.end(), int(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        };
+        reporter.Report({"hot_path", "insert_end/reserved", "SimpleVector", "int", n, reporter.Measure(run), count(run, 64)});
+    }
+}
+
+// Сравнивает DeVector с SimpleVector в роли очереди: SimpleVector удаляет первый элемент
+// сдвигом всего массива, DeVector — сдвигом начала кольца
+void RunDeVectorSuite(BenchmarkReporter& reporter) {
+    const size_t steps = reporter.GetOptions().quick ? 4096 : 65536;
+    for (size_t items : {size_t(16), size_t(1024), size_t(16384)}) {
+        // Очередь постоянной длины items: на каждом шаге один элемент входит и один выходит
+        if (reporter.Enabled("devector", "queue")) {
+            const double simple_ns = reporter.Measure([&](size_t iterations) {
+                SimpleVector<int> queue(items);
+                for (size_t r = 0; r < iterations; ++r) {
+                    for (size_t i = 0; i < steps; ++i) {
+                        queue.PushBack(int(i));
+                        queue.Erase(queue.begin());
+                    }
+                    DoNotOptimize(queue);
+                }
+                return iterations * steps;
+            });
+            reporter.Report({"devector", "queue", "SimpleVector", "int", items, simple_ns, {}});
+
+            const double de_ns = reporter.Measure([&](size_t iterations) {
+                DeVector<int> queue(items);
+                for (size_t r = 0; r < iterations; ++r) {
+                    for (size_t i = 0; i < steps; ++i) {
+                        queue.PushBack(int(i));
+                        queue.PopFront();
+                    }
+                    DoNotOptimize(queue);
+                }
+                return iterations * steps;
+            });
+            reporter.Report({"devector", "queue", "DeVector", "int", items, de_ns, {}});
+        }
+
+        // Скользящее окно из items последних значений, сумма окна пересчитывается каждые 64 шага.
+        // DeVector суммирует окно либо по двум кускам кольца, либо после Linearize
+        if (reporter.Enabled("devector", "sliding_window")) {
+            const double simple_ns = reporter.Measure([&](size_t iterations) {
+                SimpleVector<int> window(items);
+                int64_t total = 0;
+                for (size_t r = 0; r < iterations; ++r) {
+                    for (size_t i = 0; i < steps; ++i) {
+                        window.PushBack(int(i));
+                        window.Erase(window.begin());
+                        if (i % 64 == 0) {
+                            total += Sum(window);
+                        }
+                    }
+                }
+                DoNotOptimize(total);
+                return iterations * steps;
+            });
+            reporter.Report({"devector", "sliding_window", "SimpleVector", "int", items, simple_ns, {}});
+
+            const double segments_ns = reporter.Measure([&](size_t iterations) {
+                DeVector<int> window(items);
+                int64_t total = 0;
+                for (size_t r = 0; r < iterations; ++r) {
+                    for (size_t i = 0; i < steps; ++i) {
+                        window.PushBack(int(i));
+                        window.PopFront();
+                        if (i % 64 == 0) {
+                            const auto [first, second] = window.GetSegments();
+                            total += Sum(first) + Sum(second);
+                        }
+                    }
+                }
+                DoNotOptimize(total);
+                return iterations * steps;
+            });
+            reporter.Report({"devector", "sliding_window", "DeVector/segments", "int", items, segments_ns, {}});
+
+            const double linearize_ns = reporter.Measure([&](size_t iterations) {
+                DeVector<int> window(items);
+                int64_t total = 0;
+                for (size_t r = 0; r < iterations; ++r) {
+                    for (size_t i = 0; i < steps; ++i) {
+                        window.PushBack(int(i));
+                        window.PopFront();
+                        if (i % 64 == 0) {
+                            total += Sum(window.Linearize());
+                        }
+                    }
+                }
+                DoNotOptimize(total);
+                return iterations * steps;
+            });
+            reporter.Report({"devector", "sliding_window", "DeVector/Linearize", "int", items, linearize_ns, {}});
+        }
+    }
+
+    // Добавление в начало: Insert(begin()) у SimpleVector против PushFront
+    if (reporter.Enabled("devector", "push_front")) {
+        const size_t n = reporter.GetOptions().quick ? 2048 : 16384;
+        const double simple_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                SimpleVector<int> v;
+                for (size_t i = 0; i < n; ++i) {
+                    v.Insert(v.begin(), int(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"devector", "push_front", "SimpleVector", "int", n, simple_ns, {}});
+
+        const double de_ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                DeVector<int> v;
+                for (size_t i = 0; i < n; ++i) {
+                    v.PushFront(int(i));
+                }
+                DoNotOptimize(v);
+            }
+            return iterations * n;
+        });
+        reporter.Report({"devector", "push_front", "DeVector", "int", n, de_ns, {}});
+    }
+}
+
+// Сравнивает задержку поиска в FlatMap с обоими индексами, std::map и двоичным поиском
+// по отсортированному SimpleVector<pair>. Каждый запрос зависит от результата предыдущего,
+// поэтому замер показывает задержку, а не пропускную способность. Половина запросов промахивается
+void RunFlatMapSuite(BenchmarkReporter& reporter) {
+    const bool quick = reporter.GetOptions().quick;
+    const size_t kQueries = size_t(1) << 16;
+    for (size_t n : quick ? std::vector<size_t>{size_t(1) << 10, size_t(1) << 14}
+                          : std::vector<size_t>{size_t(1) << 10, size_t(1) << 16, size_t(1) << 22}) {
+        if (!reporter.Enabled("flat_map", "lookup")) {
+            break;
+        }
+        // Чётные ключи попадают, нечётные промахиваются
+        SimpleVector<pair<int, int>> items(Reserve(n));
+        for (size_t i = 0; i < n; ++i) {
+            items.PushBack({int((i * 2654435761u) % (1u << 30)) * 2, int(i)});
+        }
+        SimpleVector<int> queries(Reserve(kQueries));
+        for (size_t i = 0; i < kQueries; ++i) {
+            const size_t pick = (i * 40503u + 17) % n;
+            queries.PushBack(items[pick].first + int(i % 2));
+        }
+
+        // Измеряет цепочку запросов: следующий запрос выбирается по результату текущего
+        auto measure = [&](const char* container, auto find) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                int64_t acc = 0;
+                for (size_t r = 0; r < iterations; ++r) {
+                    for (size_t q = 0; q < kQueries; ++q) {
+                        acc += find(queries[(q + size_t(acc & 1)) & (kQueries - 1)]);
+                    }
+                }
+                DoNotOptimize(acc);
+                return iterations * kQueries;
+            });
+            reporter.Report({"flat_map", "lookup", container, "int", n, ns, {}});
+        };
+
+        {
+            const map<int, int> tree(items.begin(), items.end());
+            measure("std::map", [&](int key) {
+                const auto it = tree.find(key);
+                return it == tree.end() ? 0 : it->second;
+            });
+        }
+        {
+            SimpleVector<pair<int, int>> sorted(items);
+            sort(sorted.begin(), sorted.end());
+            measure("SimpleVector<pair>/lower_bound", [&](int key) {
+                const auto it = lower_bound(sorted.begin(), sorted.end(), key, [](const pair<int, int>& item, int k) {
+                    return item.first < k;
+                });
+                return it != sorted.end() && it->first == key ? it->second : 0;
+            });
+        }
+        {
+            const FlatMap<int, int> flat(items);
+            measure("FlatMap<BinarySearchIndex>", [&](int key) {
+                const auto it = flat.Find(key);
+                return it == flat.end() ? 0 : (*it).second;
+            });
+        }
+        {
+            const FlatMap<int, int, less<int>, BTreeIndex> flat(items);
+            measure("FlatMap<BTreeIndex>", [&](int key) {
+                const auto it = flat.Find(key);
+                return it == flat.end() ? 0 : (*it).second;
+            });
+        }
+    }
+
+    // Построение таблицы: одна загрузка, пакетные вставки или вставки по одной паре
+    if (reporter.Enabled("flat_map", "build")) {
+        const size_t n = size_t(1) << 12;
+        SimpleVector<pair<int, int>> items(Reserve(n));
+        for (size_t i = 0; i < n; ++i) {
+            items.PushBack({int((i * 2654435761u) % (1u << 30)), int(i)});
+        }
+        auto report = [&](const char* container, auto build) {
+            const double ns = reporter.Measure([&](size_t iterations) {
+                for (size_t r = 0; r < iterations; ++r) {
+                    build();
+                }
+                return iterations * n;
+            });
+            reporter.Report({"flat_map", "build", container, "int", n, ns, {}});
+        };
+        report("FlatMap/BulkLoad", [&] {
+            DoNotOptimize(FlatMap<int, int, less<int>, BTreeIndex>(items));
+        });
+        report("FlatMap/InsertBatch x16", [&] {
+            FlatMap<int, int, less<int>, BTreeIndex> flat;
+            for (size_t first = 0; first < n; first += n / 16) {
+                SimpleVector<pair<int, int>> batch;
+                batch.Insert(batch.cend(), items.begin() + first, items.begin() + first + n / 16);
+                flat.InsertBatch(move(batch));
+            }
+            DoNotOptimize(flat);
+        });
+        report("FlatMap/Insert", [&] {
+            FlatMap<int, int> flat;
+            for (const auto& [key, value] : items) {
+                flat.Insert(key, value);
+            }
+            DoNotOptimize(flat);
+        });
+        report("std::map/insert", [&] {
+            DoNotOptimize(map<int, int>(items.begin(), items.end()));
+        });
+    }
+}
+
+// BitVector против SimpleVector<bool>, который тратит на флаг байт: пословные and и подсчёт
+// единиц на маске, перебор единиц разреженной маски, а также Rank и Select по BitRankIndex.
+// Время — на бит маски (на запрос для rank и select), bytes_per_bit — занятая память
+void RunBitVectorSuite(BenchmarkReporter& reporter) {
+    const size_t n = reporter.GetOptions().quick ? (size_t(1) << 16) : (size_t(1) << 26);
+    SimpleVector<bool> flags_a(n);
+    SimpleVector<bool> flags_b(n);
+    SimpleVector<bool> sparse_flags(n);
+    BitVector bits_a(n);
+    BitVector bits_b(n);
+    BitVector sparse_bits(n);
+    uint64_t state = 1;
+    for (size_t i = 0; i < n; ++i) {
+        state = state * 6364136223846793005u + 1442695040888963407u;
+        flags_a[i] = bits_a[i] = (state >> 63) != 0;
+        flags_b[i] = bits_b[i] = ((state >> 62) & 1) != 0;
+        // Каждый 64-й бит в среднем
+        sparse_flags[i] = sparse_bits[i] = (state >> 58) == 0;
+    }
+
+    auto measure = [&](const char* name, const char* container, size_t ops, double bytes, auto run) {
+        if (!reporter.Enabled("bit_vector", name)) {
+            return;
+        }
+        const double ns = reporter.Measure([&](size_t iterations) {
+            for (size_t r = 0; r < iterations; ++r) {
+                DoNotOptimize(run());
+            }
+            return iterations * ops;
+        });
+        reporter.Report({"bit_vector", name, container, "bool", n, ns, {{"bytes_per_bit", bytes / n}}});
+    };
+    const double flag_bytes = double(flags_a.GetCapacity());
+    const double bit_bytes = double(bits_a.GetCapacity() / 8);
+
+    measure("and", "SimpleVector", n, flag_bytes, [&] {
+        for (size_t i = 0; i < n; ++i) {
+            flags_a[i] = flags_a[i] & flags_b[i];
+        }
+        return flags_a[0];
+    });
+    measure("and", "BitVector", n, bit_bytes, [&] {
+        bits_a &= bits_b;
+        return bits_a[0];
+    });
+
+    measure("count", "SimpleVector", n, flag_bytes, [&] {
+        return count(flags_b.begin(), flags_b.end(), true);
+    });
+    const simd::SimdLevel detected = simd::DetectSimdLevel();
+    const pair<simd::SimdLevel, const char*> levels[] = {
+        {simd::SimdLevel::kScalar, "BitVector/scalar"}, {simd::SimdLevel::kSse2, "BitVector/sse2"},
+        {simd::SimdLevel::kAvx2, "BitVector/avx2"}};
+    for (const auto& [level, container] : levels) {
+        if (level > detected) {
+            continue;
+        }
+        simd::SetSimdLevel(level);
+        measure("count", container, n, bit_bytes, [&] { return bits_b.Count(); });
+    }
+    simd::SetSimdLevel(detected);
+
+    measure("find_next", "SimpleVector", n, flag_bytes, [&] {
+        size_t acc = 0;
+        for (auto it = find(sparse_flags.begin(), sparse_flags.end(), true); it != sparse_flags.end();
+             it = find(it + 1, sparse_flags.end(), true)) {
+            acc += size_t(it - sparse_flags.begin());
+        }
+        return acc;
+    });
+    measure("find_next", "BitVector", n, bit_bytes, [&] {
+        size_t acc = 0;
+        for (size_t pos = sparse_bits.FindFirst(); pos < n; pos = sparse_bits.FindNext(pos)) {
+            acc += pos;
+        }
+        return acc;
+    });
+
+    // Запросы к случайным позициям: индекс хранит счётчик единиц на каждые 512 битов
+    const BitRankIndex index(bits_b);
+    const size_t ones = bits_b.Count();
+    const size_t kQueries = 1024;
+    const double index_bytes = bit_bytes + double(n / 512 + 1) * sizeof(size_t);
+    measure("rank", "BitRankIndex", kQueries, index_bytes, [&] {
+        size_t acc = 0;
+        for (size_t q = 0; q < kQueries; ++q) {
+            acc += index.Rank(bits_b, (q * 2654435761u + acc) % n);
+        }
+        return acc;
+    });
+    measure("select", "BitRankIndex", kQueries, index_bytes, [&] {
+        size_t acc = 0;
+        for (size_t q = 0; q < kQueries; ++q) {
+            acc += index.Select(bits_b, (q * 2654435761u + acc) % ones);
+        }
+        return acc;
+    });
+}
+
+}  // namespace
+
+// Аргументы:
+//     --filter=<подстрока>  запускать только замеры, чьё имя suite/name содержит подстроку
+//     --quick               уменьшенные размеры и время замера
+//     --json=<файл>         писать результаты JSON Lines в файл (по умолчанию в stdout,
+//                           а текстовый отчёт — в stderr)
+int main(int argc, char** argv) {
+    BenchmarkOptions options;
+    string json_path;
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (arg.substr(0, 9) == "--filter="sv) {
+            options.filter = string(arg.substr(9));
+        }
+        else if (arg == "--quick"sv) {
+            options.quick = true;
+            options.min_time = chrono::milliseconds(5);
+            options.repetitions = 1;
+        }
+        else if (arg.substr(0, 7) == "--json="sv) {
+            json_path = string(arg.substr(7));
+        }
+        else {
+            cerr << "Unknown argument: "s << arg << endl;
+            return 1;
+        }
+    }
+
+    ofstream json_file;
+    if (!json_path.empty()) {
+        json_file.open(json_path);
+        if (!json_file) {
+            cerr << "Cannot open "s << json_path << endl;
+            return 1;
+        }
+    }
+    BenchmarkReporter reporter(json_path.empty() ? cout : json_file, json_path.empty() ? cerr : cout, options);
+
+    RunContainerSuites<int>(reporter);
+    RunContainerSuites<string>(reporter);
+    RunContainerSuites<Pod256>(reporter);
+    RunContainerSuites<MoveOnly>(reporter);
+    RunArenaSuite(reporter);
+    RunSmallVectorSuite(reporter);
+    RunEraseIfSuite(reporter);
+    RunParallelSuite(reporter);
+    RunFirstTouchSuite(reporter);
+    RunSimdSuite<uint8_t>(reporter);
+    RunSimdSuite<int>(reporter);
+    RunSimdSuite<int64_t>(reporter);
+    RunConcurrentSuite(reporter);
+    RunCowSuite(reporter);
+    RunMappedSuite(reporter);
+    RunSerializationSuite(reporter);
+    RunSpanSuite(reporter);
+    RunSoaSuite(reporter);
+    RunHotPathSuite(reporter);
+    RunDeVectorSuite(reporter);
+    RunFlatMapSuite(reporter);
+    RunBitVectorSuite(reporter);
+    return 0;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Не даёт компилятору выбросить вычисление value как неиспользуемое
+template <typename Type>
+inline void DoNotOptimize(const Type& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Аппаратные счётчики текущего потока через perf_event_open: выполненные инструкции
+// и такты, только в пользовательском режиме. Счётчики открываются одной группой и потому
+// запускаются и останавливаются одновременно. Если они недоступны (не Linux, виртуальная
+// машина без PMU, запрет через perf_event_paranoid), IsAvailable() возвращает false,
+// а замеры обходятся без них
+class PerfCounters {
+public:
+    struct Sample {
+        uint64_t instructions = 0;
+        uint64_t cycles = 0;
+    };
+
+    PerfCounters() {
+#if defined(__linux__)
+        leader_ = Open(PERF_COUNT_HW_INSTRUCTIONS, -1);
+        if (leader_ >= 0) {
+            cycles_ = Open(PERF_COUNT_HW_CPU_CYCLES, leader_);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : {cycles_, leader_}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+#endif
+    }
+
+    bool IsAvailable() const noexcept {
+        return leader_ >= 0 && cycles_ >= 0;
+    }
+
+    void Start() noexcept {
+#if defined(__linux__)
+        ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    Sample Stop() noexcept {
+        Sample sample;
+#if defined(__linux__)
+        ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        // Формат PERF_FORMAT_GROUP: число счётчиков, затем их значения в порядке открытия
+        uint64_t values[3] = {};
+        if (::read(leader_, values, sizeof(values)) == static_cast<ssize_t>(sizeof(values)) && values[0] == 2) {
+            sample.instructions = values[1];
+            sample.cycles = values[2];
+        }
+#endif
+        return sample;
+    }
+
+private:
+#if defined(__linux__)
+    static int Open(uint64_t config, int group) noexcept {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config;
+        attr.disabled = group < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, group, 0));
+    }
+#endif
+
+    int leader_ = -1;
+    int cycles_ = -1;
+};
+
+// Результат одного замера. Пишется в отчёт одной строкой JSON,
+// чтобы результаты разных запусков можно было сравнивать автоматически
+struct BenchmarkResult {
+    std::string suite;
+    std::string name;
+    std::string container;
+    std::string element;
+    size_t size = 0;
+    double ns_per_op = 0;
+    // Дополнительные метрики, например число выделений памяти или потоков
+    std::vector<std::pair<std::string, double>> counters;
+};
+
+struct BenchmarkOptions {
+    // Подстрока, которой должно соответствовать имя набора или замера
+    std::string filter;
+    // Уменьшенные размеры и время замера для быстрой проверки
+    bool quick = false;
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds(50);
+    int repetitions = 3;
+};
+
+class BenchmarkReporter {
+public:
+    BenchmarkReporter(std::ostream& json_out, std::ostream& text_out, BenchmarkOptions options)
+        : json_out_(json_out),
+        text_out_(text_out),
+        options_(std::move(options)) {
+    }
+
+    const BenchmarkOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    // Сообщает, нужно ли запускать замер с указанным набором и именем
+    bool Enabled(std::string_view suite, std::string_view name = {}) const {
+        if (options_.filter.empty()) {
+            return true;
+        }
+        std::string full(suite);
+        full += '/';
+        full += name;
+        return full.find(options_.filter) != std::string::npos;
+    }
+
+    // Подбирает число повторов run так, чтобы замер длился не меньше min_time,
+    // и возвращает лучшее из repetitions время одной операции в наносекундах.
+    // run(iterations) должен выполнить iterations повторов и вернуть число выполненных операций
+    template <typename Run>
+    double Measure(Run run) const {
+        using Clock = std::chrono::steady_clock;
+        size_t iterations = 1;
+        double best = std::numeric_limits<double>::max();
+        for (int rep = 0; rep < options_.repetitions; ++rep) {
+            while (true) {
+                const auto start = Clock::now();
+                const size_t ops = run(iterations);
+                const auto elapsed = Clock::now() - start;
+                if (elapsed >= options_.min_time || iterations >= (size_t(1) << 30)) {
+                    best = std::min(best, std::chrono::duration<double, std::nano>(elapsed).count() / std::max<size_t>(ops, 1));
+                    break;
+                }
+                iterations *= 2;
+            }
+        }
+        return best;
+    }
+
+    void Report(const BenchmarkResult& result) {
+        json_out_ << "{\"suite\":\"" << result.suite << "\",\"name\":\"" << result.name
+                  << "\",\"container\":\"" << result.container << "\",\"element\":\"" << result.element
+                  << "\",\"size\":" << result.size << ",\"ns_per_op\":" << result.ns_per_op;
+        for (const auto& [key, value] : result.counters) {
+            json_out_ << ",\"" << key << "\":" << value;
+        }
+        json_out_ << "}\n";
+        json_out_.flush();
+
+        text_out_ << result.suite << '/' << result.name << ' ' << result.container << '<' << result.element << "> n="
+                  << result.size << ": " << result.ns_per_op << " ns/op";
+        for (const auto& [key, value] : result.counters) {
+            text_out_ << ' ' << key << '=' << value;
+        }
+        text_out_ << std::endl;
+    }
+
+private:
+    std::ostream& json_out_;
+    std::ostream& text_out_;
+    BenchmarkOptions options_;
+};
@@ -0,0 +1,633 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simd.h"
+#include "simple_span.h"
+#include "simple_vector.h"
+
+// Вектор битов, упакованных по 64 в слово: в 8 раз плотнее SimpleVector<bool>.
+// Интерфейс повторяет SimpleVector (PushBack, Resize, operator[]), но operator[]
+// возвращает прокси-ссылку на бит. Логические операции, подсчёт единиц и поиск
+// обрабатывают по слову, а не по биту за шаг. Биты последнего слова за пределами
+// размера всегда нулевые, поэтому слова можно сравнивать и считать целиком
+class BitVector {
+    template <bool kConst>
+    class BasicIterator;
+
+public:
+    using Word = uint64_t;
+    static constexpr size_t kWordBits = 64;
+
+    // Прокси-ссылка на бит вектора
+    class Reference {
+    public:
+        Reference& operator=(bool value) noexcept {
+            if (value) {
+                *word_ |= mask_;
+            }
+            else {
+                *word_ &= ~mask_;
+            }
+            return *this;
+        }
+
+        Reference& operator=(const Reference& other) noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        operator bool() const noexcept {
+            return (*word_ & mask_) != 0;
+        }
+
+        bool operator~() const noexcept {
+            return !static_cast<bool>(*this);
+        }
+
+        // Инвертирует бит
+        Reference& Flip() noexcept {
+            *word_ ^= mask_;
+            return *this;
+        }
+
+    private:
+        friend class BitVector;
+
+        Reference(Word* word, Word mask) noexcept
+            : word_(word),
+            mask_(mask) {
+        }
+
+        Word* word_;
+        Word mask_;
+    };
+
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    BitVector() noexcept = default;
+
+    // Создаёт вектор из size битов, равных value
+    explicit BitVector(size_t size, bool value = false) {
+        Resize(size, value);
+    }
+
+    BitVector(std::initializer_list<bool> init) {
+        Reserve(init.size());
+        for (const bool bit : init) {
+            PushBack(bit);
+        }
+    }
+
+    BitVector(const BitVector& other) = default;
+
+    BitVector(BitVector&& other) noexcept {
+        swap(other);
+    }
+
+    BitVector& operator=(const BitVector& rhs) {
+        if (this != &rhs) {
+            BitVector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    BitVector& operator=(BitVector&& rhs) noexcept {
+        if (this != &rhs) {
+            BitVector tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Возвращает количество битов
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает количество битов, которое поместится без перевыделения памяти
+    size_t GetCapacity() const noexcept {
+        return words_.GetCapacity() * kWordBits;
+    }
+
+    // Сообщает, пустой ли вектор
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Слова с битами: бит i лежит в слове i / 64 на позиции i % 64
+    ConstSimpleSpan<Word> GetWords() const noexcept {
+        return ConstSimpleSpan<Word>(words_.GetData(), words_.GetSize());
+    }
+
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Reference(&words_[index / kWordBits], BitMask(index));
+    }
+
+    bool operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return (words_[index / kWordBits] & BitMask(index)) != 0;
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= size_) { throw std::out_of_range("index >= size"); }
+        return (*this)[index];
+    }
+
+    bool At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("index >= size"); }
+        return (*this)[index];
+    }
+
+    // Устанавливает бит index в value
+    void Set(size_t index, bool value = true) noexcept {
+        (*this)[index] = value;
+    }
+
+    // Обнуляет бит index
+    void Reset(size_t index) noexcept {
+        (*this)[index] = false;
+    }
+
+    // Инвертирует бит index
+    void Flip(size_t index) noexcept {
+        (*this)[index].Flip();
+    }
+
+    // Устанавливает все биты
+    void Set() noexcept {
+        std::fill(words_.begin(), words_.end(), ~Word(0));
+        ClearTail();
+    }
+
+    // Обнуляет все биты
+    void Reset() noexcept {
+        std::fill(words_.begin(), words_.end(), Word(0));
+    }
+
+    // Инвертирует все биты
+    void Flip() noexcept {
+        for (Word& word : words_) {
+            word = ~word;
+        }
+        ClearTail();
+    }
+
+    // Обнуляет размер, не освобождая память
+    void Clear() noexcept {
+        words_.Clear();
+        size_ = 0;
+    }
+
+    // Добавляет бит в конец вектора
+    void PushBack(bool value) {
+        const size_t offset = size_ % kWordBits;
+        if (offset == 0) {
+            words_.PushBack(Word(value));
+        }
+        else {
+            words_[size_ / kWordBits] |= Word(value) << offset;
+        }
+        ++size_;
+    }
+
+    // Удаляет последний бит. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        if (size_ % kWordBits == 0) {
+            words_.PopBack();
+        }
+        else {
+            words_[size_ / kWordBits] &= ~BitMask(size_);
+        }
+    }
+
+    // Изменяет размер. Новые биты равны value
+    void Resize(size_t new_size, bool value = false) {
+        const size_t old_size = size_;
+        // Новые слова нулевые, как и биты последнего слова за пределами размера
+        words_.Resize(WordCount(new_size));
+        size_ = new_size;
+        if (new_size < old_size) {
+            ClearTail();
+        }
+        else if (value) {
+            SetRange(old_size, new_size);
+        }
+    }
+
+    // Выделяет память под capacity битов
+    void Reserve(size_t capacity) {
+        words_.Reserve(WordCount(capacity));
+    }
+
+    // Освобождает память сверх текущего размера
+    void ShrinkToFit() {
+        words_.ShrinkToFit();
+    }
+
+    void swap(BitVector& other) noexcept {
+        words_.swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    // Пословные логические операции. Размеры векторов должны совпадать
+    BitVector& operator&=(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        Word* words = words_.GetData();
+        const Word* other = rhs.words_.GetData();
+        for (size_t i = 0; i < words_.GetSize(); ++i) {
+            words[i] &= other[i];
+        }
+        return *this;
+    }
+
+    BitVector& operator|=(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        Word* words = words_.GetData();
+        const Word* other = rhs.words_.GetData();
+        for (size_t i = 0; i < words_.GetSize(); ++i) {
+            words[i] |= other[i];
+        }
+        return *this;
+    }
+
+    BitVector& operator^=(const BitVector& rhs) noexcept {
+        assert(size_ == rhs.size_);
+        Word* words = words_.GetData();
+        const Word* other = rhs.words_.GetData();
+        for (size_t i = 0; i < words_.GetSize(); ++i) {
+            words[i] ^= other[i];
+        }
+        return *this;
+    }
+
+    BitVector operator~() const {
+        BitVector result(*this);
+        result.Flip();
+        return result;
+    }
+
+    // Возвращает количество единичных битов
+    size_t Count() const noexcept {
+        return simd::PopCount(words_.GetData(), words_.GetSize());
+    }
+
+    // Сообщают, есть ли единичные биты, все ли биты единичные и нет ли единичных
+    bool Any() const noexcept {
+        return std::any_of(words_.begin(), words_.end(), [](Word word) { return word != 0; });
+    }
+
+    bool All() const noexcept {
+        return Count() == size_;
+    }
+
+    bool None() const noexcept {
+        return !Any();
+    }
+
+    // Возвращает позицию первого единичного бита или GetSize(), если его нет
+    size_t FindFirst() const noexcept {
+        return FindFrom(0);
+    }
+
+    // Возвращает позицию первого единичного бита после pos или GetSize(), если его нет
+    size_t FindNext(size_t pos) const noexcept {
+        return pos + 1 < size_ ? FindFrom(pos + 1) : size_;
+    }
+
+    // Возвращает количество единичных битов среди первых pos, pos <= GetSize().
+    // Читает pos / 64 слов; для многих запросов к неизменному вектору есть BitRankIndex
+    size_t Rank(size_t pos) const noexcept {
+        assert(pos <= size_);
+        const size_t full_words = pos / kWordBits;
+        size_t result = simd::PopCount(words_.GetData(), full_words);
+        if (pos % kWordBits != 0) {
+            result += static_cast<size_t>(std::popcount(words_[full_words] & (BitMask(pos) - 1)));
+        }
+        return result;
+    }
+
+    // Возвращает позицию единичного бита с номером k (с нуля) или GetSize(),
+    // если единичных битов не больше k
+    size_t Select(size_t k) const noexcept {
+        for (size_t i = 0; i < words_.GetSize(); ++i) {
+            const size_t count = static_cast<size_t>(std::popcount(words_[i]));
+            if (k < count) {
+                return i * kWordBits + SelectInWord(words_[i], k);
+            }
+            k -= count;
+        }
+        return size_;
+    }
+
+    // Возвращает позицию единичного бита с номером k в слове, где их больше k.
+    // Половины слова, в которых нужного бита нет, отбрасываются по их количеству единиц
+    static size_t SelectInWord(Word word, size_t k) noexcept {
+        assert(k < static_cast<size_t>(std::popcount(word)));
+        size_t base = 0;
+        for (size_t width = kWordBits / 2; width >= 8; width /= 2) {
+            const size_t low = static_cast<size_t>(std::popcount(word & ((Word(1) << width) - 1)));
+            if (k >= low) {
+                k -= low;
+                word >>= width;
+                base += width;
+            }
+        }
+        for (; k > 0; --k) {
+            word &= word - 1;
+        }
+        return base + static_cast<size_t>(std::countr_zero(word));
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    friend bool operator==(const BitVector& lhs, const BitVector& rhs) noexcept {
+        return lhs.size_ == rhs.size_ && lhs.GetWords() == rhs.GetWords();
+    }
+
+    friend bool operator!=(const BitVector& lhs, const BitVector& rhs) noexcept {
+        return !(lhs == rhs);
+    }
+
+private:
+    // Итератор хранит вектор и номер бита, поэтому его разыменование даёт
+    // прокси-ссылку (или значение бита для константного итератора)
+    template <bool kConst>
+    class BasicIterator {
+        using OwnerPtr = std::conditional_t<kConst, const BitVector*, BitVector*>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, bool, Reference>;
+
+        BasicIterator() noexcept = default;
+
+        // Изменяемый итератор преобразуется в константный
+        template <bool kOtherConst>
+            requires(kConst && !kOtherConst)
+        BasicIterator(const BasicIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_),
+            index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        // Номер бита в векторе
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend std::strong_ordering operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        friend class BitVector;
+        friend class BasicIterator<true>;
+
+        BasicIterator(OwnerPtr owner, size_t index) noexcept
+            : owner_(owner),
+            index_(index) {
+        }
+
+        OwnerPtr owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    static constexpr size_t WordCount(size_t bits) noexcept {
+        return (bits + kWordBits - 1) / kWordBits;
+    }
+
+    static constexpr Word BitMask(size_t index) noexcept {
+        return Word(1) << (index % kWordBits);
+    }
+
+    // Обнуляет биты последнего слова за пределами размера
+    void ClearTail() noexcept {
+        if (size_ % kWordBits != 0) {
+            words_[size_ / kWordBits] &= BitMask(size_) - 1;
+        }
+    }
+
+    // Устанавливает биты [first, last)
+    void SetRange(size_t first, size_t last) noexcept {
+        if (first == last) {
+            return;
+        }
+        const size_t first_word = first / kWordBits;
+        const size_t last_word = (last - 1) / kWordBits;
+        const Word first_mask = ~Word(0) << (first % kWordBits);
+        const Word last_mask = ~Word(0) >> (kWordBits - 1 - (last - 1) % kWordBits);
+        if (first_word == last_word) {
+            words_[first_word] |= first_mask & last_mask;
+            return;
+        }
+        words_[first_word] |= first_mask;
+        std::fill(words_.begin() + first_word + 1, words_.begin() + last_word, ~Word(0));
+        words_[last_word] |= last_mask;
+    }
+
+    // Первый единичный бит, начиная с позиции first
+    size_t FindFrom(size_t first) const noexcept {
+        if (first >= size_) {
+            return size_;
+        }
+        size_t i = first / kWordBits;
+        Word word = words_[i] & (~Word(0) << (first % kWordBits));
+        while (word == 0) {
+            if (++i == words_.GetSize()) {
+                return size_;
+            }
+            word = words_[i];
+        }
+        return i * kWordBits + static_cast<size_t>(std::countr_zero(word));
+    }
+
+    SimpleVector<Word> words_;
+    size_t size_ = 0;
+};
+
+inline BitVector operator&(BitVector lhs, const BitVector& rhs) noexcept {
+    lhs &= rhs;
+    return lhs;
+}
+
+inline BitVector operator|(BitVector lhs, const BitVector& rhs) noexcept {
+    lhs |= rhs;
+    return lhs;
+}
+
+inline BitVector operator^(BitVector lhs, const BitVector& rhs) noexcept {
+    lhs ^= rhs;
+    return lhs;
+}
+
+inline void swap(BitVector& lhs, BitVector& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+// Индекс для Rank и Select за O(1) и O(log n) по вектору, который больше не меняется.
+// Для каждого блока из 8 слов (512 битов, одна кэш-линия) хранит количество единиц
+// до его начала: Rank складывает его с единицами не более чем 8 слов, а Select
+// двоичным поиском находит блок и просматривает его слова. Занимает 1/8 объёма вектора.
+// Как и индексы FlatMap, получает сам вектор аргументом; после изменения вектора
+// индекс нужно построить заново
+class BitRankIndex {
+public:
+    BitRankIndex() noexcept = default;
+
+    explicit BitRankIndex(const BitVector& bits) {
+        Build(bits);
+    }
+
+    void Build(const BitVector& bits) {
+        const ConstSimpleSpan<BitVector::Word> words = bits.GetWords();
+        blocks_.Clear();
+        blocks_.Reserve(words.GetSize() / kBlockWords + 2);
+        size_t ones = 0;
+        for (size_t first = 0; first < words.GetSize(); first += kBlockWords) {
+            blocks_.PushBack(ones);
+            ones += simd::PopCount(words.begin() + first, std::min(kBlockWords, words.GetSize() - first));
+        }
+        // Последний элемент — общее количество единиц
+        blocks_.PushBack(ones);
+    }
+
+    // Количество единичных битов среди первых pos битов bits, pos <= bits.GetSize()
+    size_t Rank(const BitVector& bits, size_t pos) const noexcept {
+        assert(pos <= bits.GetSize() && !blocks_.IsEmpty());
+        const ConstSimpleSpan<BitVector::Word> words = bits.GetWords();
+        const size_t word = pos / BitVector::kWordBits;
+        size_t result = blocks_[word / kBlockWords];
+        for (size_t i = word - word % kBlockWords; i < word; ++i) {
+            result += static_cast<size_t>(std::popcount(words[i]));
+        }
+        if (pos % BitVector::kWordBits != 0) {
+            const BitVector::Word below = (BitVector::Word(1) << (pos % BitVector::kWordBits)) - 1;
+            result += static_cast<size_t>(std::popcount(words[word] & below));
+        }
+        return result;
+    }
+
+    // Позиция единичного бита bits с номером k или bits.GetSize(), если их не больше k
+    size_t Select(const BitVector& bits, size_t k) const noexcept {
+        assert(!blocks_.IsEmpty());
+        if (k >= blocks_[blocks_.GetSize() - 1]) {
+            return bits.GetSize();
+        }
+        // Последний блок, до начала которого единиц не больше k
+        const size_t block = static_cast<size_t>(std::upper_bound(blocks_.begin(), blocks_.end(), k) - blocks_.begin()) - 1;
+        k -= blocks_[block];
+        const ConstSimpleSpan<BitVector::Word> words = bits.GetWords();
+        for (size_t i = block * kBlockWords;; ++i) {
+            const size_t count = static_cast<size_t>(std::popcount(words[i]));
+            if (k < count) {
+                return i * BitVector::kWordBits + BitVector::SelectInWord(words[i], k);
+            }
+            k -= count;
+        }
+    }
+
+private:
+    static constexpr size_t kBlockWords = 8;
+
+    SimpleVector<size_t> blocks_;
+};
@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+// Проверяемый режим, который включается макросом SIMPLE_VECTOR_CHECKED до подключения
+// заголовков библиотеки (или опцией CMake SIMPLE_VECTOR_CHECKED).
+// В этом режиме итераторы SimpleVector — не сырые указатели, а CheckedIterator,
+// помнящие поколение вектора: обращение через итератор, пережившее перевыделение памяти,
+// Insert или Erase, считается ошибкой. ArrayPtr учитывает живые блоки памяти и байты
+// по типам элементов, а при завершении программы печатает в stderr неосвобождённые.
+// Без макроса ни проверки, ни учёт не компилируются и ничего не стоят
+namespace checked {
+
+// Обработчик нарушения. Может бросить исключение; если он вернёт управление,
+// процесс завершается через std::abort
+using FailureHandler = void (*)(const char* message);
+
+inline void DefaultFailureHandler(const char* message) {
+    std::fprintf(stderr, "SimpleVector check failed: %s\n", message);
+}
+
+inline std::atomic<FailureHandler>& FailureHandlerSlot() noexcept {
+    static std::atomic<FailureHandler> handler{&DefaultFailureHandler};
+    return handler;
+}
+
+// Устанавливает обработчик нарушений и возвращает прежний
+inline FailureHandler SetFailureHandler(FailureHandler handler) noexcept {
+    return FailureHandlerSlot().exchange(handler != nullptr ? handler : &DefaultFailureHandler);
+}
+
+[[noreturn]] inline void Fail(const char* message) {
+    FailureHandlerSlot().load()(message);
+    std::abort();
+}
+
+// Поколение контейнера: увеличивается при каждой операции, после которой
+// выданные контейнером итераторы становятся недействительными
+class Generation {
+public:
+    constexpr uint64_t Get() const noexcept {
+        return value_;
+    }
+
+    constexpr void Advance() noexcept {
+        ++value_;
+    }
+
+private:
+    uint64_t value_ = 0;
+};
+
+// Итератор произвольного доступа поверх указателя, помнящий контейнер и его поколение.
+// Разыменование устаревшего итератора вызывает Fail. Сравнение и арифметика
+// не проверяются: устаревший итератор можно сравнить, но не разыменовать
+template <typename Type>
+class CheckedIterator {
+public:
+    using iterator_concept = std::contiguous_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<Type>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Type*;
+    using reference = Type&;
+
+    constexpr CheckedIterator() noexcept = default;
+
+    constexpr CheckedIterator(std::nullptr_t) noexcept {
+    }
+
+    constexpr CheckedIterator(Type* ptr, const Generation* owner) noexcept
+        : ptr_(ptr),
+        owner_(owner),
+        generation_(owner->Get()) {
+    }
+
+    // Итератор преобразуется в константный, но не наоборот
+    template <typename Other>
+        requires(!std::is_same_v<Other, Type> && std::is_convertible_v<Other*, Type*>)
+    constexpr CheckedIterator(const CheckedIterator<Other>& other) noexcept
+        : ptr_(other.ptr_),
+        owner_(other.owner_),
+        generation_(other.generation_) {
+    }
+
+    constexpr reference operator*() const {
+        Check();
+        return *ptr_;
+    }
+
+    constexpr pointer operator->() const {
+        Check();
+        return ptr_;
+    }
+
+    constexpr reference operator[](difference_type n) const {
+        Check();
+        return ptr_[n];
+    }
+
+    constexpr CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    constexpr CheckedIterator operator++(int) noexcept {
+        CheckedIterator old = *this;
+        ++ptr_;
+        return old;
+    }
+
+    constexpr CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    constexpr CheckedIterator operator--(int) noexcept {
+        CheckedIterator old = *this;
+        --ptr_;
+        return old;
+    }
+
+    constexpr CheckedIterator& operator+=(difference_type n) noexcept {
+        ptr_ += n;
+        return *this;
+    }
+
+    constexpr CheckedIterator& operator-=(difference_type n) noexcept {
+        ptr_ -= n;
+        return *this;
+    }
+
+    friend constexpr CheckedIterator operator+(CheckedIterator it, difference_type n) noexcept {
+        return it += n;
+    }
+
+    friend constexpr CheckedIterator operator+(difference_type n, CheckedIterator it) noexcept {
+        return it += n;
+    }
+
+    friend constexpr CheckedIterator operator-(CheckedIterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+
+    template <typename Other>
+        requires std::is_same_v<std::remove_const_t<Other>, std::remove_const_t<Type>>
+    constexpr difference_type operator-(const CheckedIterator<Other>& rhs) const noexcept {
+        return ptr_ - rhs.ptr_;
+    }
+
+    template <typename Other>
+        requires std::is_same_v<std::remove_const_t<Other>, std::remove_const_t<Type>>
+    constexpr bool operator==(const CheckedIterator<Other>& rhs) const noexcept {
+        return ptr_ == rhs.ptr_;
+    }
+
+    template <typename Other>
+        requires std::is_same_v<std::remove_const_t<Other>, std::remove_const_t<Type>>
+    constexpr std::strong_ordering operator<=>(const CheckedIterator<Other>& rhs) const noexcept {
+        return std::compare_three_way()(ptr_, rhs.ptr_);
+    }
+
+    constexpr bool operator==(std::nullptr_t) const noexcept {
+        return ptr_ == nullptr;
+    }
+
+    // Как и указатель, итератор приводится к bool
+    constexpr explicit operator bool() const noexcept {
+        return ptr_ != nullptr;
+    }
+
+    // Сообщает, выдан ли итератор контейнером и не устарел ли он
+    constexpr bool IsValid() const noexcept {
+        return owner_ != nullptr && owner_->Get() == generation_;
+    }
+
+    // Проверяет, что итератор выдан контейнером с поколением owner и не устарел.
+    // Так контейнер проверяет позиции, переданные в Insert и Erase
+    constexpr void CheckOwner(const Generation* owner) const {
+        if (owner_ != owner) {
+            Fail("iterator does not belong to this container");
+        }
+        Check();
+    }
+
+private:
+    template <typename Other>
+    friend class CheckedIterator;
+
+    constexpr void Check() const {
+        if (owner_ == nullptr) {
+            Fail("dereferencing an iterator that does not belong to any container");
+        }
+        if (owner_->Get() != generation_) {
+            Fail("iterator used after reallocation, Insert or Erase");
+        }
+    }
+
+    Type* ptr_ = nullptr;
+    const Generation* owner_ = nullptr;
+    uint64_t generation_ = 0;
+};
+
+// Статистика выделений памяти под элементы одного типа
+struct AllocationStats {
+    // Блоки и байты, выделенные и ещё не освобождённые
+    size_t live_allocations = 0;
+    size_t live_bytes = 0;
+    // Всего выделений и наибольшее число одновременно занятых байт
+    size_t total_allocations = 0;
+    size_t peak_bytes = 0;
+};
+
+// Учёт выделений памяти по типам элементов. Реестр никогда не разрушается:
+// векторы в статических переменных освобождают память уже после завершения main,
+// и реестр должен пережить их. Отчёт о неосвобождённой памяти печатается
+// обработчиком std::atexit
+class AllocationRegistry {
+public:
+    static AllocationRegistry& Instance() {
+        static AllocationRegistry* registry = [] {
+            auto* instance = new AllocationRegistry();
+            std::atexit([] {
+                AllocationRegistry::Instance().ReportLeaks(std::cerr);
+            });
+            return instance;
+        }();
+        return *registry;
+    }
+
+    void OnAllocate(const std::type_info& type, size_t bytes) {
+        std::lock_guard lock(mutex_);
+        AllocationStats& stats = stats_[std::type_index(type)];
+        ++stats.live_allocations;
+        ++stats.total_allocations;
+        stats.live_bytes += bytes;
+        stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes);
+    }
+
+    void OnDeallocate(const std::type_info& type, size_t bytes) {
+        std::lock_guard lock(mutex_);
+        AllocationStats& stats = stats_[std::type_index(type)];
+        if (stats.live_allocations == 0 || stats.live_bytes < bytes) {
+            Fail("deallocating memory that was not allocated");
+        }
+        --stats.live_allocations;
+        stats.live_bytes -= bytes;
+    }
+
+    AllocationStats GetStats(const std::type_info& type) const {
+        std::lock_guard lock(mutex_);
+        const auto it = stats_.find(std::type_index(type));
+        return it != stats_.end() ? it->second : AllocationStats{};
+    }
+
+    // Печатает типы, у которых остались неосвобождённые блоки.
+    // Возвращает количество таких типов
+    size_t ReportLeaks(std::ostream& out) const {
+        std::lock_guard lock(mutex_);
+        size_t leaking_types = 0;
+        for (const auto& [type, stats] : stats_) {
+            if (stats.live_allocations == 0) {
+                continue;
+            }
+            ++leaking_types;
+            out << "SimpleVector leak: " << stats.live_allocations << " block(s), " << stats.live_bytes
+                << " byte(s) of " << Demangle(type.name()) << '\n';
+        }
+        out.flush();
+        return leaking_types;
+    }
+
+private:
+    AllocationRegistry() = default;
+
+    static std::string Demangle(const char* name) {
+#if __has_include(<cxxabi.h>)
+        int status = 0;
+        std::unique_ptr<char, decltype(&std::free)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status),
+                                                              &std::free);
+        if (status == 0 && demangled != nullptr) {
+            return demangled.get();
+        }
+#endif
+        return name;
+    }
+
+    mutable std::mutex mutex_;
+    std::map<std::type_index, AllocationStats> stats_;
+};
+
+// Статистика выделений памяти под элементы типа Type
+template <typename Type>
+AllocationStats GetAllocationStats() {
+    return AllocationRegistry::Instance().GetStats(typeid(Type));
+}
+
+// Печатает в out неосвобождённую память по типам и возвращает количество таких типов
+inline size_t ReportLeaks(std::ostream& out) {
+    return AllocationRegistry::Instance().ReportLeaks(out);
+}
+
+}  // namespace checked
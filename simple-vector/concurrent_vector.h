@@ -0,0 +1,294 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "array_ptr.h"
+
+// Вектор только для добавления, в который могут одновременно писать несколько потоков.
+// Элементы живут в сегментах вместимостью 64, 128, 256, ... элементов: сегменты
+// никогда не перевыделяются, поэтому элементы не переезжают, а ссылки на них
+// остаются действительными до разрушения вектора.
+// PushBack и EmplaceBack захватывают ячейку атомарным счётчиком без блокировок,
+// создают в ней элемент и публикуют его флагом ячейки. Читать по индексу можно
+// одновременно с добавлением, но только опубликованные элементы.
+// Разрушение вектора не должно пересекаться с другими операциями над ним
+template <typename Type>
+class ConcurrentSimpleVector {
+    // Вместимость первого сегмента — 2^kFirstSegmentBits элементов
+    static constexpr size_t kFirstSegmentBits = 6;
+    static constexpr size_t kFirstSegmentSize = size_t(1) << kFirstSegmentBits;
+    static constexpr size_t kMaxSegments = 64 - kFirstSegmentBits;
+
+    // Состояние ячейки: пустая, опубликованная или брошенная, если конструктор бросил исключение
+    enum SlotState : uint8_t {
+        kEmpty,
+        kPublished,
+        kAbandoned,
+    };
+
+    struct Segment {
+        explicit Segment(size_t capacity)
+            : items(capacity),
+            states(new std::atomic<uint8_t>[capacity]()) {
+        }
+
+        ArrayPtr<Type> items;
+        std::unique_ptr<std::atomic<uint8_t>[]> states;
+    };
+
+public:
+    class SnapshotIterator;
+    class Snapshot;
+
+    ConcurrentSimpleVector() noexcept = default;
+
+    ConcurrentSimpleVector(const ConcurrentSimpleVector&) = delete;
+    ConcurrentSimpleVector& operator=(const ConcurrentSimpleVector&) = delete;
+
+    ~ConcurrentSimpleVector() {
+        const size_t size = size_.load(std::memory_order_acquire);
+        for (size_t index = 0; index < kMaxSegments; ++index) {
+            Segment* segment = segments_[index].load(std::memory_order_acquire);
+            if (segment == nullptr) {
+                continue;
+            }
+            const size_t start = SegmentStart(index);
+            const size_t count = start < size ? std::min(SegmentCapacity(index), size - start) : 0;
+            for (size_t offset = 0; offset < count; ++offset) {
+                if (segment->states[offset].load(std::memory_order_relaxed) == kPublished) {
+                    std::destroy_at(segment->items.Get() + offset);
+                }
+            }
+            delete segment;
+        }
+    }
+
+    // Количество захваченных ячеек. Часть из них может быть ещё не опубликована
+    size_t GetSize() const noexcept {
+        return size_.load(std::memory_order_acquire);
+    }
+
+    // Количество ячеек в уже выделенных сегментах. Сегменты устанавливаются
+    // конкурентно и не обязательно по порядку, поэтому пропуски не прерывают подсчёт
+    size_t GetCapacity() const noexcept {
+        size_t capacity = 0;
+        for (size_t segment = 0; segment < kMaxSegments; ++segment) {
+            if (segments_[segment].load(std::memory_order_acquire) != nullptr) {
+                capacity += SegmentCapacity(segment);
+            }
+        }
+        return capacity;
+    }
+
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Сообщает, опубликован ли элемент с индексом index
+    bool IsPublished(size_t index) const noexcept {
+        if (index >= GetSize()) {
+            return false;
+        }
+        const Segment* segment = segments_[SegmentIndex(index)].load(std::memory_order_acquire);
+        return segment != nullptr
+            && segment->states[SegmentOffset(index)].load(std::memory_order_acquire) == kPublished;
+    }
+
+    // Возвращает указатель на элемент index или nullptr, если он ещё не опубликован
+    const Type* TryGet(size_t index) const noexcept {
+        return IsPublished(index) ? &Element(index) : nullptr;
+    }
+
+    // Возвращает ссылку на опубликованный элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(IsPublished(index));
+        return Element(index);
+    }
+
+    const Type& operator[](size_t index) const noexcept {
+        assert(IsPublished(index));
+        return Element(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если элемент index не опубликован
+    const Type& At(size_t index) const {
+        if (!IsPublished(index)) { throw std::out_of_range("element is not published"); }
+        return Element(index);
+    }
+
+    // Выделяет сегменты под capacity элементов заранее, чтобы добавление не ждало выделения памяти
+    void Reserve(size_t capacity) {
+        for (size_t segment = 0; segment < kMaxSegments && SegmentStart(segment) < capacity; ++segment) {
+            AcquireSegment(segment);
+        }
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в следующей свободной ячейке и публикует его.
+    // Возвращает ссылку на элемент: она действительна, пока жив вектор.
+    // Если конструктор бросит исключение, ячейка остаётся брошенной и при обходе пропускается
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        Segment& segment = AcquireSegment(SegmentIndex(index));
+        const size_t offset = SegmentOffset(index);
+        Type* slot = segment.items.Get() + offset;
+        try {
+            std::construct_at(slot, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            segment.states[offset].store(kAbandoned, std::memory_order_release);
+            throw;
+        }
+        segment.states[offset].store(kPublished, std::memory_order_release);
+        return *slot;
+    }
+
+    // Снимок вектора: обходит опубликованные элементы среди ячеек, захваченных к моменту
+    // создания снимка. Элементы, добавленные позже, в снимок не попадают
+    Snapshot GetSnapshot() const noexcept {
+        return Snapshot(this, GetSize());
+    }
+
+    // Однонаправленный итератор по опубликованным элементам снимка.
+    // Ячейки, ещё не опубликованные в момент перехода к ним, пропускаются
+    class SnapshotIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        SnapshotIterator() = default;
+
+        reference operator*() const noexcept {
+            return vector_->Element(index_);
+        }
+        pointer operator->() const noexcept {
+            return &vector_->Element(index_);
+        }
+        SnapshotIterator& operator++() noexcept {
+            ++index_;
+            SkipUnpublished();
+            return *this;
+        }
+        SnapshotIterator operator++(int) noexcept {
+            SnapshotIterator old = *this;
+            ++*this;
+            return old;
+        }
+        // Индекс текущего элемента в векторе
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+        bool operator==(const SnapshotIterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+
+    private:
+        friend class Snapshot;
+
+        SnapshotIterator(const ConcurrentSimpleVector* vector, size_t index, size_t end) noexcept
+            : vector_(vector),
+            index_(index),
+            end_(end) {
+            SkipUnpublished();
+        }
+
+        void SkipUnpublished() noexcept {
+            while (index_ < end_ && !vector_->IsPublished(index_)) {
+                ++index_;
+            }
+        }
+
+        const ConcurrentSimpleVector* vector_ = nullptr;
+        size_t index_ = 0;
+        size_t end_ = 0;
+    };
+
+    class Snapshot {
+    public:
+        // Количество ячеек в снимке, включая неопубликованные
+        size_t GetSize() const noexcept {
+            return size_;
+        }
+        SnapshotIterator begin() const noexcept {
+            return SnapshotIterator(vector_, 0, size_);
+        }
+        SnapshotIterator end() const noexcept {
+            return SnapshotIterator(vector_, size_, size_);
+        }
+
+    private:
+        friend class ConcurrentSimpleVector;
+
+        Snapshot(const ConcurrentSimpleVector* vector, size_t size) noexcept
+            : vector_(vector),
+            size_(size) {
+        }
+
+        const ConcurrentSimpleVector* vector_;
+        size_t size_;
+    };
+
+private:
+    // Сегмент k начинается с индекса 64 * (2^k - 1) и вмещает 64 * 2^k элементов,
+    // поэтому номер сегмента — это номер старшего бита index + 64
+    static size_t SegmentIndex(size_t index) noexcept {
+        // Лишнее | kFirstSegmentSize не меняет результат, но показывает компилятору,
+        // что номер сегмента не выходит за массив даже при переполнении index + 64
+        return std::bit_width((index + kFirstSegmentSize) | kFirstSegmentSize) - 1 - kFirstSegmentBits;
+    }
+
+    static size_t SegmentOffset(size_t index) noexcept {
+        const size_t biased = index + kFirstSegmentSize;
+        return biased - std::bit_floor(biased);
+    }
+
+    static size_t SegmentCapacity(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    static size_t SegmentStart(size_t segment) noexcept {
+        return SegmentCapacity(segment) - kFirstSegmentSize;
+    }
+
+    Type& Element(size_t index) const noexcept {
+        return segments_[SegmentIndex(index)].load(std::memory_order_acquire)->items.Get()[SegmentOffset(index)];
+    }
+
+    // Возвращает сегмент, выделяя его при первом обращении. Если несколько потоков
+    // выделили сегмент одновременно, остаётся тот, что был установлен первым
+    Segment& AcquireSegment(size_t index) {
+        Segment* segment = segments_[index].load(std::memory_order_acquire);
+        if (segment != nullptr) {
+            return *segment;
+        }
+        auto fresh = std::make_unique<Segment>(SegmentCapacity(index));
+        if (segments_[index].compare_exchange_strong(segment, fresh.get(), std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+            return *fresh.release();
+        }
+        return *segment;
+    }
+
+    std::atomic<size_t> size_{0};
+    std::atomic<Segment*> segments_[kMaxSegments] = {};
+};
@@ -0,0 +1,340 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "simple_vector.h"
+
+// Вектор с интерфейсом SimpleVector, копии которого делят один буфер (копирование при записи).
+// Копирование стоит O(1): увеличивается атомарный счётчик ссылок буфера. Первая изменяющая
+// операция над копией, чей буфер разделён с другими, копирует элементы в собственный буфер.
+// Изменяющими считаются и неконстантные operator[], At, begin, end, EmplaceBack, Insert
+// и Erase: они возвращают изменяемые ссылки и итераторы, поэтому, как в COW-строках,
+// помечают буфер неразделяемым. Копия такого вектора сразу получает собственные элементы,
+// и запись через выданную ранее ссылку её не затрагивает. Буфер снова становится
+// разделяемым после Clear и перевыделяющего Reserve: старые ссылки после них недействительны.
+// Разные копии можно читать и изменять из разных потоков, как std::shared_ptr;
+// один и тот же объект CowSimpleVector — нет
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+class CowSimpleVector {
+public:
+    using Vector = SimpleVector<Type, Allocator, GrowthPolicy>;
+    using Iterator = typename Vector::Iterator;
+    using ConstIterator = typename Vector::ConstIterator;
+
+    CowSimpleVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit CowSimpleVector(size_t size)
+        : buffer_(new Buffer(Vector(size))) {
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    CowSimpleVector(size_t size, const Type& value)
+        : buffer_(new Buffer(Vector(size, value))) {
+    }
+
+    // Создаёт вектор из std::initializer_list
+    CowSimpleVector(std::initializer_list<Type> init)
+        : buffer_(new Buffer(Vector(init))) {
+    }
+
+    // Забирает элементы обычного вектора без копирования
+    explicit CowSimpleVector(Vector&& items)
+        : buffer_(new Buffer(std::move(items))) {
+    }
+
+    // Делит буфер с other. Если other выдавал изменяемые ссылки, копирует элементы
+    CowSimpleVector(const CowSimpleVector& other) {
+        if (other.buffer_ == nullptr) {
+            return;
+        }
+        if (other.buffer_->unshareable) {
+            buffer_ = new Buffer(Vector(other.buffer_->items));
+        }
+        else {
+            buffer_ = other.buffer_;
+            buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowSimpleVector(CowSimpleVector&& other) noexcept
+        : buffer_(std::exchange(other.buffer_, nullptr)) {
+    }
+
+    ~CowSimpleVector() {
+        Release(buffer_);
+    }
+
+    CowSimpleVector& operator=(const CowSimpleVector& rhs) {
+        CowSimpleVector tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    CowSimpleVector& operator=(CowSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Release(std::exchange(buffer_, std::exchange(rhs.buffer_, nullptr)));
+        }
+        return *this;
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return buffer_ != nullptr ? buffer_->items.GetSize() : 0;
+    }
+
+    // Возвращает вместимость массива
+    size_t GetCapacity() const noexcept {
+        return buffer_ != nullptr ? buffer_->items.GetCapacity() : 0;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Сообщает, делит ли вектор буфер с другими копиями
+    bool IsShared() const noexcept {
+        return buffer_ != nullptr && buffer_->refs.load(std::memory_order_acquire) > 1;
+    }
+
+    // Возвращает элементы только для чтения, не копируя их
+    const Vector& AsVector() const noexcept {
+        return buffer_ != nullptr ? buffer_->items : EmptyVector();
+    }
+
+    // Возвращает ссылку на элемент с индексом index, предварительно отделяя буфер
+    Type& operator[](size_t index) {
+        assert(index < GetSize());
+        return Unshareable()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return buffer_->items[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) { throw std::out_of_range("index >= size"); }
+        return Unshareable()[index];
+    }
+
+    const Type& At(size_t index) const {
+        return AsVector().At(index);
+    }
+
+    // Обнуляет размер массива. Разделённый буфер не копируется, а просто отпускается
+    void Clear() noexcept {
+        if (IsShared()) {
+            Release(std::exchange(buffer_, nullptr));
+        }
+        else if (buffer_ != nullptr) {
+            buffer_->items.Clear();
+            buffer_->unshareable = false;
+        }
+    }
+
+    void PushBack(const Type& item) {
+        Mutable().PushBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        Mutable().PushBack(std::move(item));
+    }
+
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        return Unshareable().EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PopBack() {
+        assert(!IsEmpty());
+        Mutable().PopBack();
+    }
+
+    void Resize(size_t new_size) {
+        Mutable().Resize(new_size);
+    }
+
+    // Разделённый буфер копируется сразу с вместимостью new_capacity
+    void Reserve(size_t new_capacity) {
+        if (IsShared()) {
+            Detach(new_capacity);
+        }
+        else if (new_capacity > GetCapacity()) {
+            Mutable().Reserve(new_capacity);
+            buffer_->unshareable = false;
+        }
+    }
+
+    // Позиции pos, first и last могут указывать в разделённый буфер:
+    // они пересчитываются в отделённый буфер по индексу
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        const size_t dist = Offset(pos);
+        Vector& items = Unshareable();
+        return items.Insert(items.begin() + dist, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        const size_t dist = Offset(pos);
+        Vector& items = Unshareable();
+        return items.Insert(items.begin() + dist, std::move(value));
+    }
+
+    Iterator Erase(ConstIterator pos) {
+        const size_t dist = Offset(pos);
+        Vector& items = Unshareable();
+        return items.Erase(items.begin() + dist);
+    }
+
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t from = Offset(first);
+        const size_t to = Offset(last);
+        Vector& items = Unshareable();
+        return items.Erase(items.begin() + from, items.begin() + to);
+    }
+
+    // Удаляет элементы, для которых pred возвращает true. Если удалять нечего,
+    // разделённый буфер не копируется
+    template <typename Predicate>
+    size_t EraseIf(Predicate pred) {
+        if (IsShared() && std::none_of(cbegin(), cend(), pred)) {
+            return 0;
+        }
+        return Mutable().EraseIf(pred);
+    }
+
+    void swap(CowSimpleVector& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+    }
+
+    Iterator begin() {
+        return buffer_ != nullptr ? Unshareable().begin() : nullptr;
+    }
+
+    Iterator end() {
+        return buffer_ != nullptr ? Unshareable().end() : nullptr;
+    }
+
+    ConstIterator begin() const noexcept {
+        return AsVector().begin();
+    }
+
+    ConstIterator end() const noexcept {
+        return AsVector().end();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Буфер вместе со счётчиком ссылок на него
+    struct Buffer {
+        explicit Buffer(Vector&& v) noexcept
+            : items(std::move(v)) {
+        }
+
+        std::atomic<size_t> refs{1};
+        // Выставляется только единственным владельцем, поэтому атомарность не нужна
+        bool unshareable = false;
+        Vector items;
+    };
+
+    static const Vector& EmptyVector() noexcept {
+        static const Vector empty;
+        return empty;
+    }
+
+    // Последний владелец удаляет буфер. acq_rel упорядочивает изменения, сделанные
+    // другими владельцами до отпускания буфера, перед его удалением
+    static void Release(Buffer* buffer) noexcept {
+        if (buffer != nullptr && buffer->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete buffer;
+        }
+    }
+
+    size_t Offset(ConstIterator pos) const noexcept {
+        assert(pos >= cbegin() && pos <= cend());
+        return static_cast<size_t>(pos - cbegin());
+    }
+
+    // Возвращает единолично принадлежащий вектору буфер, копируя разделённый
+    Vector& Mutable() {
+        if (buffer_ == nullptr) {
+            buffer_ = new Buffer(Vector());
+        }
+        else if (buffer_->refs.load(std::memory_order_acquire) != 1) {
+            Detach(buffer_->items.GetSize());
+        }
+        return buffer_->items;
+    }
+
+    // Отделяет буфер и запрещает делить его, пока выданные ссылки могут быть живы
+    Vector& Unshareable() {
+        Vector& items = Mutable();
+        buffer_->unshareable = true;
+        return items;
+    }
+
+    // Копирует элементы разделённого буфера в новый буфер вместимостью не меньше capacity
+    void Detach(size_t capacity) {
+        const Vector& shared = buffer_->items;
+        Vector copy(::Reserve(std::max(capacity, shared.GetSize())),
+                    std::allocator_traits<Allocator>::select_on_container_copy_construction(shared.GetAllocator()));
+        copy.Append(shared);
+        Buffer* fresh = new Buffer(std::move(copy));
+        Release(std::exchange(buffer_, fresh));
+    }
+
+    Buffer* buffer_ = nullptr;
+};
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator==(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                       const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return &lhs.AsVector() == &rhs.AsVector() || lhs.AsVector() == rhs.AsVector();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator!=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                       const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator<(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                      const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.AsVector() < rhs.AsVector();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator<=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                       const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.AsVector() <= rhs.AsVector();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator>(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                      const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.AsVector() > rhs.AsVector();
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy>
+inline bool operator>=(const CowSimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                       const CowSimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return lhs.AsVector() >= rhs.AsVector();
+}
@@ -0,0 +1,582 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "relocate.h"
+#include "simple_span.h"
+
+// Двусторонний вектор: элементы лежат в кольцевом буфере, поэтому добавление и удаление
+// с обоих концов стоят амортизированно O(1), а доступ по индексу — одно сложение и маска.
+// Вставка и удаление в середине сдвигают более короткую сторону.
+// Вместимость — всегда степень двойки. Элементы непрерывны, только пока кольцо
+// не переходит через конец буфера; Linearize() делает их непрерывными явно
+template <typename Type>
+class DeVector {
+    template <bool kConst>
+    class BasicIterator;
+
+public:
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    DeVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit DeVector(size_t size) {
+        Resize(size);
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    DeVector(size_t size, const Type& value) {
+        Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            EmplaceBack(value);
+        }
+    }
+
+    // Создаёт вектор из std::initializer_list
+    DeVector(std::initializer_list<Type> init) {
+        Reserve(init.size());
+        for (const Type& value : init) {
+            EmplaceBack(value);
+        }
+    }
+
+    DeVector(const DeVector& other) {
+        Reserve(other.size_);
+        for (const Type& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    DeVector(DeVector&& other) noexcept {
+        swap(other);
+    }
+
+    ~DeVector() {
+        Clear();
+    }
+
+    DeVector& operator=(const DeVector& rhs) {
+        if (this != &rhs) {
+            DeVector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    DeVector& operator=(DeVector&& rhs) noexcept {
+        if (this != &rhs) {
+            DeVector tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость кольцевого буфера
+    size_t GetCapacity() const noexcept {
+        return items_.GetSize();
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return *Slot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) { throw std::out_of_range("out of range"); }
+        return *Slot(index);
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("out of range"); }
+        return *Slot(index);
+    }
+
+    // Первый и последний элементы. Вектор не должен быть пустым
+    Type& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const Type& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    Type& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const Type& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    // Разрушает все элементы, не изменяя вместимость массива
+    void Clear() noexcept {
+        const auto [first, second] = GetSegments();
+        items_.Destroy(first.begin(), first.GetSize());
+        items_.Destroy(second.begin(), second.GetSize());
+        head_ = 0;
+        size_ = 0;
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    void PushFront(const Type& item) {
+        EmplaceFront(item);
+    }
+
+    void PushFront(Type&& item) {
+        EmplaceFront(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args и возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) [[unlikely]] {
+            ReallocateAndEmplace(size_, std::forward<Args>(args)...);
+        }
+        else {
+            items_.Construct(Slot(size_), std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Back();
+    }
+
+    // Создаёт элемент в начале вектора из аргументов args и возвращает ссылку на него
+    template <typename... Args>
+    Type& EmplaceFront(Args&&... args) {
+        if (size_ == GetCapacity()) [[unlikely]] {
+            ReallocateAndEmplace(0, std::forward<Args>(args)...);
+        }
+        else {
+            const size_t new_head = (head_ - 1) & Mask();
+            items_.Construct(items_.Get() + new_head, std::forward<Args>(args)...);
+            head_ = new_head;
+        }
+        ++size_;
+        return Front();
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        items_.Destroy(Slot(size_), 1);
+    }
+
+    // Удаляет первый элемент вектора. Вектор не должен быть пустым
+    void PopFront() noexcept {
+        assert(!IsEmpty());
+        items_.Destroy(Slot(0), 1);
+        head_ = (head_ + 1) & Mask();
+        --size_;
+    }
+
+    void swap(DeVector& other) noexcept {
+        items_.swap(other.items_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    void Resize(size_t new_size) {
+        Reserve(new_size);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+        while (size_ > new_size) {
+            PopBack();
+        }
+    }
+
+    // Увеличивает вместимость до ближайшей степени двойки не меньше new_capacity
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Reallocate(std::bit_ceil(new_capacity));
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos, сдвигая на одну позицию
+    // более короткую из сторон. Возвращает итератор на созданный элемент
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= cbegin() && pos <= cend());
+        const size_t dist = pos.index_;
+        if (dist == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        }
+        else if (dist == 0) {
+            EmplaceFront(std::forward<Args>(args)...);
+        }
+        else {
+            // Элемент создаётся заранее: аргументы могут ссылаться на сдвигаемые элементы
+            Type tmp(std::forward<Args>(args)...);
+            Reserve(size_ + 1);
+            if (dist < size_ - dist) {
+                EmplaceFront(std::move(Front()));
+                for (size_t i = 1; i < dist; ++i) {
+                    *Slot(i) = std::move(*Slot(i + 1));
+                }
+            }
+            else {
+                EmplaceBack(std::move(Back()));
+                for (size_t i = size_ - 2; i > dist; --i) {
+                    *Slot(i) = std::move(*Slot(i - 1));
+                }
+            }
+            *Slot(dist) = std::move(tmp);
+        }
+        return begin() + dist;
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= cbegin() && pos < cend());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last), сдвигая более короткую из оставшихся сторон.
+    // Возвращает итератор на элемент, следовавший за удалёнными
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(first >= cbegin() && first <= last && last <= cend());
+        const size_t dist = first.index_;
+        const size_t count = last.index_ - dist;
+        if (count == 0) {
+            return begin() + dist;
+        }
+        if (dist < size_ - dist - count) {
+            for (size_t i = dist; i > 0; --i) {
+                *Slot(i - 1 + count) = std::move(*Slot(i - 1));
+            }
+            for (size_t i = 0; i < count; ++i) {
+                PopFront();
+            }
+        }
+        else {
+            for (size_t i = dist + count; i < size_; ++i) {
+                *Slot(i - count) = std::move(*Slot(i));
+            }
+            for (size_t i = 0; i < count; ++i) {
+                PopBack();
+            }
+        }
+        return begin() + dist;
+    }
+
+    // Сообщает, лежат ли элементы в буфере одним непрерывным куском
+    bool IsLinear() const noexcept {
+        return head_ + size_ <= GetCapacity();
+    }
+
+    // Делает элементы непрерывными и возвращает их представление.
+    // Если кольцо переходит через конец буфера, полный буфер поворачивается на месте,
+    // а неполный переносится в новый того же размера. Итераторы и ссылки становятся
+    // недействительными, только если элементы пришлось переставить
+    SimpleSpan<Type> Linearize() {
+        if (!IsLinear()) {
+            if (size_ == GetCapacity()) {
+                std::rotate(items_.Get(), items_.Get() + head_, items_.Get() + size_);
+                head_ = 0;
+            }
+            else {
+                Reallocate(GetCapacity());
+            }
+        }
+        return SimpleSpan<Type>(items_.Get() + head_, size_);
+    }
+
+    // Представления двух непрерывных кусков, из которых состоит вектор: от начала
+    // до конца буфера и перешедший через конец остаток (пустой, если вектор линеен).
+    // Позволяют обойти все элементы без Linearize
+    std::pair<SimpleSpan<Type>, SimpleSpan<Type>> GetSegments() noexcept {
+        const size_t first = std::min(size_, GetCapacity() - head_);
+        return {SimpleSpan<Type>(items_.Get() + head_, first), SimpleSpan<Type>(items_.Get(), size_ - first)};
+    }
+
+    std::pair<ConstSimpleSpan<Type>, ConstSimpleSpan<Type>> GetSegments() const noexcept {
+        const size_t first = std::min(size_, GetCapacity() - head_);
+        return {ConstSimpleSpan<Type>(items_.Get() + head_, first), ConstSimpleSpan<Type>(items_.Get(), size_ - first)};
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator cend() const noexcept {
+        return ConstIterator(this, size_);
+    }
+
+private:
+    // Итератор произвольного доступа: вектор и логический индекс элемента.
+    // Переживает перевыделение памяти, но не вставку и удаление
+    template <bool kConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<kConst, const DeVector, DeVector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<kConst, const Type*, Type*>;
+        using reference = std::conditional_t<kConst, const Type&, Type&>;
+
+        BasicIterator() noexcept = default;
+
+        // Изменяемый итератор преобразуется в константный
+        template <bool kOtherConst>
+            requires(kConst && !kOtherConst)
+        BasicIterator(const BasicIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_),
+            index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return (*owner_)[index_];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*owner_)[index_];
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend std::strong_ordering operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        friend class DeVector;
+        friend class BasicIterator<true>;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner),
+            index_(index) {
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    // Вместимость — степень двойки, поэтому переход через конец буфера — это маска
+    size_t Mask() const noexcept {
+        return GetCapacity() - 1;
+    }
+
+    // Ячейка буфера, в которой лежит элемент с логическим индексом index
+    Type* Slot(size_t index) const noexcept {
+        return items_.Get() + ((head_ + index) & Mask());
+    }
+
+    // Создаёт в неинициализированной памяти dest перемещённые (или скопированные,
+    // если перемещение может бросить) значения count элементов из first.
+    // При исключении созданные элементы разрушаются
+    void UninitializedRelocate(Type* first, size_t count, Type* dest) {
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                items_.Construct(dest + i, std::move_if_noexcept(first[i]));
+            }
+        }
+        catch (...) {
+            items_.Destroy(dest, i);
+            throw;
+        }
+    }
+
+    // Переносит все элементы в начало буфера dest по порядку, разрушая исходные
+    void RelocateElements(Type* dest) {
+        const auto [first, second] = GetSegments();
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            TriviallyRelocate(first.begin(), first.GetSize(), dest);
+            TriviallyRelocate(second.begin(), second.GetSize(), dest + first.GetSize());
+        }
+        else {
+            UninitializedRelocate(first.begin(), first.GetSize(), dest);
+            try {
+                UninitializedRelocate(second.begin(), second.GetSize(), dest + first.GetSize());
+            }
+            catch (...) {
+                items_.Destroy(dest, first.GetSize());
+                throw;
+            }
+            items_.Destroy(first.begin(), first.GetSize());
+            items_.Destroy(second.begin(), second.GetSize());
+        }
+    }
+
+    // Переносит элементы в новый буфер под new_capacity элементов
+    void Reallocate(size_t new_capacity) {
+        ArrayPtr<Type> tmp(new_capacity);
+        RelocateElements(tmp.Get());
+        items_.swap(tmp);
+        head_ = 0;
+    }
+
+    // Переносит элементы в буфер вдвое больше, создавая новый элемент из args
+    // в начале (dist == 0) или в конце (dist == size) вектора.
+    // При исключении вектор остаётся в исходном состоянии
+    template <typename... Args>
+    void ReallocateAndEmplace(size_t dist, Args&&... args) {
+        assert(dist == 0 || dist == size_);
+        ArrayPtr<Type> tmp(std::max<size_t>(GetCapacity() * 2, 1));
+        items_.Construct(tmp.Get() + dist, std::forward<Args>(args)...);
+        try {
+            RelocateElements(tmp.Get() + (dist == 0 ? 1 : 0));
+        }
+        catch (...) {
+            items_.Destroy(tmp.Get() + dist, 1);
+            throw;
+        }
+        items_.swap(tmp);
+        head_ = 0;
+    }
+
+    ArrayPtr<Type> items_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+template <typename Type>
+inline bool operator==(const DeVector<Type>& lhs, const DeVector<Type>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize()) && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <typename Type>
+inline bool operator!=(const DeVector<Type>& lhs, const DeVector<Type>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type>
+inline bool operator<(const DeVector<Type>& lhs, const DeVector<Type>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type>
+inline bool operator<=(const DeVector<Type>& lhs, const DeVector<Type>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type>
+inline bool operator>(const DeVector<Type>& lhs, const DeVector<Type>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type>
+inline bool operator>=(const DeVector<Type>& lhs, const DeVector<Type>& rhs) {
+    return !(lhs < rhs);
+}
@@ -0,0 +1,683 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simple_span.h"
+#include "simple_vector.h"
+
+// Отсортированные множество и словарь поверх SimpleVector. Ключи лежат одним
+// отсортированным массивом, а поиск в нём выполняет индекс Index<Key>.
+// Требования к индексу:
+//     void Build(ConstSimpleSpan<Key> keys, const Compare& comp)
+//         перестраивает индекс по отсортированным без повторов ключам;
+//     size_t LowerBound(ConstSimpleSpan<Key> keys, const Key& key, const Compare& comp) const
+//         возвращает индекс первого ключа, не меньшего key, или keys.GetSize().
+// Изменение по одному элементу сдвигает хвост массива и перестраивает индекс, то есть
+// стоит O(n). Таблицы, которые в основном читают, загружаются BulkLoad (одна сортировка
+// и удаление повторов) и пополняются InsertBatch (одно слияние на пакет)
+
+// Обычный двоичный поиск по массиву ключей. Своих данных не хранит
+template <typename Key>
+struct BinarySearchIndex {
+    template <typename Compare>
+    void Build(ConstSimpleSpan<Key> /*keys*/, const Compare& /*comp*/) noexcept {
+    }
+
+    template <typename Compare>
+    size_t LowerBound(ConstSimpleSpan<Key> keys, const Key& key, const Compare& comp) const {
+        return static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key, comp) - keys.begin());
+    }
+};
+
+// Статическое B+-дерево над отсортированными ключами. Нижний уровень — сам массив ключей,
+// поделённый на блоки по kBlock ключей (кэш-линия для мелких ключей). Каждый следующий
+// уровень хранит наибольший ключ каждого блока предыдущего и тоже делится на блоки.
+// Поиск спускается сверху и на каждом уровне читает ровно один блок: вместо log2(n)
+// зависимых промахов двоичного поиска их log_kBlock(n). Внутри блока ключи, меньшие
+// искомого, считаются без ветвлений, и такой цикл компилятор векторизует.
+// Номер найденного ключа получается из номера блока, поэтому индекс хранит только
+// верхние уровни: около n / (kBlock - 1) копий ключей.
+// Если уровень ниже не помещается в кэш, до чтения текущего блока запрашиваются
+// все kBlock блоков-потомков, и промах следующего уровня перекрывается со сравнениями
+template <typename Key>
+class BTreeIndex {
+public:
+    static constexpr size_t kBlock = std::max<size_t>(2, 64 / sizeof(Key));
+    // Уровни меньше этого размера обычно уже в кэше, и предвыборка для них только
+    // занимает порт загрузки
+    static constexpr size_t kPrefetchBytes = size_t(4) << 20;
+
+    template <typename Compare>
+    void Build(ConstSimpleSpan<Key> keys, const Compare& /*comp*/) {
+        nodes_.Clear();
+        levels_.Clear();
+        // Уровни строятся снизу вверх, пока очередной не уместится в один блок
+        size_t below_size = keys.GetSize();
+        size_t below_offset = 0;
+        bool below_is_keys = true;
+        while (below_size > kBlock) {
+            const size_t size = (below_size + kBlock - 1) / kBlock;
+            const size_t offset = nodes_.GetSize();
+            for (size_t i = 0; i < size; ++i) {
+                const size_t last = std::min((i + 1) * kBlock, below_size) - 1;
+                // Копия: PushBack может перевыделить память, в которой лежит ключ уровня ниже
+                Key node = below_is_keys ? keys[last] : nodes_[below_offset + last];
+                nodes_.PushBack(std::move(node));
+            }
+            // Неполный последний блок дополняется наибольшим ключом уровня,
+            // чтобы блоки всегда читались целиком
+            while (nodes_.GetSize() % kBlock != 0) {
+                nodes_.PushBack(Key(nodes_[nodes_.GetSize() - 1]));
+            }
+            levels_.PushBack({offset, size});
+            below_size = size;
+            below_offset = offset;
+            below_is_keys = false;
+        }
+    }
+
+    template <typename Compare>
+    size_t LowerBound(ConstSimpleSpan<Key> keys, const Key& key, const Compare& comp) const {
+        const size_t n = keys.GetSize();
+        size_t block = 0;
+        for (size_t level = levels_.GetSize(); level-- > 0;) {
+            const Level& current = levels_[level];
+            const Key* children = level > 0 ? nodes_.GetData() + levels_[level - 1].offset : keys.begin();
+            const size_t children_size = level > 0 ? levels_[level - 1].size : n;
+            if (children_size * sizeof(Key) >= kPrefetchBytes) {
+                const size_t first_child = block * kBlock * kBlock;
+                for (size_t i = 0; i < kBlock && first_child + i * kBlock < children_size; ++i) {
+                    Prefetch(children + first_child + i * kBlock);
+                }
+            }
+            block = block * kBlock + CountLess(nodes_.GetData() + current.offset + block * kBlock, kBlock, key, comp);
+            // Искомый ключ больше наибольшего
+            if (block >= current.size) {
+                return n;
+            }
+        }
+        const size_t first = block * kBlock;
+        return first + CountLess(keys.begin() + first, std::min(kBlock, n - first), key, comp);
+    }
+
+private:
+    struct Level {
+        size_t offset;
+        size_t size;
+    };
+
+    static void Prefetch([[maybe_unused]] const Key* address) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#endif
+    }
+
+    template <typename Compare>
+    static size_t CountLess(const Key* block, size_t count, const Key& key, const Compare& comp) {
+        size_t less = 0;
+        for (size_t i = 0; i < count; ++i) {
+            less += static_cast<size_t>(comp(block[i], key));
+        }
+        return less;
+    }
+
+    // Уровни подряд, каждый начинается с границы блока; levels_[0] — ближайший к ключам
+    SimpleVector<Key> nodes_;
+    SimpleVector<Level> levels_;
+};
+
+namespace flat_detail {
+
+// Сортирует items по ключу key_of(item) и оставляет первый из элементов с равными ключами
+template <typename Item, typename KeyOf, typename Compare>
+void SortUnique(SimpleVector<Item>& items, const KeyOf& key_of, const Compare& comp) {
+    std::stable_sort(items.begin(), items.end(), [&](const Item& lhs, const Item& rhs) {
+        return comp(key_of(lhs), key_of(rhs));
+    });
+    const auto last = std::unique(items.begin(), items.end(), [&](const Item& lhs, const Item& rhs) {
+        return !comp(key_of(lhs), key_of(rhs));
+    });
+    items.Erase(last, items.end());
+}
+
+}  // namespace flat_detail
+
+// Отсортированное множество уникальных ключей
+template <typename Key, typename Compare = std::less<Key>, template <typename> class Index = BinarySearchIndex>
+class FlatSet {
+public:
+    using Iterator = typename SimpleVector<Key>::ConstIterator;
+    using ConstIterator = Iterator;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    // Загружает ключи одной сортировкой. Из равных ключей остаётся первый
+    explicit FlatSet(SimpleVector<Key> keys, const Compare& comp = Compare())
+        : comp_(comp) {
+        BulkLoad(std::move(keys));
+    }
+
+    FlatSet(std::initializer_list<Key> init, const Compare& comp = Compare())
+        : FlatSet(SimpleVector<Key>(init), comp) {
+    }
+
+    // Заменяет содержимое ключами keys: сортирует их, удаляет повторы и строит индекс
+    void BulkLoad(SimpleVector<Key> keys) {
+        flat_detail::SortUnique(keys, std::identity{}, comp_);
+        keys_ = std::move(keys);
+        RebuildIndex();
+    }
+
+    // Добавляет отсутствующие ключи из batch одним слиянием и одной перестройкой индекса.
+    // Возвращает количество добавленных ключей
+    size_t InsertBatch(SimpleVector<Key> batch) {
+        flat_detail::SortUnique(batch, std::identity{}, comp_);
+        if (batch.IsEmpty()) {
+            return 0;
+        }
+        const size_t old_size = keys_.GetSize();
+        if (keys_.IsEmpty() || comp_(keys_[old_size - 1], batch[0])) {
+            // Все новые ключи больше имеющихся: достаточно дописать их в конец
+            keys_.Insert(keys_.cend(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+        }
+        else {
+            SimpleVector<Key> merged(Reserve(old_size + batch.GetSize()));
+            size_t i = 0;
+            size_t j = 0;
+            while (i < old_size && j < batch.GetSize()) {
+                if (comp_(batch[j], keys_[i])) {
+                    merged.PushBack(std::move(batch[j++]));
+                }
+                else {
+                    j += !comp_(keys_[i], batch[j]);
+                    merged.PushBack(std::move_if_noexcept(keys_[i++]));
+                }
+            }
+            for (; i < old_size; ++i) {
+                merged.PushBack(std::move_if_noexcept(keys_[i]));
+            }
+            for (; j < batch.GetSize(); ++j) {
+                merged.PushBack(std::move(batch[j]));
+            }
+            keys_ = std::move(merged);
+        }
+        RebuildIndex();
+        return keys_.GetSize() - old_size;
+    }
+
+    // Добавляет ключ, если его нет. Сдвигает хвост и перестраивает индекс
+    bool Insert(Key key) {
+        const size_t pos = LowerBoundIndex(key);
+        if (pos != keys_.GetSize() && !comp_(key, keys_[pos])) {
+            return false;
+        }
+        keys_.Insert(keys_.cbegin() + pos, std::move(key));
+        RebuildIndex();
+        return true;
+    }
+
+    // Удаляет ключ, если он есть
+    bool Erase(const Key& key) {
+        const size_t pos = FindIndex(key);
+        if (pos == keys_.GetSize()) {
+            return false;
+        }
+        keys_.Erase(keys_.cbegin() + pos);
+        RebuildIndex();
+        return true;
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        index_ = Index<Key>();
+    }
+
+    // Возвращает итератор на первый ключ, не меньший key
+    ConstIterator LowerBound(const Key& key) const {
+        return keys_.cbegin() + LowerBoundIndex(key);
+    }
+
+    // Возвращает итератор на ключ, равный key, или end()
+    ConstIterator Find(const Key& key) const {
+        return keys_.cbegin() + FindIndex(key);
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != keys_.GetSize();
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    // Отсортированный массив ключей
+    const SimpleVector<Key>& GetKeys() const noexcept {
+        return keys_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return keys_.cbegin();
+    }
+
+    ConstIterator end() const noexcept {
+        return keys_.cend();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return keys_.cbegin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return keys_.cend();
+    }
+
+private:
+    void RebuildIndex() {
+        index_.Build(ConstSimpleSpan<Key>(keys_), comp_);
+    }
+
+    size_t LowerBoundIndex(const Key& key) const {
+        return index_.LowerBound(ConstSimpleSpan<Key>(keys_), key, comp_);
+    }
+
+    size_t FindIndex(const Key& key) const {
+        const size_t pos = LowerBoundIndex(key);
+        return pos != keys_.GetSize() && !comp_(key, keys_[pos]) ? pos : keys_.GetSize();
+    }
+
+    SimpleVector<Key> keys_;
+    [[no_unique_address]] Compare comp_ = Compare();
+    Index<Key> index_;
+};
+
+template <typename Key, typename Compare, template <typename> class Index>
+bool operator==(const FlatSet<Key, Compare, Index>& lhs, const FlatSet<Key, Compare, Index>& rhs) {
+    return lhs.GetKeys() == rhs.GetKeys();
+}
+
+template <typename Key, typename Compare, template <typename> class Index>
+bool operator!=(const FlatSet<Key, Compare, Index>& lhs, const FlatSet<Key, Compare, Index>& rhs) {
+    return !(lhs == rhs);
+}
+
+// Отсортированный словарь с уникальными ключами. Ключи и значения хранятся отдельными
+// массивами: поиск читает только ключи. Итератор, как у SoaVector, возвращает
+// прокси-ссылку std::pair<const Key&, Value&>, которую можно разобрать структурной привязкой
+template <typename Key, typename Value, typename Compare = std::less<Key>,
+          template <typename> class Index = BinarySearchIndex>
+class FlatMap {
+    template <bool kConst>
+    class BasicIterator;
+
+public:
+    using ItemType = std::pair<Key, Value>;
+    using Reference = std::pair<const Key&, Value&>;
+    using ConstReference = std::pair<const Key&, const Value&>;
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    // Загружает пары одной сортировкой. Из пар с равными ключами остаётся первая
+    explicit FlatMap(SimpleVector<ItemType> items, const Compare& comp = Compare())
+        : comp_(comp) {
+        BulkLoad(std::move(items));
+    }
+
+    FlatMap(std::initializer_list<ItemType> init, const Compare& comp = Compare())
+        : FlatMap(SimpleVector<ItemType>(init), comp) {
+    }
+
+    // Заменяет содержимое парами items: сортирует их, удаляет повторы ключей и строит индекс
+    void BulkLoad(SimpleVector<ItemType> items) {
+        flat_detail::SortUnique(items, KeyOf(), comp_);
+        SimpleVector<Key> keys(Reserve(items.GetSize()));
+        SimpleVector<Value> values(Reserve(items.GetSize()));
+        for (ItemType& item : items) {
+            keys.PushBack(std::move(item.first));
+            values.PushBack(std::move(item.second));
+        }
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+        RebuildIndex();
+    }
+
+    // Добавляет пары с отсутствующими ключами одним слиянием и одной перестройкой индекса.
+    // Значения имеющихся ключей не меняются. Возвращает количество добавленных пар
+    size_t InsertBatch(SimpleVector<ItemType> batch) {
+        flat_detail::SortUnique(batch, KeyOf(), comp_);
+        if (batch.IsEmpty()) {
+            return 0;
+        }
+        const size_t old_size = keys_.GetSize();
+        const size_t total = old_size + batch.GetSize();
+        SimpleVector<Key> keys(Reserve(total));
+        SimpleVector<Value> values(Reserve(total));
+        auto take_old = [&](size_t i) {
+            keys.PushBack(std::move_if_noexcept(keys_[i]));
+            values.PushBack(std::move_if_noexcept(values_[i]));
+        };
+        auto take_new = [&](ItemType& item) {
+            keys.PushBack(std::move(item.first));
+            values.PushBack(std::move(item.second));
+        };
+        size_t i = 0;
+        size_t j = 0;
+        while (i < old_size && j < batch.GetSize()) {
+            if (comp_(batch[j].first, keys_[i])) {
+                take_new(batch[j++]);
+            }
+            else {
+                j += !comp_(keys_[i], batch[j].first);
+                take_old(i++);
+            }
+        }
+        for (; i < old_size; ++i) {
+            take_old(i);
+        }
+        for (; j < batch.GetSize(); ++j) {
+            take_new(batch[j]);
+        }
+        keys_ = std::move(keys);
+        values_ = std::move(values);
+        RebuildIndex();
+        return keys_.GetSize() - old_size;
+    }
+
+    // Добавляет пару, если ключа нет. Сдвигает хвосты и перестраивает индекс
+    bool Insert(Key key, Value value) {
+        const size_t pos = LowerBoundIndex(key);
+        if (pos != keys_.GetSize() && !comp_(key, keys_[pos])) {
+            return false;
+        }
+        InsertAt(pos, std::move(key), std::move(value));
+        return true;
+    }
+
+    // Добавляет пару или заменяет значение имеющегося ключа. Возвращает true, если пара добавлена
+    bool InsertOrAssign(Key key, Value value) {
+        const size_t pos = LowerBoundIndex(key);
+        if (pos != keys_.GetSize() && !comp_(key, keys_[pos])) {
+            values_[pos] = std::move(value);
+            return false;
+        }
+        InsertAt(pos, std::move(key), std::move(value));
+        return true;
+    }
+
+    // Возвращает значение ключа key, добавляя значение по умолчанию, если ключа нет
+    Value& operator[](const Key& key) {
+        const size_t pos = LowerBoundIndex(key);
+        if (pos == keys_.GetSize() || comp_(key, keys_[pos])) {
+            InsertAt(pos, key, Value());
+        }
+        return values_[pos];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если ключа нет
+    Value& At(const Key& key) {
+        const size_t pos = FindIndex(key);
+        if (pos == keys_.GetSize()) { throw std::out_of_range("key not found"); }
+        return values_[pos];
+    }
+
+    const Value& At(const Key& key) const {
+        const size_t pos = FindIndex(key);
+        if (pos == keys_.GetSize()) { throw std::out_of_range("key not found"); }
+        return values_[pos];
+    }
+
+    // Удаляет пару с ключом key, если она есть
+    bool Erase(const Key& key) {
+        const size_t pos = FindIndex(key);
+        if (pos == keys_.GetSize()) {
+            return false;
+        }
+        keys_.Erase(keys_.cbegin() + pos);
+        values_.Erase(values_.cbegin() + pos);
+        RebuildIndex();
+        return true;
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+        index_ = Index<Key>();
+    }
+
+    // Возвращает итератор на первую пару с ключом, не меньшим key
+    Iterator LowerBound(const Key& key) {
+        return Iterator(this, LowerBoundIndex(key));
+    }
+
+    ConstIterator LowerBound(const Key& key) const {
+        return ConstIterator(this, LowerBoundIndex(key));
+    }
+
+    // Возвращает итератор на пару с ключом key или end()
+    Iterator Find(const Key& key) {
+        return Iterator(this, FindIndex(key));
+    }
+
+    ConstIterator Find(const Key& key) const {
+        return ConstIterator(this, FindIndex(key));
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != keys_.GetSize();
+    }
+
+    size_t GetSize() const noexcept {
+        return keys_.GetSize();
+    }
+
+    bool IsEmpty() const noexcept {
+        return keys_.IsEmpty();
+    }
+
+    // Отсортированный массив ключей и соответствующий ему массив значений
+    const SimpleVector<Key>& GetKeys() const noexcept {
+        return keys_;
+    }
+
+    SimpleSpan<Value> GetValues() noexcept {
+        return values_;
+    }
+
+    ConstSimpleSpan<Value> GetValues() const noexcept {
+        return values_;
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(this, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(this, keys_.GetSize());
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(this, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(this, keys_.GetSize());
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    struct KeyOf {
+        const Key& operator()(const ItemType& item) const noexcept {
+            return item.first;
+        }
+    };
+
+    // Итератор произвольного доступа по номеру пары. Разыменование возвращает прокси-ссылку,
+    // поэтому для стандартных алгоритмов это итератор ввода
+    template <bool kConst>
+    class BasicIterator {
+        using Owner = std::conditional_t<kConst, const FlatMap, FlatMap>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ItemType;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, ConstReference, Reference>;
+
+        BasicIterator() noexcept = default;
+
+        // Изменяемый итератор преобразуется в константный
+        template <bool kOtherConst>
+            requires(kConst && !kOtherConst)
+        BasicIterator(const BasicIterator<kOtherConst>& other) noexcept
+            : owner_(other.owner_),
+            index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return reference(owner_->keys_[index_], owner_->values_[index_]);
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend std::strong_ordering operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        friend class FlatMap;
+        friend class BasicIterator<true>;
+
+        BasicIterator(Owner* owner, size_t index) noexcept
+            : owner_(owner),
+            index_(index) {
+        }
+
+        Owner* owner_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    template <typename K, typename V>
+    void InsertAt(size_t pos, K&& key, V&& value) {
+        keys_.Insert(keys_.cbegin() + pos, std::forward<K>(key));
+        try {
+            values_.Insert(values_.cbegin() + pos, std::forward<V>(value));
+        }
+        catch (...) {
+            keys_.Erase(keys_.cbegin() + pos);
+            throw;
+        }
+        RebuildIndex();
+    }
+
+    void RebuildIndex() {
+        index_.Build(ConstSimpleSpan<Key>(keys_), comp_);
+    }
+
+    size_t LowerBoundIndex(const Key& key) const {
+        return index_.LowerBound(ConstSimpleSpan<Key>(keys_), key, comp_);
+    }
+
+    size_t FindIndex(const Key& key) const {
+        const size_t pos = LowerBoundIndex(key);
+        return pos != keys_.GetSize() && !comp_(key, keys_[pos]) ? pos : keys_.GetSize();
+    }
+
+    SimpleVector<Key> keys_;
+    SimpleVector<Value> values_;
+    [[no_unique_address]] Compare comp_ = Compare();
+    Index<Key> index_;
+};
+
+template <typename Key, typename Value, typename Compare, template <typename> class Index>
+bool operator==(const FlatMap<Key, Value, Compare, Index>& lhs, const FlatMap<Key, Value, Compare, Index>& rhs) {
+    return lhs.GetKeys() == rhs.GetKeys() && lhs.GetValues() == rhs.GetValues();
+}
+
+template <typename Key, typename Value, typename Compare, template <typename> class Index>
+bool operator!=(const FlatMap<Key, Value, Compare, Index>& lhs, const FlatMap<Key, Value, Compare, Index>& rhs) {
+    return !(lhs == rhs);
+}
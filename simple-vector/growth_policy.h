@@ -0,0 +1,141 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+
+// Политика роста решает, до какой вместимости расширять вектор, когда места не хватает.
+// Требования к политике GrowthPolicy:
+//     size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const
+//         возвращает новую вместимость, не меньшую required;
+//     void OnReallocate(size_t old_capacity, size_t new_capacity, size_t bytes_moved)
+//         вызывается после каждого перевыделения памяти вектора;
+//     void OnShrink(size_t old_capacity, size_t new_capacity, size_t bytes_reclaimed)
+//         вызывается, когда вектор вернул часть памяти;
+//     static constexpr bool kAutoShrink и
+//     size_t ShrinkCapacity(size_t size, size_t capacity, size_t element_size) const
+//         если kAutoShrink, PopBack и Erase уменьшают вместимость до ShrinkCapacity,
+//         когда она меньше текущей.
+// Политика хранится внутри вектора, поэтому может накапливать статистику.
+// Политики без состояния места в векторе не занимают
+
+// Пустые обработчики событий, от которых наследуются политики без телеметрии
+struct GrowthPolicyBase {
+    static constexpr bool kAutoShrink = false;
+
+    constexpr size_t ShrinkCapacity(size_t /*size*/, size_t capacity, size_t /*element_size*/) const noexcept {
+        return capacity;
+    }
+
+    constexpr void OnReallocate(size_t /*old_capacity*/, size_t /*new_capacity*/, size_t /*bytes_moved*/) noexcept {
+    }
+
+    constexpr void OnShrink(size_t /*old_capacity*/, size_t /*new_capacity*/, size_t /*bytes_reclaimed*/) noexcept {
+    }
+};
+
+// Удвоение вместимости: исходное поведение SimpleVector
+struct DoublingGrowth : GrowthPolicyBase {
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) const noexcept {
+        return std::max(required, capacity * 2);
+    }
+};
+
+// Рост в 1.5 раза: меньше неиспользуемой памяти ценой более частых перевыделений
+struct GoldenGrowth : GrowthPolicyBase {
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) const noexcept {
+        return std::max(required, capacity + capacity / 2);
+    }
+};
+
+// Округляет размер блока в байтах вверх до ближайшего класса размеров аллокатора.
+// Классы повторяют jemalloc/tcmalloc: шаг 16 байт до 128, далее по четыре класса на каждую степень двойки
+constexpr size_t RoundUpToSizeClass(size_t bytes) noexcept {
+    if (bytes <= 128) {
+        return std::max<size_t>(16, (bytes + 15) & ~size_t(15));
+    }
+    const size_t spacing = size_t(1) << (std::bit_width(bytes - 1) - 3);
+    return (bytes + spacing - 1) & ~(spacing - 1);
+}
+
+// Удвоение, при котором блок занимает класс размеров аллокатора целиком:
+// остаток класса, который аллокатор всё равно выделил бы, отдаётся под элементы
+struct SizeClassGrowth : GrowthPolicyBase {
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const noexcept {
+        const size_t target = std::max(required, capacity * 2);
+        return RoundUpToSizeClass(target * element_size) / element_size;
+    }
+};
+
+// Для блоков от kMinBytes байт округляет вместимость Base до целого числа страниц,
+// чтобы крупные буферы не оставляли недоиспользованный хвост последней страницы
+template <typename Base = DoublingGrowth, size_t kPageSize = 4096, size_t kMinBytes = 64 * 1024>
+struct PageGranularGrowth : Base {
+    static_assert((kPageSize & (kPageSize - 1)) == 0, "page size must be a power of two");
+
+    constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) const noexcept {
+        const size_t next = Base::NextCapacity(capacity, required, element_size);
+        const size_t bytes = next * element_size;
+        if (bytes < kMinBytes) {
+            return next;
+        }
+        return ((bytes + kPageSize - 1) & ~(kPageSize - 1)) / element_size;
+    }
+};
+
+// Автоматически возвращает память, когда вектор заполнен меньше чем на 1/kShrinkDivisor.
+// Вместимость уменьшается до удвоенного размера, а не до размера: между порогом
+// сжатия (1/4) и порогом роста (полный вектор) остаётся запас, который не даёт
+// вектору перевыделять память на каждом чередовании PushBack и PopBack.
+// Векторы вместимостью не больше kMinCapacity не сжимаются
+template <typename Base = DoublingGrowth, size_t kShrinkDivisor = 4, size_t kMinCapacity = 16>
+struct AutoShrink : Base {
+    static_assert(kShrinkDivisor > 2, "shrinking to twice the size needs a divisor above 2");
+    static constexpr bool kAutoShrink = true;
+
+    constexpr size_t ShrinkCapacity(size_t size, size_t capacity, size_t /*element_size*/) const noexcept {
+        if (capacity <= kMinCapacity || size >= capacity / kShrinkDivisor) {
+            return capacity;
+        }
+        return std::max(size * 2, kMinCapacity);
+    }
+};
+
+// Статистика перевыделений памяти одного вектора
+struct GrowthStats {
+    size_t reallocations = 0;
+    size_t bytes_moved = 0;
+    size_t peak_capacity = 0;
+    size_t shrinks = 0;
+    size_t bytes_reclaimed = 0;
+};
+
+// Добавляет к политике Base счётчики перевыделений, перенесённых байт, пиковой вместимости
+// и возвращённой памяти.
+// Подключается явно, например SimpleVector<int, std::allocator<int>, TrackedGrowth<>>
+template <typename Base = DoublingGrowth>
+struct TrackedGrowth : Base {
+    constexpr void OnReallocate(size_t old_capacity, size_t new_capacity, size_t bytes_moved) noexcept {
+        Base::OnReallocate(old_capacity, new_capacity, bytes_moved);
+        ++stats_.reallocations;
+        stats_.bytes_moved += bytes_moved;
+        stats_.peak_capacity = std::max(stats_.peak_capacity, new_capacity);
+    }
+
+    constexpr void OnShrink(size_t old_capacity, size_t new_capacity, size_t bytes_reclaimed) noexcept {
+        Base::OnShrink(old_capacity, new_capacity, bytes_reclaimed);
+        ++stats_.shrinks;
+        stats_.bytes_reclaimed += bytes_reclaimed;
+    }
+
+    constexpr const GrowthStats& GetStats() const noexcept {
+        return stats_;
+    }
+
+    constexpr void ResetStats() noexcept {
+        stats_ = GrowthStats{};
+    }
+
+private:
+    GrowthStats stats_;
+};
@@ -1,9 +1,40 @@
+#include "arena_allocator.h"
+#include "bit_vector.h"
+#include "concurrent_vector.h"
+#include "cow_vector.h"
+#include "de_vector.h"
+#include "flat_map.h"
+#include "malloc_allocator.h"
+#include "mapped_vector.h"
+#include "parallel_algorithms.h"
+#include "serialization.h"
+#include "simple_span.h"
 #include "simple_vector.h"
+#include "small_vector.h"
+#include "soa_vector.h"
+#include "static_vector.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <list>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace std;
 
@@ -33,6 +64,40 @@ private:
     size_t x_;
 };
 
+// Считает живые экземпляры и вызовы конструкторов
+class Counted {
+public:
+    explicit Counted(int value)
+        : value_(value) {
+        ++constructed;
+        ++alive;
+    }
+    Counted(const Counted& other)
+        : value_(other.value_) {
+        ++constructed;
+        ++alive;
+    }
+    Counted(Counted&& other) noexcept
+        : value_(other.value_) {
+        ++constructed;
+        ++alive;
+    }
+    Counted& operator=(const Counted&) = default;
+    Counted& operator=(Counted&&) = default;
+    ~Counted() {
+        --alive;
+    }
+    int GetValue() const {
+        return value_;
+    }
+
+    inline static int constructed = 0;
+    inline static int alive = 0;
+
+private:
+    int value_;
+};
+
 SimpleVector<int> GenerateVector(size_t size) {
     SimpleVector<int> v(size);
     iota(v.begin(), v.end(), 1);
@@ -151,6 +216,1958 @@ void TestNoncopiableErase() {
     cout << "Done!" << endl << endl;
 }
 
+void TestNoncopiableEmplace() {
+    const size_t size = 5;
+    cout << "Test noncopiable emplace"s << endl;
+    SimpleVector<X> v;
+    for (size_t i = 0; i < size; ++i) {
+        X& x = v.EmplaceBack(i);
+        assert(x.GetX() == i);
+        assert(&x == &v[i]);
+    }
+    assert(v.EmplaceBack().GetX() == 5);
+
+    auto it = v.Emplace(v.begin(), size + 1);
+    assert(it == v.begin() && it->GetX() == size + 1);
+    it = v.Emplace(v.begin() + 3, size + 2);
+    assert(it == v.begin() + 3 && it->GetX() == size + 2);
+    it = v.Emplace(v.end(), size + 3);
+    assert(it == v.end() - 1 && it->GetX() == size + 3);
+    assert(v.GetSize() == size + 4);
+    assert(v[4].GetX() == 2);
+    cout << "Done!"s << endl << endl;
+}
+
+// Бросает исключение из конструктора, если передан отрицательный аргумент
+struct ThrowOnNegative {
+    ThrowOnNegative(int value)
+        : value(value) {
+        if (value < 0) {
+            throw std::invalid_argument("negative"s);
+        }
+    }
+    int value;
+};
+
+void TestEmplaceStrongGuarantee() {
+    cout << "TestEmplaceStrongGuarantee"s << endl;
+    SimpleVector<ThrowOnNegative> v;
+    v.EmplaceBack(1);
+    v.EmplaceBack(2);
+    assert(v.GetSize() == v.GetCapacity());
+    const auto* old_data = &v[0];
+    try {
+        v.EmplaceBack(-1);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+    }
+    try {
+        v.Emplace(v.begin(), -1);
+        assert(false);
+    }
+    catch (const std::invalid_argument&) {
+    }
+    assert(v.GetSize() == 2 && v.GetCapacity() == 2);
+    assert(&v[0] == old_data);
+    assert(v[0].value == 1 && v[1].value == 2);
+    cout << "Done!"s << endl;
+}
+
+// Владеет ресурсом, но допускает побайтовый перенос
+struct Handle {
+    Handle(int value)
+        : ptr(make_unique<int>(value)) {
+    }
+    unique_ptr<int> ptr;
+};
+
+template <>
+struct IsTriviallyRelocatable<Handle> : std::true_type {
+};
+
+void TestTriviallyRelocatable() {
+    cout << "TestTriviallyRelocatable"s << endl;
+    static_assert(kRelocateByMemmove<int64_t, std::allocator<int64_t>>);
+    static_assert(kRelocateByMemmove<Handle, std::allocator<Handle>>);
+    static_assert(!kRelocateByMemmove<X, std::allocator<X>>);
+    static_assert(ReallocatingAllocator<MallocAllocator<int64_t>>);
+    static_assert(!ReallocatingAllocator<std::allocator<int64_t>>);
+    {
+        SimpleVector<Handle> v;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.Insert(v.begin(), Handle(-1));
+        v.Emplace(v.begin() + 50, -2);
+        v.Erase(v.begin() + 10);
+        assert(v.GetSize() == 101);
+        assert(*v[0].ptr == -1 && *v[1].ptr == 0 && *v[10].ptr == 10);
+        assert(*v[49].ptr == -2 && *v[100].ptr == 99);
+    }
+    {
+        // рост через realloc, а затем через mremap
+        SimpleVector<int64_t, MallocAllocator<int64_t>> v;
+        const int64_t size = 1 << 18;
+        for (int64_t i = 0; i < size; ++i) {
+            v.PushBack(i);
+        }
+        v.Insert(v.begin() + 1, v[size - 1]);
+        v.Erase(v.begin());
+        assert(v.GetSize() == size_t(size));
+        assert(v[0] == size - 1 && v[1] == 1 && v[size - 1] == size - 1);
+
+        SimpleVector<int64_t, MallocAllocator<int64_t>> w;
+        w.PushBack(5);
+        w.PushBack(w[0]);
+        w.Insert(w.begin(), w[1]);
+        assert((w == SimpleVector<int64_t, MallocAllocator<int64_t>>{5, 5, 5}));
+        w.Resize(1 << 20);
+        assert(w[2] == 5 && w[3] == 0 && w[(1 << 20) - 1] == 0);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestSmallVector() {
+    cout << "TestSmallVector"s << endl;
+    {
+        SmallVector<int, 4> v;
+        assert(v.IsInline() && v.GetCapacity() == 4);
+        for (int i = 0; i < 4; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.IsInline());
+        v.PushBack(4);
+        assert(!v.IsInline() && v.GetCapacity() == 8);
+        v.Insert(v.begin(), -1);
+        v.Erase(v.begin() + 2);
+        assert((v == SmallVector<int, 4>{-1, 0, 2, 3, 4}));
+        v.Resize(2);
+        assert((v == SmallVector<int, 4>{-1, 0}));
+        assert((v < SmallVector<int, 4>{-1, 1}));
+    }
+    {
+        SmallVector<X, 2> v;
+        v.PushBack(X(1));
+        v.EmplaceBack(2);
+        SmallVector<X, 2> moved(std::move(v));
+        assert(moved.IsInline() && moved.GetSize() == 2 && moved[1].GetX() == 2);
+        assert(v.IsEmpty());
+        moved.Insert(moved.begin(), X(0));
+        assert(!moved.IsInline());
+        const X* data = &moved[0];
+        SmallVector<X, 2> heap_moved;
+        heap_moved = std::move(moved);
+        assert(&heap_moved[0] == data);
+        assert(moved.IsInline() && moved.IsEmpty());
+        assert(heap_moved[0].GetX() == 0 && heap_moved[2].GetX() == 2);
+    }
+    Counted::alive = 0;
+    {
+        SmallVector<Counted, 3> a;
+        a.EmplaceBack(1);
+        SmallVector<Counted, 3> b;
+        for (int i = 0; i < 5; ++i) {
+            b.EmplaceBack(i);
+        }
+        a.swap(b);
+        assert(a.GetSize() == 5 && b.GetSize() == 1);
+        assert(a[4].GetValue() == 4 && b[0].GetValue() == 1);
+        SmallVector<Counted, 3> c(a);
+        c.Erase(c.begin());
+        assert(Counted::alive == 10);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl;
+}
+
+void TestGrowthPolicy() {
+    cout << "TestGrowthPolicy"s << endl;
+    {
+        SimpleVector<int, std::allocator<int>, TrackedGrowth<>> v;
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack(i);
+        }
+        const GrowthStats& stats = v.GetGrowthPolicy().GetStats();
+        // 1, 2, 4, ..., 128
+        assert(stats.reallocations == 8);
+        assert(stats.peak_capacity == 128);
+        assert(stats.bytes_moved == (1 + 2 + 4 + 8 + 16 + 32 + 64) * sizeof(int));
+        v.Reserve(1000);
+        v.Resize(1001);
+        assert(stats.reallocations == 10 && stats.peak_capacity == 2000);
+    }
+    {
+        using Tracked = SimpleVector<int, std::allocator<int>, TrackedGrowth<>>;
+        // Выделение памяти в конструкторе тоже учитывается
+        Tracked sized(1000);
+        assert(sized.GetGrowthPolicy().GetStats().reallocations == 1);
+        assert(sized.GetGrowthPolicy().GetStats().peak_capacity == 1000);
+        assert(sized.GetGrowthPolicy().GetStats().bytes_moved == 0);
+        const Tracked filled(10, 7);
+        const Tracked listed{1, 2, 3};
+        const Tracked copied(filled);
+        assert(filled.GetGrowthPolicy().GetStats().peak_capacity == 10);
+        assert(listed.GetGrowthPolicy().GetStats().peak_capacity == 3);
+        assert(copied.GetGrowthPolicy().GetStats().peak_capacity == 10);
+        assert(Tracked().GetGrowthPolicy().GetStats().reallocations == 0);
+
+        // Статистика переходит вместе с буфером
+        Tracked moved(std::move(sized));
+        assert(moved.GetGrowthPolicy().GetStats().peak_capacity == 1000);
+        assert(sized.GetGrowthPolicy().GetStats().reallocations == 0);
+        Tracked other(10);
+        other.swap(moved);
+        assert(other.GetCapacity() == 1000 && other.GetGrowthPolicy().GetStats().peak_capacity == 1000);
+        assert(moved.GetCapacity() == 10 && moved.GetGrowthPolicy().GetStats().peak_capacity == 10);
+        moved = std::move(other);
+        assert(moved.GetGrowthPolicy().GetStats().peak_capacity == 1000);
+        moved = filled;
+        assert(moved.GetCapacity() == 10 && moved.GetGrowthPolicy().GetStats().peak_capacity == 10);
+    }
+    {
+        SimpleVector<int, std::allocator<int>, GoldenGrowth> v;
+        v.Resize(10);
+        v.PushBack(0);
+        assert(v.GetCapacity() == 15);
+        v.Insert(v.begin(), 0);
+        assert(v.GetCapacity() == 15);
+    }
+    {
+        assert(RoundUpToSizeClass(1) == 16);
+        assert(RoundUpToSizeClass(100) == 112);
+        assert(RoundUpToSizeClass(129) == 160);
+        assert(RoundUpToSizeClass(257) == 320);
+        assert(RoundUpToSizeClass(4096) == 4096);
+        SimpleVector<std::array<char, 24>, std::allocator<std::array<char, 24>>, SizeClassGrowth> v;
+        v.PushBack({});
+        // 24 байта округляются до класса 32, где помещается один элемент
+        assert(v.GetCapacity() == 1);
+        v.Resize(5);
+        // 120 байт -> класс 128
+        assert(v.GetCapacity() == 5);
+    }
+    {
+        SimpleVector<int64_t, std::allocator<int64_t>, PageGranularGrowth<GoldenGrowth>> v;
+        v.Resize(100000);
+        assert(v.GetCapacity() == 100352);
+        v.Resize(v.GetCapacity());
+        v.PushBack(1);
+        assert(v.GetCapacity() * sizeof(int64_t) % 4096 == 0);
+        assert(v.GetCapacity() >= 100352 + 100352 / 2);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestShrink() {
+    cout << "TestShrink"s << endl;
+    {
+        SimpleVector<int, std::allocator<int>, TrackedGrowth<>> v(100, 7);
+        const size_t reallocations = v.GetGrowthPolicy().GetStats().reallocations;
+        v.Resize(10);
+        v.ShrinkToFit();
+        assert(v.GetSize() == 10 && v.GetCapacity() == 10 && v[9] == 7);
+        assert(v.GetGrowthPolicy().GetStats().bytes_reclaimed == 90 * sizeof(int));
+        // Сжатие считается в shrinks, но не в перевыделениях роста
+        assert(v.GetGrowthPolicy().GetStats().reallocations == reallocations);
+        assert(v.GetGrowthPolicy().GetStats().shrinks == 1);
+
+        v.Reserve(100);
+        assert(v.Reclaim(4) == 90 * sizeof(int));
+        assert(v.GetCapacity() == 10);
+        v.Reserve(30);
+        // заполнен на треть — порог 1/4 не достигнут
+        assert(v.Reclaim(4) == 0);
+        assert(v.GetCapacity() == 30);
+
+        v.Clear();
+        v.ShrinkToFit();
+        assert(v.GetCapacity() == 0 && v.begin() == nullptr);
+        assert(v.GetGrowthPolicy().GetStats().shrinks == 3);
+    }
+    {
+        SimpleVector<int64_t, MallocAllocator<int64_t>> v(1 << 18);
+        v.Resize(3);
+        assert(v.Reclaim() == ((1 << 18) - 3) * sizeof(int64_t));
+        assert(v.GetCapacity() == 3 && v[2] == 0);
+    }
+    {
+        SimpleVector<X, std::allocator<X>, TrackedGrowth<AutoShrink<>>> v;
+        for (size_t i = 0; i < 64; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.GetCapacity() == 64);
+        // 16 элементов — ровно четверть, ещё не сжимается
+        while (v.GetSize() > 16) {
+            v.PopBack();
+        }
+        assert(v.GetCapacity() == 64);
+        const size_t growth_reallocations = v.GetGrowthPolicy().GetStats().reallocations;
+        v.Erase(v.begin());
+        assert(v.GetCapacity() == 30);
+        assert(v.GetGrowthPolicy().GetStats().reallocations == growth_reallocations);
+        assert(v[0].GetX() == 1 && v[14].GetX() == 15);
+
+        // гистерезис: чередование вставки и удаления не перевыделяет память
+        const size_t reallocations = v.GetGrowthPolicy().GetStats().reallocations;
+        for (int i = 0; i < 100; ++i) {
+            v.EmplaceBack(0);
+            v.PopBack();
+        }
+        assert(v.GetGrowthPolicy().GetStats().reallocations == reallocations);
+
+        while (!v.IsEmpty()) {
+            v.PopBack();
+        }
+        assert(v.GetCapacity() == 16);
+        assert(v.GetGrowthPolicy().GetStats().bytes_reclaimed == (64 - 16) * sizeof(X));
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestRangeInsertErase() {
+    cout << "TestRangeInsertErase"s << endl;
+    {
+        // Первое выделение памяти делает конструктор
+        SimpleVector<int, std::allocator<int>, TrackedGrowth<>> v{1, 2, 3};
+        assert(v.GetGrowthPolicy().GetStats().reallocations == 1);
+        v.Insert(v.begin() + 1, 3, 0);
+        assert((v == SimpleVector<int, std::allocator<int>, TrackedGrowth<>>{1, 0, 0, 0, 2, 3}));
+        assert(v.GetGrowthPolicy().GetStats().reallocations == 2);
+
+        const std::list<int> source{7, 8, 9, 10, 11, 12, 13};
+        v.Insert(v.begin(), source.begin(), source.end());
+        assert(v.GetSize() == 13 && v[0] == 7 && v[6] == 13 && v[7] == 1);
+        assert(v.GetGrowthPolicy().GetStats().reallocations == 3);
+
+        auto it = v.Erase(v.begin() + 1, v.begin() + 7);
+        assert(it == v.begin() + 1 && *it == 1);
+        assert((v == SimpleVector<int, std::allocator<int>, TrackedGrowth<>>{7, 1, 0, 0, 0, 2, 3}));
+        assert(v.Erase(v.begin(), v.begin()) == v.begin());
+
+        v.Insert(v.end() - 1, {4, 5});
+        assert(v[5] == 2 && v[6] == 4 && v[7] == 5 && v[8] == 3);
+
+        // вставка копий собственного элемента
+        v.Insert(v.begin(), 2, v[8]);
+        assert(v[0] == 3 && v[1] == 3 && v[2] == 7);
+
+        // добавление самого себя в конец
+        const size_t size = v.GetSize();
+        v.Append(v);
+        assert(v.GetSize() == 2 * size && v[size] == 3 && v[2 * size - 1] == 3);
+    }
+    {
+        // однопроходные итераторы
+        SimpleVector<int> v{1, 5};
+        std::istringstream input("2 3 4");
+        v.Insert(v.begin() + 1, std::istream_iterator<int>(input), std::istream_iterator<int>());
+        assert((v == SimpleVector<int>{1, 2, 3, 4, 5}));
+    }
+    {
+        // вставка без перевыделения для типов с нетривиальным перемещением
+        SimpleVector<std::string> v{"a"s, "b"s, "c"s, "d"s};
+        v.Reserve(20);
+        const std::string* data = &v[0];
+        v.Insert(v.begin() + 1, {"x"s, "y"s});
+        assert((v == SimpleVector<std::string>{"a"s, "x"s, "y"s, "b"s, "c"s, "d"s}));
+        v.Insert(v.begin() + 5, {"1"s, "2"s, "3"s});
+        assert((v == SimpleVector<std::string>{"a"s, "x"s, "y"s, "b"s, "c"s, "1"s, "2"s, "3"s, "d"s}));
+        v.Insert(v.end(), 2, "z"s);
+        assert(&v[0] == data);
+        v.Erase(v.begin(), v.begin() + 8);
+        assert((v == SimpleVector<std::string>{"d"s, "z"s, "z"s}));
+    }
+    {
+        SimpleVector<X> v;
+        SimpleVector<X> source;
+        for (size_t i = 0; i < 4; ++i) {
+            source.EmplaceBack(i);
+        }
+        v.EmplaceBack(42);
+        v.Append(std::move(source));
+        assert(v.GetSize() == 5 && v[0].GetX() == 42 && v[4].GetX() == 3);
+        v.Erase(v.begin() + 1, v.end() - 1);
+        assert(v.GetSize() == 2 && v[1].GetX() == 3);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestEraseIf() {
+    cout << "TestEraseIf"s << endl;
+    {
+        SimpleVector<int> v = GenerateVector(10);
+        assert(v.EraseIf([](int x) { return x % 3 == 0; }) == 3);
+        assert((v == SimpleVector<int>{1, 2, 4, 5, 7, 8, 10}));
+        assert(v.EraseIf([](int) { return false; }) == 0);
+        assert(v.EraseIf([](int) { return true; }) == 7);
+        assert(v.IsEmpty());
+    }
+    {
+        SimpleVector<std::string> v{"a"s, "bb"s, "c"s, "dd"s, "e"s};
+        assert(v.EraseIf([](const std::string& s) { return s.size() == 2; }) == 2);
+        assert((v == SimpleVector<std::string>{"a"s, "c"s, "e"s}));
+    }
+    {
+        SimpleVector<int> v = GenerateVector(10);
+        const std::vector<size_t> indices{0, 3, 4, 9};
+        assert(v.EraseIndices(indices) == 4);
+        assert((v == SimpleVector<int>{2, 3, 6, 7, 8, 9}));
+        assert(v.EraseIndices(std::vector<size_t>{}) == 0);
+        assert(v.GetSize() == 6);
+    }
+    {
+        SimpleVector<X> v;
+        for (size_t i = 0; i < 6; ++i) {
+            v.EmplaceBack(i);
+        }
+        assert(v.EraseIndices(std::vector<size_t>{1, 2, 5}) == 3);
+        assert(v.GetSize() == 3 && v[0].GetX() == 0 && v[1].GetX() == 3 && v[2].GetX() == 4);
+        assert(v.EraseIf([](const X& x) { return x.GetX() == 3; }) == 1);
+        assert(v.GetSize() == 2 && v[1].GetX() == 4);
+    }
+    Counted::alive = 0;
+    {
+        SimpleVector<Counted> v;
+        for (int i = 0; i < 8; ++i) {
+            v.EmplaceBack(i);
+        }
+        v.EraseIndices(std::vector<size_t>{2, 3, 7});
+        assert(Counted::alive == 5 && v[2].GetValue() == 4);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl;
+}
+
+void TestParallelAlgorithms() {
+    cout << "TestParallelAlgorithms"s << endl;
+    // Размеры не кратны блоку, чтобы последний блок был неполным
+    const size_t n = 100003;
+    for (size_t threads : {1, 2, 4}) {
+        ThreadPool pool(threads);
+        assert(pool.GetThreadCount() == threads);
+
+        SimpleVector<int> v(n);
+        iota(v.begin(), v.end(), 0);
+        ParallelForEach(v, [](int& x) { x *= 2; }, pool);
+        assert(v[0] == 0 && v[n - 1] == int(2 * (n - 1)));
+
+        atomic<int64_t> visited = 0;
+        ParallelForEach(v.begin() + 1, v.end(), [&visited](int) { visited.fetch_add(1); }, pool);
+        assert(visited == int64_t(n - 1));
+
+        const SimpleVector<int64_t> squares = ParallelTransform(v, [](int x) { return int64_t(x) * x; }, pool);
+        assert(squares.GetSize() == n && squares[n - 1] == int64_t(v[n - 1]) * v[n - 1]);
+
+        SimpleVector<int> halves(n);
+        assert(ParallelTransform(v.begin(), v.end(), halves.begin(), [](int x) { return x / 2; }, pool) == halves.end());
+        assert(halves[12345] == 12345);
+
+        assert(ParallelReduce(halves, int64_t(0), plus<>{}, pool) == int64_t(n) * (n - 1) / 2);
+        assert(ParallelReduce(halves.begin(), halves.begin(), 7, plus<>{}, pool) == 7);
+        assert(ParallelReduce(halves, 0, [](int a, int b) { return max(a, b); }, pool) == int(n - 1));
+
+        SimpleVector<int64_t> prefix(n, 1);
+        ParallelInclusiveScan(prefix, plus<>{}, pool);
+        assert(prefix[0] == 1 && prefix[n - 1] == int64_t(n));
+        SimpleVector<int> scanned(n);
+        ParallelInclusiveScan(halves.begin(), halves.end(), scanned.begin(), [](int a, int b) { return max(a, b); }, pool);
+        assert(scanned == halves);
+
+        SimpleVector<int> shuffled(n);
+        for (size_t i = 0; i < n; ++i) {
+            shuffled[i] = int((i * 7919) % n);
+        }
+        ParallelSort(shuffled, less<>{}, pool);
+        assert(shuffled == halves);
+        ParallelSort(shuffled, greater<>{}, pool);
+        assert(is_sorted(shuffled.begin(), shuffled.end(), greater<>{}));
+
+        const SimpleVector<int> odd = ParallelFilter(halves, [](int x) { return x % 2 != 0; }, pool);
+        assert(odd.GetSize() == n / 2 && odd[0] == 1 && odd[n / 2 - 1] == int(n - 2));
+        assert(ParallelFilter(halves.begin(), halves.end(), [](int) { return false; }, pool).IsEmpty());
+
+        SimpleVector<string> words(n);
+        for (size_t i = 0; i < n; ++i) {
+            words[i] = to_string(i);
+        }
+        const SimpleVector<string> sevens = ParallelFilter(words, [](const string& s) { return s.back() == '7'; }, pool);
+        assert(sevens.GetSize() == n / 10 && sevens[1] == "17"s);
+
+        // Исключение из любого блока пробрасывается, а созданные элементы разрушаются
+        try {
+            ParallelTransform(words, [n](const string& s) {
+                if (s == to_string(n - 1)) {
+                    throw runtime_error("bad element");
+                }
+                return s + s;
+            }, pool);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+    }
+    {
+        // Исключение из блока вызывающего потока: ParallelFor дожидается задач,
+        // которые ещё делят правые половины диапазона, и только потом выходит
+        ThreadPool pool(2);
+        atomic<size_t> finished = 0;
+        for (int attempt = 0; attempt < 20; ++attempt) {
+            finished = 0;
+            try {
+                parallel_detail::ParallelFor(pool, 64, 1, [&finished](size_t begin, size_t end) {
+                    if (begin == 0) {
+                        throw runtime_error("caller chunk");
+                    }
+                    this_thread::sleep_for(chrono::microseconds(50));
+                    finished.fetch_add(end - begin);
+                });
+                assert(false);
+            }
+            catch (const runtime_error&) {
+            }
+            // После выхода задачи группы больше не выполняются
+            const size_t after_return = finished.load();
+            this_thread::sleep_for(chrono::milliseconds(1));
+            assert(finished.load() == after_return && after_return == 63);
+        }
+    }
+    {
+        // Задача, копия которой бросила исключение, не попадает в группу:
+        // Wait и деструктор группы не ждут её вечно
+        struct ThrowingCopyTask {
+            void operator()() const {
+                runs->fetch_add(1);
+            }
+            ThrowingCopyTask(atomic<int>& runs, int& copies_left)
+                : runs(&runs), copies_left(&copies_left) {
+            }
+            ThrowingCopyTask(const ThrowingCopyTask& other)
+                : runs(other.runs), copies_left(other.copies_left) {
+                if ((*copies_left)-- <= 0) {
+                    throw bad_alloc();
+                }
+            }
+
+            atomic<int>* runs;
+            int* copies_left;
+        };
+        for (size_t threads : {1, 2}) {
+            ThreadPool pool(threads);
+            atomic<int> runs = 0;
+            // Первая копия — в параметр Run, вторая — в замыкание, поставленное в очередь
+            int copies_left = 1;
+            TaskGroup group(pool);
+            const ThrowingCopyTask task(runs, copies_left);
+            try {
+                group.Run(task);
+                assert(false);
+            }
+            catch (const bad_alloc&) {
+            }
+            copies_left = 100;
+            group.Run(task);
+            group.Wait();
+            assert(runs == 1);
+        }
+    }
+    {
+        // Вложенные параллельные вызовы не блокируют пул
+        ThreadPool pool(3);
+        SimpleVector<SimpleVector<int>> rows(8, SimpleVector<int>(5000, 1));
+        ParallelForEach(rows, [&pool](SimpleVector<int>& row) { ParallelInclusiveScan(row, plus<>{}, pool); }, pool);
+        assert(all_of(rows.begin(), rows.end(), [](const SimpleVector<int>& row) { return row[4999] == 5000; }));
+    }
+    cout << "Done!"s << endl;
+}
+
+// Элемент, копия которого бросает исключение, когда кончается лимит копий.
+// Счётчики атомарные: элементы создаются из нескольких потоков
+struct CopyLimited {
+    explicit CopyLimited(int value)
+        : value(value) {
+        ++alive;
+    }
+    CopyLimited(const CopyLimited& other)
+        : value(other.value) {
+        if (copies_left.fetch_sub(1) <= 0) {
+            throw runtime_error("copy limit");
+        }
+        ++alive;
+    }
+    CopyLimited(CopyLimited&& other) noexcept
+        : value(other.value) {
+        ++alive;
+    }
+    CopyLimited& operator=(const CopyLimited&) = default;
+    CopyLimited& operator=(CopyLimited&&) = default;
+    ~CopyLimited() {
+        --alive;
+    }
+
+    int value = 0;
+    inline static atomic<int> copies_left = 0;
+    inline static atomic<int> alive = 0;
+};
+
+void TestParallelResize() {
+    cout << "TestParallelResize"s << endl;
+    const size_t n = 300007;
+    for (size_t threads : {1, 3}) {
+        ThreadPool pool(threads);
+        for (Placement placement : {Placement::kLocal, Placement::kInterleave}) {
+            const SimpleVector<int> zeros = ParallelMakeVector<int>(n, placement, pool);
+            assert(zeros.GetSize() == n && all_of(zeros.begin(), zeros.end(), [](int x) { return x == 0; }));
+            const SimpleVector<double> halves = ParallelMakeVector<double>(n, 0.5, placement, pool);
+            assert(halves.GetSize() == n && halves[0] == 0.5 && halves[n - 1] == 0.5);
+
+            // Рост с перевыделением переносит старые элементы, рост в пределах вместимости — нет
+            SimpleVector<int> v = GenerateVector(1000);
+            ParallelResize(v, n, 7, placement, pool);
+            assert(v.GetSize() == n && v[0] == 1 && v[999] == 1000 && v[1000] == 7 && v[n - 1] == 7);
+            v.Resize(10);
+            const int* data = v.GetData();
+            ParallelResize(v, n, placement, pool);
+            assert(v.GetData() == data && v[9] == 10 && v[10] == 0 && v[n - 1] == 0);
+            ParallelResize(v, 5, placement, pool);
+            assert((v == SimpleVector<int>{1, 2, 3, 4, 5}));
+        }
+
+        // Перевыделение учитывается в статистике политики роста самого вектора
+        SimpleVector<int, std::allocator<int>, TrackedGrowth<>> tracked{1, 2, 3};
+        ParallelResize(tracked, n, Placement::kLocal, pool);
+        const GrowthStats& stats = tracked.GetGrowthPolicy().GetStats();
+        assert(stats.reallocations == 2 && stats.peak_capacity == tracked.GetCapacity());
+        assert(stats.bytes_moved == 3 * sizeof(int));
+
+        // Значение может быть элементом самого вектора
+        SimpleVector<string> words(3, "long string that does not fit into SSO"s);
+        ParallelResize(words, n, words[1], Placement::kLocal, pool);
+        assert(words.GetSize() == n && words[n - 1] == words[0]);
+
+        // Если копия бросает исключение, вектор остаётся прежним, а созданные элементы разрушаются
+        CopyLimited::alive = 0;
+        {
+            SimpleVector<CopyLimited> limited;
+            for (int i = 0; i < 100; ++i) {
+                limited.EmplaceBack(i);
+            }
+            CopyLimited::copies_left = 1000;
+            try {
+                ParallelResize(limited, n, CopyLimited(-1), Placement::kLocal, pool);
+                assert(false);
+            }
+            catch (const runtime_error&) {
+            }
+            assert(limited.GetSize() == 100 && limited[99].value == 99);
+            assert(CopyLimited::alive == 100);
+        }
+        assert(CopyLimited::alive == 0);
+    }
+    cout << "Done!"s << endl;
+}
+
+template <typename Type>
+void CheckSimdKernels(size_t n, uint64_t seed) {
+    SimpleVector<Type> v(n);
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+        v[i] = static_cast<Type>(seed >> 29);
+    }
+    SimpleVector<Type> w(v);
+    using Total = simd::SumType<Type>;
+    const Total expected_sum = accumulate(v.begin(), v.end(), Total{0}, [](Total acc, Type x) {
+        return static_cast<Total>(static_cast<uint64_t>(acc) + static_cast<uint64_t>(static_cast<Total>(x)));
+    });
+    assert(Sum(v) == expected_sum);
+    assert(MinElement(v) == min_element(v.begin(), v.end()));
+    assert(MaxElement(v) == max_element(v.begin(), v.end()));
+    assert(v == w && !(v < w) && v <= w);
+    if (n > 0) {
+        const Type needle = v[n / 2];
+        assert(Find(v, needle) == find(v.begin(), v.end(), needle));
+        assert(Count(v, needle) == size_t(count(v.begin(), v.end(), needle)));
+        assert(Contains(v, needle));
+        // Различие в каждой позиции, в том числе в хвосте после последнего полного регистра
+        for (size_t i = 0; i < n; i += 1 + n / 7) {
+            w[i] = static_cast<Type>(w[i] + 1);
+            assert(v != w && (v < w) == lexicographical_compare(v.begin(), v.end(), w.begin(), w.end()));
+            assert((w < v) == lexicographical_compare(w.begin(), w.end(), v.begin(), v.end()));
+            w[i] = v[i];
+        }
+        w.PopBack();
+        assert(w < v && v != w);
+    }
+}
+
+void TestSimdKernels() {
+    cout << "TestSimdKernels"s << endl;
+    const simd::SimdLevel detected = simd::DetectSimdLevel();
+    for (simd::SimdLevel level : {simd::SimdLevel::kScalar, simd::SimdLevel::kSse2, simd::SimdLevel::kAvx2}) {
+        simd::SetSimdLevel(level);
+        assert(simd::GetSimdLevel() == min(level, detected));
+        for (size_t n : {0, 1, 7, 16, 31, 32, 33, 100, 1000, 4099}) {
+            CheckSimdKernels<int8_t>(n, n + 1);
+            CheckSimdKernels<uint8_t>(n, n + 2);
+            CheckSimdKernels<char>(n, n + 3);
+            CheckSimdKernels<int16_t>(n, n + 4);
+            CheckSimdKernels<uint16_t>(n, n + 5);
+            CheckSimdKernels<int32_t>(n, n + 6);
+            CheckSimdKernels<uint32_t>(n, n + 7);
+            CheckSimdKernels<int64_t>(n, n + 8);
+            CheckSimdKernels<uint64_t>(n, n + 9);
+        }
+        {
+            // Крайние значения: знаковые и беззнаковые числа сравниваются по-разному
+            SimpleVector<uint8_t> bytes(40, 0x7F);
+            bytes[33] = 0x80;
+            assert(*MaxElement(bytes) == 0x80 && MaxElement(bytes) == bytes.begin() + 33);
+            assert(Sum(bytes) == 39u * 0x7F + 0x80);
+            SimpleVector<int64_t> big(9, numeric_limits<int64_t>::max());
+            big[4] = numeric_limits<int64_t>::min();
+            big[7] = -1;
+            assert(*MinElement(big) == numeric_limits<int64_t>::min());
+            assert(MaxElement(big) == big.begin());
+            SimpleVector<uint64_t> ubig(9, 1);
+            ubig[5] = numeric_limits<uint64_t>::max();
+            assert(MaxElement(ubig) == ubig.begin() + 5 && *MinElement(ubig) == 1);
+        }
+        {
+            // Подсчёт единичных битов сверяется с std::popcount по словам
+            SimpleVector<uint64_t> words;
+            uint64_t word = 0x9E3779B97F4A7C15u;
+            size_t expected = 0;
+            for (size_t n = 0; n < 70; ++n) {
+                assert(simd::PopCount(words.GetData(), words.GetSize()) == expected);
+                word = word * 6364136223846793005u + 1442695040888963407u;
+                words.PushBack(n % 9 == 0 ? ~uint64_t(0) : word);
+                expected += static_cast<size_t>(popcount(words[n]));
+            }
+        }
+    }
+    simd::SetSimdLevel(detected);
+    // Для остальных типов работают стандартные алгоритмы
+    const SimpleVector<double> doubles{1.5, -2.0, 0.5};
+    assert(Sum(doubles) == 0.0 && *MinElement(doubles) == -2.0 && !Contains(doubles, 3.0));
+    const SimpleVector<string> strings{"b"s, "a"s, "b"s};
+    assert(Count(strings, "b"s) == 2 && *MaxElement(strings) == "b"s && Find(strings, "a"s) == strings.begin() + 1);
+    cout << "Done!"s << endl;
+}
+
+void TestConcurrentVector() {
+    cout << "TestConcurrentVector"s << endl;
+    {
+        ConcurrentSimpleVector<string> v;
+        assert(v.IsEmpty() && v.GetCapacity() == 0 && v.TryGet(0) == nullptr);
+        const string& first = v.EmplaceBack("first"s);
+        for (int i = 1; i < 1000; ++i) {
+            v.PushBack(to_string(i));
+        }
+        // Элементы не переезжают при росте
+        assert(&first == &v[0] && first == "first"s);
+        assert(v.GetSize() == 1000 && v[999] == "999"s && v.At(500) == "500"s);
+        assert(v.GetCapacity() >= 1000);
+        try {
+            v.At(1000);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        size_t visited = 0;
+        for (const string& s : v.GetSnapshot()) {
+            assert(visited == 0 || s == to_string(visited));
+            ++visited;
+        }
+        assert(visited == 1000);
+    }
+    {
+        // Брошенная из-за исключения ячейка пропускается при обходе
+        ConcurrentSimpleVector<ThrowOnNegative> v;
+        v.EmplaceBack(1);
+        try {
+            v.EmplaceBack(-1);
+            assert(false);
+        }
+        catch (const invalid_argument&) {
+        }
+        v.EmplaceBack(2);
+        assert(v.GetSize() == 3 && v.IsPublished(0) && !v.IsPublished(1) && v.IsPublished(2));
+        int sum = 0;
+        for (const ThrowOnNegative& x : v.GetSnapshot()) {
+            sum += x.value;
+        }
+        assert(sum == 3);
+    }
+    {
+        // Нагрузочный тест: писатели добавляют элементы, пока читатель проверяет опубликованные
+        const int kWriters = 4;
+        const int kPerWriter = 20000;
+        ConcurrentSimpleVector<int64_t> v;
+        atomic<bool> done = false;
+        thread reader([&] {
+            while (!done.load()) {
+                int64_t published = 0;
+                for (const int64_t& x : v.GetSnapshot()) {
+                    assert(x >= 0 && x < int64_t(kWriters) * kPerWriter);
+                    ++published;
+                }
+                assert(published <= int64_t(v.GetSize()));
+            }
+        });
+        vector<thread> writers;
+        vector<const int64_t*> first_refs(kWriters);
+        for (int w = 0; w < kWriters; ++w) {
+            writers.emplace_back([&, w] {
+                first_refs[w] = &v.EmplaceBack(int64_t(w) * kPerWriter);
+                for (int i = 1; i < kPerWriter; ++i) {
+                    v.PushBack(int64_t(w) * kPerWriter + i);
+                }
+            });
+        }
+        for (thread& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        reader.join();
+
+        assert(v.GetSize() == size_t(kWriters) * kPerWriter);
+        vector<bool> seen(v.GetSize());
+        for (size_t i = 0; i < v.GetSize(); ++i) {
+            assert(v.IsPublished(i) && !seen[v[i]]);
+            seen[v[i]] = true;
+        }
+        for (int w = 0; w < kWriters; ++w) {
+            assert(*first_refs[w] == int64_t(w) * kPerWriter);
+        }
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestCowVector() {
+    cout << "TestCowVector"s << endl;
+    {
+        CowSimpleVector<int> a{1, 2, 3};
+        CowSimpleVector<int> b = a;
+        // Копия делит буфер с оригиналом
+        assert(a.IsShared() && b.IsShared());
+        assert(&a.AsVector() == &b.AsVector() && a == b);
+        const CowSimpleVector<int>& const_b = b;
+        assert(const_b[1] == 2 && const_b.At(2) == 3 && b.IsShared());
+
+        // Первое изменение отделяет буфер, оригинал не меняется
+        b.PushBack(4);
+        assert(!a.IsShared() && !b.IsShared());
+        assert(a.GetSize() == 3 && b.GetSize() == 4 && a != b && a < b);
+        assert(a <= b && b > a && b >= a && !(a > b) && !(a >= b) && !(b <= a));
+        assert(a <= a && a >= a && !(a > a));
+        const int* own = &b[0];
+        b[0] = 10;
+        assert(&b[0] == own && a[0] == 1 && b[0] == 10);
+    }
+    {
+        CowSimpleVector<string> a(3, "x"s);
+        CowSimpleVector<string> b = a;
+        CowSimpleVector<string> c = a;
+        // Позиция в разделённом буфере пересчитывается в отделённый
+        b.Insert(b.cbegin() + 1, "y"s);
+        c.Erase(c.cbegin(), c.cbegin() + 2);
+        assert(!a.IsShared() && !b.IsShared() && !c.IsShared());
+        assert(a.GetSize() == 3 && b.GetSize() == 4 && b[1] == "y"s && c.GetSize() == 1);
+
+        CowSimpleVector<string> d = a;
+        d.Resize(5);
+        assert(d.GetSize() == 5 && d[4].empty() && a.GetSize() == 3);
+        CowSimpleVector<string> e = a;
+        e.Reserve(100);
+        assert(e.GetCapacity() >= 100 && e == a && !e.IsShared());
+        // Если удалять нечего, буфер остаётся общим
+        CowSimpleVector<string> f = a;
+        assert(f.EraseIf([](const string& s) { return s.empty(); }) == 0 && f.IsShared());
+        assert(f.EraseIf([](const string& s) { return s == "x"s; }) == 3 && f.IsEmpty());
+        f = a;
+        f.Clear();
+        assert(f.IsEmpty() && a.GetSize() == 3);
+        for (string& s : f = a) {
+            s += "!"s;
+        }
+        assert(f[0] == "x!"s && a[0] == "x"s);
+    }
+    {
+        CowSimpleVector<int> empty;
+        CowSimpleVector<int> copy = empty;
+        assert(copy.IsEmpty() && copy.begin() == copy.end() && !copy.IsShared());
+        copy.PushBack(1);
+        assert(empty.IsEmpty() && copy.GetSize() == 1);
+        CowSimpleVector<int> moved = std::move(copy);
+        assert(copy.IsEmpty() && moved.GetSize() == 1);
+    }
+    {
+        // Выданная изменяемая ссылка не видна через копию, сделанную после неё
+        CowSimpleVector<int> a{1, 2, 3};
+        int& r = a[0];
+        CowSimpleVector<int> snap = a;
+        assert(!a.IsShared() && !snap.IsShared());
+        r = 42;
+        assert(a[0] == 42 && as_const(snap)[0] == 1);
+        CowSimpleVector<int> assigned;
+        assigned = a;
+        *a.begin() = 7;
+        assert(as_const(assigned)[0] == 42);
+        // После Clear буфер снова можно делить
+        a.Clear();
+        a.PushBack(5);
+        CowSimpleVector<int> shared = a;
+        assert(a.IsShared() && as_const(shared)[0] == 5);
+    }
+    {
+        // Копии отделяются в разных потоках, пока оригинал только читают
+        CowSimpleVector<int64_t> source(SimpleVector<int64_t>(1000, 7));
+        vector<thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([copy = source, t]() mutable {
+                for (int i = 0; i < 100; ++i) {
+                    CowSimpleVector<int64_t> snapshot = copy;
+                    snapshot[0] = t;
+                    assert(snapshot[0] == t && as_const(copy)[0] == 7);
+                }
+            });
+        }
+        for (thread& t : threads) {
+            t.join();
+        }
+        assert(source.GetSize() == 1000 && source[0] == 7 && !source.IsShared());
+    }
+    cout << "Done!"s << endl;
+}
+
+// Запись файла фиксированного размера
+struct Record {
+    int64_t id;
+    double value;
+};
+
+void TestMappedVector() {
+    cout << "TestMappedVector"s << endl;
+    const string path = (filesystem::temp_directory_path() / "simple_vector_mapped_test.bin"s).string();
+    filesystem::remove(path);
+    {
+        MappedSimpleVector<Record> v(path);
+        assert(v.IsEmpty() && !v.IsReadOnly() && v.GetCapacity() > 0);
+        for (int64_t i = 0; i < 10000; ++i) {
+            v.PushBack({i, i * 0.5});
+        }
+        // Элемент самого вектора при росте
+        v.PushBack(v[0]);
+        assert(v.GetSize() == 10001 && v[10000].id == 0 && v[9999].value == 9999 * 0.5);
+        v.PopBack();
+        v.Reserve(50000);
+        assert(v.GetCapacity() >= 50000);
+        v.Resize(10010, {-1, 0});
+        assert(v.GetSize() == 10010 && v[10009].id == -1);
+        v.Resize(10000);
+        v.ShrinkToFit();
+        assert(v.GetCapacity() >= 10000 && v.GetCapacity() < 50000);
+        // Вместимость — это всё место в файле после заголовка
+        const size_t data_bytes = filesystem::file_size(path) - MappedSimpleVector<Record>::kHeaderBytes;
+        assert(v.GetCapacity() == data_bytes / sizeof(Record));
+        v.Flush();
+    }
+    {
+        // Данные переживают закрытие файла
+        MappedSimpleVector<Record> v(path);
+        assert(v.GetSize() == 10000);
+        int64_t expected = 0;
+        for (const Record& r : v) {
+            assert(r.id == expected && r.value == expected * 0.5);
+            ++expected;
+        }
+        v[0].value = 42;
+        MappedSimpleVector<Record> moved = std::move(v);
+        assert(moved.GetSize() == 10000 && v.GetSize() == 0);
+    }
+    {
+        MappedSimpleVector<Record> v(path, MapMode::kReadOnly);
+        assert(v.IsReadOnly() && v.GetSize() == 10000 && as_const(v)[0].value == 42 && v.At(9999).id == 9999);
+        try {
+            v.PushBack({});
+            assert(false);
+        }
+        catch (const logic_error&) {
+        }
+    }
+    {
+        // Файл с элементами другого размера и отсутствующий файл
+        try {
+            MappedSimpleVector<int32_t> v(path);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        filesystem::remove(path);
+        try {
+            MappedSimpleVector<Record> v(path, MapMode::kReadOnly);
+            assert(false);
+        }
+        catch (const system_error&) {
+        }
+    }
+    cout << "Done!"s << endl;
+}
+
+// Поток без перемотки, как у канала: tellg и seekg не работают
+class UnseekableBuffer : public streambuf {
+public:
+    explicit UnseekableBuffer(const string& data)
+        : data_(data) {
+        setg(data_.data(), data_.data(), data_.data() + data_.size());
+    }
+
+private:
+    string data_;
+};
+
+void TestSerialization() {
+    cout << "TestSerialization"s << endl;
+    // Контрольное значение CRC32C для "123456789" и совпадение обеих реализаций
+    string text(1000, 0);
+    iota(text.begin(), text.end(), 'a');
+    SimpleVector<uint32_t> text_crcs;
+    for (simd::SimdLevel level : {simd::DetectSimdLevel(), simd::SimdLevel::kScalar}) {
+        simd::SetSimdLevel(level);
+        assert(ComputeCrc32c("123456789", 9) == 0xe3069283);
+        Crc32c parts;
+        parts.Update("1234", 4);
+        parts.Update("56789", 5);
+        assert(parts.Get() == 0xe3069283);
+        text_crcs.PushBack(ComputeCrc32c(text.data() + 3, text.size() - 3));
+    }
+    assert(text_crcs[0] == text_crcs[1]);
+    simd::SetSimdLevel(simd::DetectSimdLevel());
+
+    SimpleVector<Record> records;
+    for (int64_t i = 0; i < 1000; ++i) {
+        records.PushBack({i, i * 0.25});
+    }
+    auto same = [](const auto& lhs, const auto& rhs) {
+        return lhs.GetSize() == rhs.GetSize()
+            && equal(lhs.begin(), lhs.end(), rhs.begin(), [](const Record& a, const Record& b) {
+                   return a.id == b.id && a.value == b.value;
+               });
+    };
+    {
+        stringstream stream;
+        Serialize(stream, records);
+        assert(stream.str().size() == kSerializedHeaderBytes + records.GetSize() * sizeof(Record));
+        const SimpleVector<Record> copy = Deserialize<Record>(stream);
+        assert(same(copy, records));
+
+        // Представление поверх выровненного буфера
+        const string bytes = stream.str();
+        auto buffer = make_unique<Record[]>(bytes.size() / sizeof(Record));
+        memcpy(buffer.get(), bytes.data(), bytes.size());
+        const SerializedView<Record> view(buffer.get(), bytes.size());
+        assert(same(view, records) && view.At(999).id == 999);
+        assert(same(view.ToVector(), records));
+
+        // Повреждённые данные, обрезанный буфер и чужой тип элементов
+        reinterpret_cast<char*>(buffer.get())[bytes.size() - 1] ^= 1;
+        try {
+            SerializedView<Record> broken(buffer.get(), bytes.size());
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+        SerializedView<Record> unchecked(buffer.get(), bytes.size(), false);
+        assert(unchecked.GetSize() == 1000);
+        for (size_t truncated : {size_t(10), bytes.size() - 1}) {
+            try {
+                SerializedView<Record> broken(buffer.get(), truncated, false);
+                assert(false);
+            }
+            catch (const runtime_error&) {
+            }
+        }
+        try {
+            stringstream other(bytes);
+            Deserialize<int64_t>(other);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+    }
+    {
+        stringstream stream;
+        Serialize(stream, SimpleVector<int>());
+        assert(Deserialize<int>(stream).IsEmpty());
+        stringstream again(stream.str());
+        SerializedReader<int> reader(again);
+        SimpleVector<int> chunk;
+        assert(reader.Read(chunk, 10) == 0 && reader.Read(chunk, 10) == 0);
+
+        // Контрольная сумма пустого вектора тоже проверяется при первом чтении
+        string bytes = stream.str();
+        bytes[offsetof(SerializedHeader, checksum)] ^= 1;
+        stringstream corrupted(bytes);
+        SerializedReader<int> broken(corrupted);
+        try {
+            broken.Read(chunk, 10);
+            assert(false);
+        }
+        catch (const runtime_error&) {
+        }
+    }
+    {
+        // Заголовок с огромным числом элементов не приводит к выделению памяти под них:
+        // перематываемый поток сверяется с длиной, остальные читаются частями
+        SimpleVector<int64_t> big(300000);
+        iota(big.begin(), big.end(), 0);
+        stringstream stream;
+        Serialize(stream, big);
+        string bytes = stream.str();
+        const uint64_t huge = uint64_t(1) << 58;
+        memcpy(bytes.data() + offsetof(SerializedHeader, count), &huge, sizeof(huge));
+        {
+            stringstream seekable(bytes);
+            try {
+                Deserialize<int64_t>(seekable);
+                assert(false);
+            }
+            catch (const runtime_error&) {
+            }
+        }
+        {
+            UnseekableBuffer buffer(bytes);
+            istream pipe(&buffer);
+            try {
+                Deserialize<int64_t>(pipe);
+                assert(false);
+            }
+            catch (const runtime_error&) {
+            }
+        }
+        // Целый вектор из неперематываемого потока читается за несколько частей
+        const string whole = stream.str();
+        UnseekableBuffer buffer(whole);
+        istream pipe(&buffer);
+        assert(Deserialize<int64_t>(pipe) == big);
+    }
+    {
+        // Потоковая запись и чтение частями
+        const string path = (filesystem::temp_directory_path() / "simple_vector_serialized_test.bin"s).string();
+        {
+            ofstream out(path, ios::binary);
+            SerializedWriter<Record> writer(out);
+            writer.Write(records.GetData(), 300);
+            SimpleVector<Record> rest;
+            rest.Insert(rest.end(), records.begin() + 300, records.end());
+            writer.Write(rest);
+            writer.Finish();
+            assert(writer.GetSize() == 1000);
+        }
+        {
+            ifstream in(path, ios::binary);
+            SerializedReader<Record> reader(in);
+            assert(reader.GetSize() == 1000);
+            SimpleVector<Record> all;
+            SimpleVector<Record> chunk;
+            while (reader.Read(chunk, 128) != 0) {
+                all.Append(chunk);
+            }
+            assert(same(all, records) && reader.GetRemaining() == 0);
+        }
+        {
+            const SerializedFile<Record> file(path);
+            assert(same(file.GetView(), records));
+        }
+        filesystem::remove(path);
+    }
+    cout << "Done!"s << endl;
+}
+
+// Принимает любой непрерывный диапазон только для чтения
+int64_t SumOfSpan(ConstSimpleSpan<int> s) {
+    return Sum(s);
+}
+
+void TestSimpleSpan() {
+    cout << "TestSimpleSpan"s << endl;
+    SimpleVector<int> v(100);
+    iota(v.begin(), v.end(), 0);
+    {
+        // Вектор неявно преобразуется в представление, срезы не копируют элементы
+        SimpleSpan<int> all = v;
+        assert(all.GetSize() == 100 && all.begin() == v.GetData());
+        assert(SumOfSpan(v) == 4950 && SumOfSpan(all.First(10)) == 45);
+        const ConstSimpleSpan<int> middle = all.Subspan(10, 20);
+        assert(middle.GetSize() == 20 && middle[0] == 10 && middle.At(19) == 29 && &middle[0] == &v[10]);
+        assert(all.Last(5)[0] == 95 && all.Subspan(98).GetSize() == 2 && all.Subspan(100).IsEmpty());
+        try {
+            middle.At(20);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        // Запись через изменяемое представление видна в векторе
+        all.First(3)[2] = -2;
+        assert(v[2] == -2);
+        v[2] = 2;
+    }
+    {
+        // Сравнения и ядра simd.h
+        const SimpleVector<int> w(v);
+        const SimpleSpan<int> all = v;
+        assert(all == ConstSimpleSpan<int>(w) && !(all != ConstSimpleSpan<int>(w)));
+        assert(all.First(50) < all && all.Last(50) > all.First(50) && all.First(50) <= all.First(50));
+        assert(all.Last(1) >= all.First(99));
+        assert(*Find(all, 42) == 42 && Find(all.First(10), 42) == all.First(10).end());
+        assert(Count(all.Subspan(40, 20), 45) == 1 && Contains(all, 99) && !Contains(all.First(99), 99));
+        assert(*MinElement(all.Last(10)) == 90 && *MaxElement(all.First(10)) == 9);
+        assert(MinElement(all.First(0)) == all.begin());
+
+        SimpleVector<string> words{"a"s, "b"s, "c"s};
+        const ConstSimpleSpan<string> word_span = words;
+        assert(*Find(word_span, "b"s) == "b"s && Sum(word_span) == "abc"s && word_span.Last(2) > word_span);
+    }
+    {
+        // Параллельные алгоритмы над срезами
+        SimpleSpan<int> half = SimpleSpan<int>(v).Subspan(50);
+        ParallelSort(half, greater<>());
+        assert(v[50] == 99 && v[99] == 50 && v[49] == 49);
+        ParallelForEach(half, [](int& x) { x = -x; });
+        assert(ParallelReduce(ConstSimpleSpan<int>(v).First(50), int64_t(0)) == 1225);
+        const SimpleVector<int> doubled = ParallelTransform(ConstSimpleSpan<int>(v).First(10), [](int x) { return 2 * x; });
+        assert(doubled.GetSize() == 10 && doubled[9] == 18);
+        const SimpleVector<int> negative = ParallelFilter(ConstSimpleSpan<int>(v), [](int x) { return x < 0; });
+        assert(negative.GetSize() == 50 && negative[0] == -99);
+        ParallelInclusiveScan(SimpleSpan<int>(v).First(5));
+        assert(v[4] == 10 && v[5] == 5);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestSoaVector() {
+    cout << "TestSoaVector"s << endl;
+    {
+        SoaVector<int, string, double> v;
+        assert(v.IsEmpty() && v.GetCapacity() == 0);
+        for (int i = 0; i < 100; ++i) {
+            v.PushBack({i, to_string(i), i * 0.5});
+        }
+        v.EmplaceBack(100, "hundred"s, 50.0);
+        assert(v.GetSize() == 101 && v.GetCapacity() >= 101);
+
+        // Столбцы лежат отдельно и непрерывно
+        SimpleSpan<int> ids = v.Column<0>();
+        assert(ids.GetSize() == 101 && ids[42] == 42 && &ids[1] == &ids[0] + 1);
+        assert(Sum(v.Column<0>()) == 5050 && v.Column<1>()[100] == "hundred"s);
+
+        // Прокси-ссылка изменяет запись на месте
+        auto [id, name, value] = v[10];
+        name = "ten"s;
+        value = -1;
+        assert(id == 10 && get<1>(v.At(10)) == "ten"s && v.Column<2>()[10] == -1);
+        try {
+            v.At(101);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+
+        int expected = 0;
+        for (auto [i, s, d] : v) {
+            assert(i == expected++);
+            d += 1;
+        }
+        assert(expected == 101 && v.Column<2>()[0] == 1);
+
+        // Запись, ссылающаяся на поля этого же вектора, в момент роста
+        v.Reserve(v.GetSize());
+        const auto& [first_id, first_name, first_value] = as_const(v)[0];
+        v.EmplaceBack(first_id, first_name, first_value);
+        assert(get<1>(v[101]) == "0"s);
+        v.PopBack();
+
+        auto it = v.Insert(v.begin() + 1, {-5, "inserted"s, 0.0});
+        assert(it.GetIndex() == 1 && get<0>(*it) == -5 && get<0>(v[2]) == 1 && v.GetSize() == 102);
+        it = v.Erase(v.begin() + 1);
+        assert(get<0>(*it) == 1 && v.GetSize() == 101);
+        v.Erase(v.begin(), v.begin() + 50);
+        assert(v.GetSize() == 51 && get<0>(v[0]) == 50 && get<1>(v[50]) == "hundred"s);
+
+        SoaVector<int, string, double> copy = v;
+        assert(copy == v);
+        get<1>(copy[0]) = "changed"s;
+        assert(copy != v);
+        SoaVector<int, string, double> moved = std::move(copy);
+        assert(copy.IsEmpty() && moved.GetSize() == 51);
+
+        v.Resize(60);
+        assert(v.GetSize() == 60 && get<0>(v[59]) == 0 && get<1>(v[59]).empty());
+        v.Resize(2);
+        assert(v.GetSize() == 2);
+        v.Clear();
+        assert(v.IsEmpty());
+    }
+    {
+        // Общая вместимость растёт по политике роста, политика видит размер всей записи
+        BasicSoaVector<TrackedGrowth<>, int32_t, int64_t> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.EmplaceBack(i, int64_t(i) * 2);
+        }
+        assert(v.GetGrowthPolicy().GetStats().reallocations == 11);
+        assert(v.GetGrowthPolicy().GetStats().peak_capacity == 1024);
+        const SoaVector<int, double> init{{1, 1.5}, {2, 2.5}};
+        assert(init.GetSize() == 2 && init.Column<1>()[1] == 2.5);
+    }
+    {
+        // Если конструктор поля бросит исключение, вектор не меняется
+        SoaVector<int, ThrowOnNegative> v;
+        v.EmplaceBack(1, 1);
+        try {
+            v.EmplaceBack(2, -1);
+            assert(false);
+        }
+        catch (const invalid_argument&) {
+        }
+        assert(v.GetSize() == 1 && get<1>(v[0]).value == 1);
+    }
+    cout << "Done!"s << endl;
+}
+
+// Медленный путь роста получает маленькие тривиально копируемые элементы копией,
+// остальные — ссылками на аргументы. Оба варианта должны переживать аргумент
+// из самого вектора и конструирование из нескольких аргументов
+void TestGrowthSlowPath() {
+    cout << "TestGrowthSlowPath"s << endl;
+    {
+        SimpleVector<int> v{1, 2};
+        assert(v.GetSize() == v.GetCapacity());
+        v.PushBack(v[0]);
+        assert((v == SimpleVector<int>{1, 2, 1}));
+        v.Resize(v.GetCapacity());
+        v.Insert(v.begin() + 1, v[2]);
+        assert(v[0] == 1 && v[1] == 1 && v[2] == 2);
+        v.Resize(v.GetCapacity());
+        assert(v.EmplaceBack(7) == 7 && v.GetSize() == 9);
+    }
+    {
+        SimpleVector<Record> v;
+        for (int64_t i = 0; i < 100; ++i) {
+            const Record& added = v.EmplaceBack(i, i * 0.5);
+            assert(added.id == i && &added == &v[v.GetSize() - 1]);
+        }
+        v.Resize(v.GetCapacity());
+        v.Emplace(v.begin(), int64_t{-1}, 1.5);
+        assert(v[0].id == -1 && v[0].value == 1.5 && v[1].id == 0 && v[100].id == 99);
+    }
+    {
+        SimpleVector<string> v{"long string that does not fit into SSO"s};
+        v.PushBack(v[0]);
+        v.Insert(v.begin(), v[1]);
+        assert(v.GetSize() == 3 && v[0] == v[2] && v[2] == "long string that does not fit into SSO"s);
+        v.Resize(v.GetCapacity());
+        assert(v.EmplaceBack(3, 'x') == "xxx"s);
+    }
+    cout << "Done!"s << endl;
+}
+
+// Вектор, построенный и изменённый на этапе компиляции
+constexpr SimpleVector<int> MakeConstexprVector() {
+    SimpleVector<int> v{5, 1, 4};
+    v.PushBack(2);
+    v.Insert(v.begin() + 1, 3);
+    v.Erase(v.begin());
+    v.Resize(6);
+    v.EraseIf([](int x) {
+        return x == 0;
+    });
+    return v;
+}
+
+constexpr bool CheckConstexprSimpleVector() {
+    const SimpleVector<int> v = MakeConstexprVector();
+    SimpleVector<int> copy = v;
+    copy.PopBack();
+    SimpleVector<int> repeated{1, 2};
+    repeated.Insert(repeated.begin() + 1, 3, 7);
+    SimpleVector<string> strings{"b"s, "c"s};
+    strings.Insert(strings.begin(), strings[1]);
+    strings.Emplace(strings.begin() + 1, 2, 'x');
+    strings.Erase(strings.begin() + 2);
+    strings.Insert(strings.end(), 2, "y"s);
+    return v == SimpleVector<int>{3, 1, 4, 2} && copy < v && Contains(v, 4) && Count(v, 1) == 1
+        && *MaxElement(v) == 4 && Sum(v) == 10 && repeated == SimpleVector<int>{1, 7, 7, 7, 2}
+        && strings == SimpleVector<string>{"c"s, "xx"s, "c"s, "y"s, "y"s};
+}
+
+// Таблица квадратов, вычисленная на этапе компиляции и хранящаяся без кучи
+constexpr StaticVector<int, 16> MakeSquares() {
+    StaticVector<int, 16> squares;
+    for (int i = 0; i < 16; ++i) {
+        squares.PushBack(i * i);
+    }
+    return squares;
+}
+
+void TestConstexprSimpleVector() {
+    cout << "TestConstexprSimpleVector"s << endl;
+    static_assert(CheckConstexprSimpleVector());
+    static_assert(MakeConstexprVector().GetSize() == 4);
+    // Результат вычисления на этапе компиляции копируется в StaticVector
+    constexpr StaticVector<int, 4> kCopied = [] {
+        const SimpleVector<int> v = MakeConstexprVector();
+        StaticVector<int, 4> result;
+        result.Insert(result.end(), v.begin(), v.end());
+        return result;
+    }();
+    static_assert(kCopied.GetSize() == 4 && kCopied[0] == 3 && kCopied[3] == 2);
+    // Те же функции работают и во время выполнения
+    assert(CheckConstexprSimpleVector());
+    assert((MakeConstexprVector() == SimpleVector<int>{3, 1, 4, 2}));
+    cout << "Done!"s << endl;
+}
+
+void TestStaticVector() {
+    cout << "TestStaticVector"s << endl;
+    {
+        constexpr StaticVector<int, 16> kSquares = MakeSquares();
+        static_assert(kSquares.IsFull() && kSquares[15] == 225);
+        static_assert(sizeof(StaticVector<int, 4>) == 4 * sizeof(int) + sizeof(size_t));
+        static_assert(is_trivially_destructible_v<StaticVector<int, 4>>);
+        static_assert(!is_trivially_destructible_v<StaticVector<string, 4>>);
+        const SimpleSpan<const int> squares = ConstSimpleSpan<int>(kSquares);
+        assert(squares.GetSize() == 16 && Sum(squares) == 1240);
+    }
+    {
+        StaticVector<int, 8> v{1, 2, 3};
+        assert((v.GetSize() == 3 && v.GetCapacity() == 8 && StaticVector<int, 8>::kCapacity == 8));
+        v.Insert(v.begin(), v[2]);
+        v.Insert(v.begin() + 2, 2, 7);
+        assert((v == StaticVector<int, 8>{3, 1, 7, 7, 2, 3}));
+        assert(v.Erase(v.begin() + 1, v.begin() + 3) == v.begin() + 1);
+        assert(v.EraseIf([](int x) {
+                   return x == 3;
+               }) == 2);
+        assert((v == StaticVector<int, 8>{7, 2}));
+        v.Resize(5);
+        assert(v[4] == 0);
+        v.PopBack();
+        assert(v.GetSize() == 4);
+        try {
+            v.At(4);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+    }
+    {
+        // Нетривиальный тип: элементы создаются и разрушаются поштучно
+        StaticVector<string, 4> a{"long string that does not fit into SSO"s, "b"s};
+        StaticVector<string, 4> b{"c"s};
+        StaticVector<string, 4> copy = a;
+        a.swap(b);
+        assert((a == StaticVector<string, 4>{"c"s}) && b == copy);
+        a.Emplace(a.begin(), 3, 'x');
+        assert(a[0] == "xxx"s && a[1] == "c"s);
+        StaticVector<string, 4> moved = move(b);
+        assert(b.IsEmpty() && moved == copy);
+        b = moved;
+        assert(b == moved && b < a);
+        a = move(moved);
+        assert(moved.IsEmpty() && a == copy);
+    }
+    {
+        StaticVector<X, 4> v;
+        v.EmplaceBack(1);
+        v.Insert(v.begin(), X(2));
+        assert(v.GetSize() == 2 && v[0].GetX() == 2 && v[1].GetX() == 1);
+    }
+    cout << "Done!"s << endl;
+}
+
+void TestDeVector() {
+    cout << "TestDeVector"s << endl;
+    static_assert(random_access_iterator<DeVector<int>::Iterator>);
+    static_assert(random_access_iterator<DeVector<int>::ConstIterator>);
+    {
+        // Кольцо переходит через конец буфера, но индексы остаются логическими
+        DeVector<int> v;
+        for (int i = 0; i < 6; ++i) {
+            v.PushBack(i);
+        }
+        assert(v.GetCapacity() == 8);
+        v.PopFront();
+        v.PopFront();
+        v.PushFront(-1);
+        v.PushBack(6);
+        v.PushBack(7);
+        v.PushBack(8);
+        assert(v.GetSize() == 8 && v.GetCapacity() == 8 && !v.IsLinear());
+        assert((v == DeVector<int>{-1, 2, 3, 4, 5, 6, 7, 8}));
+        assert(v.Front() == -1 && v.Back() == 8 && v.At(3) == 4);
+        const auto [first, second] = v.GetSegments();
+        assert(first.GetSize() + second.GetSize() == 8 && second.GetSize() != 0);
+        // Полный буфер поворачивается на месте
+        const SimpleSpan<int> linear = v.Linearize();
+        assert(v.IsLinear() && v.GetCapacity() == 8);
+        assert((linear == ConstSimpleSpan<int>(SimpleVector<int>{-1, 2, 3, 4, 5, 6, 7, 8})));
+        v.PushFront(-2);
+        assert(v.GetCapacity() == 16 && v[0] == -2 && v[8] == 8);
+        try {
+            v.At(9);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+    }
+    {
+        // Неполный буфер при переходе через конец переносится в новый
+        DeVector<string> v;
+        v.Reserve(4);
+        v.PushBack("b"s);
+        v.PushBack("c"s);
+        v.PushFront("a"s);
+        assert(!v.IsLinear());
+        const SimpleSpan<string> linear = v.Linearize();
+        assert(linear.GetSize() == 3 && linear[0] == "a"s && linear[2] == "c"s && v.GetCapacity() == 4);
+    }
+    {
+        // Случайные операции сверяются с std::deque
+        DeVector<int> v;
+        deque<int> reference;
+        uint32_t state = 12345;
+        auto next = [&state] {
+            state = state * 1664525u + 1013904223u;
+            return state >> 8;
+        };
+        for (int step = 0; step < 20000; ++step) {
+            const uint32_t op = next() % 8;
+            const int value = static_cast<int>(next() % 1000);
+            if (op == 0 || reference.empty()) {
+                v.PushBack(value);
+                reference.push_back(value);
+            }
+            else if (op == 1) {
+                v.PushFront(value);
+                reference.push_front(value);
+            }
+            else if (op == 2) {
+                v.PopBack();
+                reference.pop_back();
+            }
+            else if (op == 3) {
+                v.PopFront();
+                reference.pop_front();
+            }
+            else if (op == 4) {
+                const size_t pos = next() % (reference.size() + 1);
+                assert(*v.Insert(v.begin() + pos, value) == value);
+                reference.insert(reference.begin() + pos, value);
+            }
+            else if (op == 5) {
+                const size_t pos = next() % reference.size();
+                v.Erase(v.begin() + pos);
+                reference.erase(reference.begin() + pos);
+            }
+            else if (op == 6) {
+                const size_t pos = next() % reference.size();
+                const size_t count = next() % (reference.size() - pos + 1);
+                v.Erase(v.begin() + pos, v.begin() + pos + count);
+                reference.erase(reference.begin() + pos, reference.begin() + pos + count);
+            }
+            else if (step % 64 == 7) {
+                v.Linearize();
+            }
+            assert(v.GetSize() == reference.size());
+        }
+        assert(equal(v.begin(), v.end(), reference.begin(), reference.end()));
+        sort(v.begin(), v.end());
+        assert(is_sorted(v.cbegin(), v.cend()));
+    }
+    {
+        // Аргумент вставки может ссылаться на сдвигаемый элемент
+        DeVector<string> v{"long string that does not fit into SSO"s, "b"s, "c"s, "d"s};
+        v.Insert(v.begin() + 1, v[0]);
+        v.Insert(v.begin() + 4, v[4]);
+        assert((v == DeVector<string>{v[0], v[0], "b"s, "c"s, "d"s, "d"s}));
+        v.Emplace(v.begin() + 2, 3, 'x');
+        assert(v[2] == "xxx"s && v.GetSize() == 7);
+        DeVector<string> copy = v;
+        DeVector<string> moved = move(v);
+        assert(v.IsEmpty() && moved == copy);
+        v = copy;
+        v.PopBack();
+        assert(v < copy && v != copy);
+        v.swap(copy);
+        assert(copy.GetSize() == 6 && v.GetSize() == 7);
+    }
+    {
+        // Некопируемые элементы переносятся при росте перемещением
+        DeVector<X> v;
+        for (size_t i = 0; i < 10; ++i) {
+            v.PushFront(X(i));
+        }
+        v.Insert(v.begin() + 5, X(100));
+        assert(v.GetSize() == 11 && v[0].GetX() == 9 && v[5].GetX() == 100 && v[10].GetX() == 0);
+        v.Resize(3);
+        assert(v.GetSize() == 3 && v[2].GetX() == 7);
+    }
+    cout << "Done!"s << endl;
+}
+
+// Индекс должен давать тот же ответ, что std::lower_bound, на деревьях любой формы
+template <template <typename> class Index>
+void CheckSearchIndex() {
+    // Размеры до 70 перебираются подряд, дальше — с шагом: у BTreeIndex появляются
+    // второй и третий уровни с неполными последними блоками
+    for (size_t n = 0; n < 600; n += (n < 70 ? 1 : 37)) {
+        SimpleVector<int> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = int(3 * i);
+        }
+        Index<int> index;
+        index.Build(ConstSimpleSpan<int>(keys), less<int>{});
+        for (int key = -2; key <= int(3 * n + 1); ++key) {
+            const size_t expected = size_t(lower_bound(keys.begin(), keys.end(), key) - keys.begin());
+            assert(index.LowerBound(ConstSimpleSpan<int>(keys), key, less<int>{}) == expected);
+        }
+    }
+}
+
+template <template <typename> class Index>
+void CheckFlatContainers() {
+    CheckSearchIndex<Index>();
+    {
+        FlatSet<int, less<int>, Index> set{5, 1, 4, 1, 3};
+        assert(set.GetSize() == 4 && (set.GetKeys() == SimpleVector<int>{1, 3, 4, 5}));
+        assert(set.Contains(4) && !set.Contains(2) && set.Find(2) == set.end() && *set.LowerBound(2) == 3);
+        // Пакет сливается за один проход, имеющиеся и повторные ключи пропускаются
+        assert(set.InsertBatch(SimpleVector<int>{9, 2, 3, 2, 0}) == 3);
+        assert((set.GetKeys() == SimpleVector<int>{0, 1, 2, 3, 4, 5, 9}));
+        // Пакет больших ключей дописывается в конец
+        assert(set.InsertBatch(SimpleVector<int>{12, 10}) == 2 && *(set.end() - 1) == 12);
+        assert(set.Insert(7) && !set.Insert(7) && set.Erase(0) && !set.Erase(0));
+        assert((set.GetKeys() == SimpleVector<int>{1, 2, 3, 4, 5, 7, 9, 10, 12}));
+        FlatSet<int, less<int>, Index> copy = set;
+        assert(copy == set && copy.Contains(12));
+        set.Clear();
+        assert(set.IsEmpty() && !set.Contains(1) && set.LowerBound(1) == set.end());
+    }
+    {
+        FlatSet<string, greater<string>, Index> words(SimpleVector<string>{"b"s, "c"s, "a"s});
+        assert(*words.begin() == "c"s && words.Contains("a"s));
+    }
+    {
+        // Из пар с равными ключами при загрузке остаётся первая
+        FlatMap<int, string, less<int>, Index> map{{3, "c"s}, {1, "a"s}, {3, "x"s}, {2, "b"s}};
+        assert(map.GetSize() == 3 && map.At(3) == "c"s);
+        const auto [key, value] = *map.Find(2);
+        assert(key == 2 && value == "b"s);
+        assert(map.Find(4) == map.end());
+        try {
+            map.At(4);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        assert(map.InsertBatch(SimpleVector<pair<int, string>>{{5, "e"s}, {1, "z"s}, {0, "o"s}, {5, "y"s}}) == 2);
+        assert(map.At(1) == "a"s && map.At(5) == "e"s && map.At(0) == "o"s);
+        assert(!map.Insert(2, "q"s) && map.Insert(4, "d"s));
+        assert(!map.InsertOrAssign(4, "D"s) && map.At(4) == "D"s);
+        map[7] = "g"s;
+        map[0] += "!"s;
+        assert(map.GetSize() == 7 && map.At(7) == "g"s && map.At(0) == "o!"s);
+        assert(map.Erase(3) && !map.Erase(3) && !map.Contains(3));
+        assert((map.GetKeys() == SimpleVector<int>{0, 1, 2, 4, 5, 7}));
+        string joined;
+        for (const auto [k, v] : map) {
+            joined += to_string(k) + v;
+        }
+        assert(joined == "0o!1a2b4D5e7g"s);
+        for (auto [k, v] : map) {
+            v += "+"s;
+        }
+        assert(map.At(7) == "g+"s && (*map.LowerBound(3)).first == 4);
+        const FlatMap<int, string, less<int>, Index> copy = map;
+        assert(copy == map && copy.At(5) == "e+"s);
+        map.Clear();
+        assert(map.IsEmpty() && copy != map);
+    }
+    {
+        // Большая таблица: случайные ключи, пакетная загрузка и пакетная вставка
+        SimpleVector<pair<int, int>> items;
+        uint32_t state = 7;
+        for (int i = 0; i < 5000; ++i) {
+            state = state * 1664525u + 1013904223u;
+            items.PushBack({int(state >> 12), i});
+        }
+        FlatMap<int, int, less<int>, Index> map(items);
+        map.InsertBatch(SimpleVector<pair<int, int>>{{-1, -1}, {1 << 21, 0}});
+        for (const auto& [key, value] : items) {
+            assert(map.Contains(key));
+        }
+        assert(map.At(-1) == -1 && map.Contains(1 << 21) && !map.Contains(-2));
+        assert(is_sorted(map.GetKeys().begin(), map.GetKeys().end()));
+    }
+}
+
+void TestFlatMap() {
+    cout << "TestFlatMap"s << endl;
+    CheckFlatContainers<BinarySearchIndex>();
+    CheckFlatContainers<BTreeIndex>();
+    cout << "Done!"s << endl;
+}
+
+void TestBitVector() {
+    cout << "TestBitVector"s << endl;
+    {
+        BitVector bits;
+        assert(bits.IsEmpty() && bits.Count() == 0 && bits.FindFirst() == 0 && bits.None());
+        for (size_t i = 0; i < 130; ++i) {
+            bits.PushBack(i % 3 == 0);
+        }
+        assert(bits.GetSize() == 130 && bits.GetWords().GetSize() == 3 && bits.GetCapacity() >= 130);
+        assert(bits[0] && !bits[1] && bits[129] && bits.Count() == 44);
+        // Прокси-ссылка читает и записывает бит на месте
+        bits[1] = true;
+        bits[0] = bits[2];
+        bits[3].Flip();
+        assert(bits[1] && !bits[0] && !bits[3] && ~bits[4]);
+        bits.Set(4);
+        bits.Reset(6);
+        bits.Flip(8);
+        assert(bits.At(4) && !bits.At(6) && bits.At(8));
+        try {
+            bits.At(130);
+            assert(false);
+        }
+        catch (const out_of_range&) {
+        }
+        // Отрезанные биты обнуляются в слове и не появляются при росте
+        bits.Resize(70);
+        assert(bits.GetWords().GetSize() == 2 && bits.GetWords()[1] >> 6 == 0);
+        bits.Resize(200);
+        assert(bits.FindNext(69) == 200 && bits.Count() == bits.Rank(70));
+        bits.Resize(250, true);
+        assert(bits.Count() == bits.Rank(70) + 50 && bits.FindNext(69) == 200 && bits[249]);
+        bits.PopBack();
+        assert(bits.GetSize() == 249 && bits.Count() == bits.Rank(70) + 49);
+        while (bits.GetSize() > 64) {
+            bits.PopBack();
+        }
+        assert(bits.GetWords().GetSize() == 1);
+        bits.Clear();
+        assert(bits.IsEmpty() && bits.Count() == 0);
+    }
+    {
+        BitVector a{true, false, true, true, false};
+        const BitVector b{false, false, true, false, true};
+        assert((a & b) == (BitVector{false, false, true, false, false}));
+        assert((a | b) == (BitVector{true, false, true, true, true}));
+        assert((a ^ b) == (BitVector{true, false, false, true, true}));
+        // Инверсия не задевает биты за пределами размера
+        assert(~a == (BitVector{false, true, false, false, true}) && (~a).Count() == 2);
+        a.Set();
+        assert(a.All() && a.Count() == 5 && a.GetWords()[0] == 0x1F);
+        a.Reset();
+        assert(a.None() && a != b);
+        BitVector moved(std::move(a));
+        assert(a.IsEmpty() && moved.GetSize() == 5);
+        a = b;
+        assert(a == b);
+        size_t ones = 0;
+        for (const bool bit : b) {
+            ones += bit;
+        }
+        assert(ones == 2 && b.end() - b.begin() == 5);
+        for (auto bit : a) {
+            bit = true;
+        }
+        assert(a.All());
+    }
+    {
+        // Поиск, Rank и Select сверяются с побитовым подсчётом
+        for (size_t n : {0, 1, 63, 64, 65, 511, 512, 513, 1500, 5000}) {
+            BitVector bits(n);
+            vector<size_t> positions;
+            uint64_t state = n + 1;
+            for (size_t i = 0; i < n; ++i) {
+                state = state * 6364136223846793005u + 1442695040888963407u;
+                // Длинные пустые участки проверяют пропуск нулевых слов и блоков
+                if ((i / 700) % 2 == 0 && (state >> 60) < 5) {
+                    bits[i] = true;
+                    positions.push_back(i);
+                }
+            }
+            const BitRankIndex index(bits);
+            assert(bits.Count() == positions.size());
+            size_t found = 0;
+            for (size_t pos = bits.FindFirst(); pos < n; pos = bits.FindNext(pos)) {
+                assert(pos == positions[found++]);
+            }
+            assert(found == positions.size());
+            size_t rank = 0;
+            for (size_t pos = 0; pos <= n; ++pos) {
+                assert(bits.Rank(pos) == rank && index.Rank(bits, pos) == rank);
+                if (pos < n && bits[pos]) {
+                    ++rank;
+                }
+            }
+            for (size_t k = 0; k <= positions.size(); ++k) {
+                const size_t expected = k < positions.size() ? positions[k] : n;
+                assert(bits.Select(k) == expected && index.Select(bits, k) == expected);
+            }
+        }
+        for (size_t k = 0; k < 64; ++k) {
+            assert(BitVector::SelectInWord(~uint64_t(0), k) == k);
+        }
+        assert(BitVector::SelectInWord(uint64_t(1) << 63, 0) == 63);
+    }
+    cout << "Done!"s << endl;
+}
+
+#ifdef SIMPLE_VECTOR_CHECKED
+// Обработчик нарушений для тестов: вместо завершения процесса бросает исключение
+void ThrowOnCheckFailure(const char* message) {
+    throw logic_error(message);
+}
+
+// Сообщает, приводит ли action к нарушению проверяемого режима
+template <typename Action>
+bool CheckFails(Action action) {
+    try {
+        action();
+    }
+    catch (const logic_error&) {
+        return true;
+    }
+    return false;
+}
+
+struct LeakProbe {
+    int value = 0;
+};
+
+struct ReallocProbe {
+    int value = 0;
+};
+
+// MallocAllocator, чей reallocate по требованию бросает std::bad_alloc
+template <typename Type>
+struct FailingReallocAllocator : MallocAllocator<Type> {
+    FailingReallocAllocator() = default;
+
+    template <typename Other>
+    FailingReallocAllocator(const FailingReallocAllocator<Other>&) noexcept {
+    }
+
+    Type* reallocate(Type* p, size_t old_n, size_t new_n) {
+        if (fail) {
+            throw bad_alloc();
+        }
+        return MallocAllocator<Type>::reallocate(p, old_n, new_n);
+    }
+
+    inline static bool fail = false;
+};
+
+void TestCheckedMode() {
+    cout << "TestCheckedMode"s << endl;
+    const checked::FailureHandler previous = checked::SetFailureHandler(&ThrowOnCheckFailure);
+    {
+        // Перевыделение памяти делает итераторы недействительными
+        SimpleVector<int> v(Reserve(2));
+        v.PushBack(1);
+        auto it = v.begin();
+        v.PushBack(2);
+        assert(it.IsValid() && *it == 1);
+        v.PushBack(3);
+        assert(!it.IsValid());
+        assert(CheckFails([&] { return *it; }));
+        // Устаревший итератор можно сравнивать, но не разыменовывать
+        assert(v.begin() != nullptr && it != v.begin());
+    }
+    {
+        // Insert и Erase в середину, как и удаление элементов, тоже
+        SimpleVector<int> v{1, 2, 3, 4};
+        v.Reserve(10);
+        auto it = v.cbegin() + 1;
+        v.Insert(v.end(), 5);
+        assert(*it == 2);
+        v.Insert(v.begin(), 0);
+        assert(CheckFails([&] { return *it; }));
+        it = v.Erase(v.begin());
+        assert(*it == 1);
+        auto next = it + 1;
+        v.Erase(it);
+        assert(CheckFails([&] { return *next; }));
+        // Устаревшую позицию нельзя передать в Erase и Insert
+        assert(CheckFails([&] { v.Erase(next); }));
+        assert(CheckFails([&] { v.Insert(next, 7); }));
+        auto last = v.end() - 1;
+        v.PopBack();
+        assert(CheckFails([&] { return *last; }));
+        // Позиция из другого вектора
+        SimpleVector<int> other{1};
+        assert(CheckFails([&] { v.Insert(other.begin(), 7); }));
+        assert(v.GetSize() == 3 && v[0] == 2 && v[2] == 4);
+    }
+    {
+        // Итератор без контейнера
+        SimpleVector<int>::Iterator none;
+        assert(none == nullptr && !none);
+        assert(CheckFails([&] { return *none; }));
+    }
+    {
+        // Учёт живых блоков и байт по типам элементов
+        const checked::AllocationStats before = checked::GetAllocationStats<Record>();
+        {
+            SimpleVector<Record> v(Reserve(16));
+            const checked::AllocationStats during = checked::GetAllocationStats<Record>();
+            assert(during.live_allocations == before.live_allocations + 1);
+            assert(during.live_bytes == before.live_bytes + 16 * sizeof(Record));
+            assert(during.total_allocations == before.total_allocations + 1);
+        }
+        const checked::AllocationStats after = checked::GetAllocationStats<Record>();
+        assert(after.live_allocations == before.live_allocations && after.live_bytes == before.live_bytes);
+
+        // Отчёт перечисляет неосвобождённую память
+        auto* leaked = new SimpleVector<LeakProbe>(3);
+        ostringstream report;
+        assert(checked::ReportLeaks(report) >= 1);
+        assert(report.str().find("LeakProbe"s) != string::npos);
+        delete leaked;
+        ostringstream clean;
+        checked::ReportLeaks(clean);
+        assert(clean.str().find("LeakProbe"s) == string::npos);
+    }
+    {
+        // Неудачный reallocate оставляет прежний блок в учёте: его освобождение не ошибка
+        const checked::AllocationStats before = checked::GetAllocationStats<ReallocProbe>();
+        {
+            SimpleVector<ReallocProbe, FailingReallocAllocator<ReallocProbe>> v(4);
+            FailingReallocAllocator<ReallocProbe>::fail = true;
+            try {
+                v.Reserve(100);
+                assert(false);
+            }
+            catch (const bad_alloc&) {
+            }
+            FailingReallocAllocator<ReallocProbe>::fail = false;
+            const checked::AllocationStats during = checked::GetAllocationStats<ReallocProbe>();
+            assert(during.live_allocations == before.live_allocations + 1);
+            assert(during.live_bytes == before.live_bytes + 4 * sizeof(ReallocProbe));
+            assert(v.GetCapacity() == 4);
+            v.Reserve(100);
+            assert(checked::GetAllocationStats<ReallocProbe>().live_bytes == before.live_bytes + 100 * sizeof(ReallocProbe));
+        }
+        const checked::AllocationStats after = checked::GetAllocationStats<ReallocProbe>();
+        assert(after.live_allocations == before.live_allocations && after.live_bytes == before.live_bytes);
+    }
+    checked::SetFailureHandler(previous);
+    cout << "Done!"s << endl;
+}
+#endif
 
 void TestReserveConstructor() {
     cout << "TestReserveConstructor"s << endl;
@@ -193,6 +2210,119 @@ void TestReserveMethod() {
 
 }
 
+void TestRawStorage() {
+    cout << "TestRawStorage"s << endl;
+    Counted::constructed = 0;
+    Counted::alive = 0;
+    {
+        // Counted не имеет конструктора по умолчанию
+        SimpleVector<Counted> v;
+        v.Reserve(1000);
+        assert(v.GetCapacity() == 1000);
+        assert(Counted::constructed == 0);
+
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(Counted(i));
+        }
+        assert(Counted::alive == 10);
+
+        v.PopBack();
+        v.Erase(v.begin());
+        assert(Counted::alive == 8);
+        assert(v[0].GetValue() == 1);
+
+        v.Insert(v.begin() + 1, Counted(42));
+        assert(Counted::alive == 9);
+        assert(v[1].GetValue() == 42);
+        assert(v[2].GetValue() == 2);
+
+        // элемент самого вектора как аргумент при переполнении
+        SimpleVector<Counted> w;
+        w.PushBack(Counted(7));
+        w.PushBack(w[0]);
+        w.Insert(w.begin(), w[1]);
+        assert(w.GetSize() == 3 && w[0].GetValue() == 7 && w[2].GetValue() == 7);
+
+        v.Clear();
+        assert(Counted::alive == 3);
+    }
+    assert(Counted::alive == 0);
+    cout << "Done!"s << endl;
+}
+// Обёртка над std::allocator, считающая обращения к куче
+template <typename Type>
+struct CountingAllocator : std::allocator<Type> {
+    using value_type = Type;
+
+    CountingAllocator() = default;
+    template <typename Other>
+    CountingAllocator(const CountingAllocator<Other>&) noexcept {
+    }
+
+    Type* allocate(size_t n) {
+        ++allocations;
+        return std::allocator<Type>::allocate(n);
+    }
+
+    inline static size_t allocations = 0;
+};
+
+void TestArenaAllocator() {
+    cout << "TestArenaAllocator"s << endl;
+    MonotonicArena arena1;
+    MonotonicArena arena2;
+    using ArenaVector = SimpleVector<Counted, ArenaAllocator<Counted>>;
+    Counted::alive = 0;
+    {
+        ArenaVector v1(arena1);
+        for (int i = 0; i < 100; ++i) {
+            v1.PushBack(Counted(i));
+        }
+        assert(arena1.GetBytesAllocated() >= 100 * sizeof(Counted));
+        assert(arena2.GetBytesAllocated() == 0);
+
+        // копия получает ту же арену
+        ArenaVector copy(v1);
+        assert(copy.GetAllocator() == v1.GetAllocator());
+
+        // при присваивании аллокатор не распространяется
+        ArenaVector v2(arena2);
+        v2 = v1;
+        assert(v2.GetAllocator().GetArena() == &arena2);
+        assert(v2.GetSize() == 100 && v2[99].GetValue() == 99);
+
+        // перемещение между разными аренами переносит элементы поштучно
+        const size_t arena2_bytes = arena2.GetBytesAllocated();
+        ArenaVector v3(arena2);
+        v3 = std::move(v1);
+        assert(v3.GetAllocator().GetArena() == &arena2);
+        assert(v3.GetSize() == 100 && v3[42].GetValue() == 42);
+        assert(arena2.GetBytesAllocated() > arena2_bytes);
+
+        // внутри одной арены память просто забирается
+        ArenaVector v4(arena2);
+        const Counted* data = &v3[0];
+        v4 = std::move(v3);
+        assert(&v4[0] == data);
+        assert(v3.IsEmpty());
+    }
+    assert(Counted::alive == 0);
+
+    // аллокатор без состояния
+    {
+        CountingAllocator<int>::allocations = 0;
+        SimpleVector<int, CountingAllocator<int>> v;
+        v.Reserve(10);
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i);
+        }
+        assert(CountingAllocator<int>::allocations == 1);
+        auto moved = std::move(v);
+        assert(CountingAllocator<int>::allocations == 1);
+        assert(moved.GetSize() == 10 && moved[9] == 9);
+    }
+    cout << "Done!"s << endl;
+}
 
 inline void Test1() {
     // Инициализация конструктором по умолчанию
@@ -424,11 +2554,39 @@ int main() {
     TestNoncopiablePushBack();
     TestNoncopiableInsert();
     TestNoncopiableErase();
+    TestNoncopiableEmplace();
     Test1();
     Test2();
 
     TestReserveConstructor();
     TestReserveMethod();
+    TestRawStorage();
+    TestArenaAllocator();
+    TestEmplaceStrongGuarantee();
+    TestTriviallyRelocatable();
+    TestSmallVector();
+    TestGrowthPolicy();
+    TestShrink();
+    TestRangeInsertErase();
+    TestEraseIf();
+    TestParallelAlgorithms();
+    TestParallelResize();
+    TestSimdKernels();
+    TestConcurrentVector();
+    TestCowVector();
+    TestMappedVector();
+    TestSerialization();
+    TestSimpleSpan();
+    TestSoaVector();
+    TestGrowthSlowPath();
+    TestConstexprSimpleVector();
+    TestStaticVector();
+    TestDeVector();
+    TestFlatMap();
+    TestBitVector();
+#ifdef SIMPLE_VECTOR_CHECKED
+    TestCheckedMode();
+#endif
     return 0;
 }
 
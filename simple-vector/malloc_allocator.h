@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// Аллокатор поверх malloc/free, умеющий расширять блок на месте через reallocate.
+// Небольшие блоки растут через realloc, крупные (от kMmapThreshold байт) выделяются
+// отдельными отображениями и растут через mremap, который переносит страницы,
+// а не копирует их. SimpleVector использует reallocate для тривиально перемещаемых типов
+template <typename Type>
+class MallocAllocator {
+    static_assert(alignof(Type) <= alignof(std::max_align_t), "MallocAllocator supports only fundamental alignment");
+
+public:
+    using value_type = Type;
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t kMmapThreshold = size_t(1) << 20;
+
+    MallocAllocator() = default;
+
+    template <typename Other>
+    MallocAllocator(const MallocAllocator<Other>&) noexcept {
+    }
+
+    Type* allocate(size_t n) {
+        const size_t bytes = ToBytes(n);
+#if defined(__linux__)
+        if (bytes >= kMmapThreshold) {
+            void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<Type*>(p);
+        }
+#endif
+        void* p = std::malloc(bytes);
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(p);
+    }
+
+    void deallocate(Type* p, size_t n) noexcept {
+#if defined(__linux__)
+        if (n * sizeof(Type) >= kMmapThreshold) {
+            ::munmap(p, n * sizeof(Type));
+            return;
+        }
+#endif
+        (void)n;
+        std::free(p);
+    }
+
+    // Изменяет размер блока p с old_n до new_n элементов, сохраняя содержимое.
+    // Блок может остаться на месте или переехать; при ошибке p остаётся действительным
+    Type* reallocate(Type* p, size_t old_n, size_t new_n) {
+        const size_t new_bytes = ToBytes(new_n);
+#if defined(__linux__)
+        const size_t old_bytes = old_n * sizeof(Type);
+        const bool old_mapped = old_bytes >= kMmapThreshold;
+        const bool new_mapped = new_bytes >= kMmapThreshold;
+        if (old_mapped && new_mapped) {
+            void* q = ::mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+            if (q == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<Type*>(q);
+        }
+        if (old_mapped || new_mapped) {
+            Type* q = allocate(new_n);
+            std::memcpy(static_cast<void*>(q), static_cast<const void*>(p), std::min(old_bytes, new_bytes));
+            deallocate(p, old_n);
+            return q;
+        }
+#endif
+        (void)old_n;
+        void* q = std::realloc(p, new_bytes);
+        if (q == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<Type*>(q);
+    }
+
+private:
+    static size_t ToBytes(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(Type)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(Type);
+    }
+};
+
+template <typename Lhs, typename Rhs>
+bool operator==(const MallocAllocator<Lhs>&, const MallocAllocator<Rhs>&) noexcept {
+    return true;
+}
+
+template <typename Lhs, typename Rhs>
+bool operator!=(const MallocAllocator<Lhs>&, const MallocAllocator<Rhs>&) noexcept {
+    return false;
+}
@@ -0,0 +1,364 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Режим открытия файла MappedSimpleVector
+enum class MapMode {
+    // Файл создаётся, если его нет; вектор можно изменять
+    kReadWrite,
+    // Файл должен существовать; изменяющие методы выбрасывают std::logic_error
+    kReadOnly,
+};
+
+// Вектор тривиально копируемых элементов, хранящий их в файле, отображённом в память.
+// Элементы не читаются при открытии: страницы подгружаются ядром при первом обращении,
+// поэтому время открытия не зависит от размера данных, а сами данные могут не помещаться в память.
+// Файл начинается с заголовка kHeaderBytes байт (метка, версия, размер элемента, количество
+// элементов), за которым идут элементы. Размер файла — это вместимость вектора:
+// вектор растёт через ftruncate и mremap, который переносит страницы, а не копирует их.
+// Изменения попадают в файл в любом случае, Flush() лишь дожидается их записи на диск.
+// Только для Linux
+template <typename Type>
+class MappedSimpleVector {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedSimpleVector stores elements as raw bytes");
+
+    struct FileHeader {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t size;
+    };
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    // Заголовок занимает целую строку кеша, чтобы элементы были выровнены
+    static constexpr size_t kHeaderBytes = 64;
+    static_assert(alignof(Type) <= kHeaderBytes, "MappedSimpleVector supports alignment up to 64 bytes");
+
+    // Открывает файл path, а в режиме kReadWrite создаёт пустой, если файла нет.
+    // Выбрасывает std::system_error при ошибке системного вызова и std::runtime_error,
+    // если файл создан не MappedSimpleVector<Type> или элементами другого размера
+    explicit MappedSimpleVector(const std::string& path, MapMode mode = MapMode::kReadWrite)
+        : mode_(mode) {
+        const bool writable = mode == MapMode::kReadWrite;
+        fd_ = ::open(path.c_str(), writable ? O_RDWR | O_CREAT | O_CLOEXEC : O_RDONLY | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open");
+        }
+        try {
+            struct stat st{};
+            if (::fstat(fd_, &st) != 0) {
+                ThrowSystemError("fstat");
+            }
+            bytes_ = static_cast<size_t>(st.st_size);
+            const bool created = bytes_ == 0 && writable;
+            if (created) {
+                bytes_ = PageSize();
+                Truncate(bytes_);
+            }
+            if (bytes_ < kHeaderBytes) {
+                throw std::runtime_error("mapped vector file is truncated");
+            }
+            Map();
+            if (created) {
+                *Header() = FileHeader{kMagic, kVersion, sizeof(Type), 0};
+            }
+            Validate();
+        }
+        catch (...) {
+            Close();
+            throw;
+        }
+    }
+
+    MappedSimpleVector(const MappedSimpleVector&) = delete;
+    MappedSimpleVector& operator=(const MappedSimpleVector&) = delete;
+
+    MappedSimpleVector(MappedSimpleVector&& other) noexcept
+        : fd_(std::exchange(other.fd_, -1)),
+        base_(std::exchange(other.base_, nullptr)),
+        bytes_(std::exchange(other.bytes_, 0)),
+        mode_(other.mode_) {
+    }
+
+    MappedSimpleVector& operator=(MappedSimpleVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            fd_ = std::exchange(rhs.fd_, -1);
+            base_ = std::exchange(rhs.base_, nullptr);
+            bytes_ = std::exchange(rhs.bytes_, 0);
+            mode_ = rhs.mode_;
+        }
+        return *this;
+    }
+
+    // Снимает отображение и закрывает файл. Данные остаются в файле
+    ~MappedSimpleVector() {
+        Close();
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return base_ != nullptr ? Header()->size : 0;
+    }
+
+    // Возвращает вместимость массива: сколько элементов помещается в файл
+    size_t GetCapacity() const noexcept {
+        return base_ != nullptr ? (bytes_ - kHeaderBytes) / sizeof(Type) : 0;
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return GetSize() == 0;
+    }
+
+    // Сообщает, открыт ли файл только для чтения
+    bool IsReadOnly() const noexcept {
+        return mode_ == MapMode::kReadOnly;
+    }
+
+    // Возвращает ссылку на элемент с индексом index.
+    // В режиме kReadOnly страницы защищены от записи: запись через ссылку завершит процесс
+    Type& operator[](size_t index) noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < GetSize());
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= GetSize()) { throw std::out_of_range("index >= size"); }
+        return Data()[index];
+    }
+
+    const Type& At(size_t index) const {
+        if (index >= GetSize()) { throw std::out_of_range("index >= size"); }
+        return Data()[index];
+    }
+
+    // Обнуляет размер массива, не изменяя его вместимость и размер файла
+    void Clear() {
+        CheckWritable();
+        Header()->size = 0;
+    }
+
+    void PushBack(const Type& item) {
+        CheckWritable();
+        const size_t size = Header()->size;
+        if (size == GetCapacity()) {
+            // item может лежать в самом векторе, а рост переносит отображение
+            const Type copy = item;
+            Grow(size + 1);
+            Data()[size] = copy;
+        }
+        else {
+            Data()[size] = item;
+        }
+        Header()->size = size + 1;
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() {
+        CheckWritable();
+        assert(!IsEmpty());
+        --Header()->size;
+    }
+
+    // Изменяет размер массива. Новые элементы инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        Resize(new_size, Type());
+    }
+
+    // Изменяет размер массива. Новые элементы инициализируются значением value
+    void Resize(size_t new_size, const Type& value) {
+        CheckWritable();
+        const size_t size = Header()->size;
+        if (new_size > size) {
+            const Type copy = value;
+            if (new_size > GetCapacity()) {
+                Grow(new_size);
+            }
+            std::fill(Data() + size, Data() + new_size, copy);
+        }
+        Header()->size = new_size;
+    }
+
+    // Увеличивает файл так, чтобы в него помещалось new_capacity элементов
+    void Reserve(size_t new_capacity) {
+        CheckWritable();
+        if (new_capacity > GetCapacity()) {
+            Remap(BytesFor(new_capacity));
+        }
+    }
+
+    // Укорачивает файл до размера, достаточного для текущих элементов
+    void ShrinkToFit() {
+        CheckWritable();
+        const size_t bytes = BytesFor(GetSize());
+        if (bytes < bytes_) {
+            Remap(bytes);
+        }
+    }
+
+    // Синхронно записывает изменённые страницы на диск через msync
+    void Flush() {
+        if (base_ != nullptr && !IsReadOnly() && ::msync(base_, bytes_, MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+    Iterator begin() noexcept {
+        return Data();
+    }
+
+    Iterator end() noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    ConstIterator end() const noexcept {
+        return Data() + GetSize();
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    static constexpr uint64_t kMagic = 0x44455050414d5653;  // "SVMAPPED"
+    static constexpr uint32_t kVersion = 1;
+
+    [[noreturn]] static void ThrowSystemError(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    static size_t PageSize() noexcept {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return page;
+    }
+
+    // Размер файла под capacity элементов, округлённый вверх до целой страницы
+    static size_t BytesFor(size_t capacity) {
+        if (capacity > (SIZE_MAX - kHeaderBytes - PageSize()) / sizeof(Type)) {
+            throw std::length_error("mapped vector capacity is too large");
+        }
+        const size_t bytes = kHeaderBytes + capacity * sizeof(Type);
+        return (bytes + PageSize() - 1) / PageSize() * PageSize();
+    }
+
+    FileHeader* Header() const noexcept {
+        return static_cast<FileHeader*>(base_);
+    }
+
+    Type* Data() const noexcept {
+        return base_ != nullptr ? reinterpret_cast<Type*>(static_cast<char*>(base_) + kHeaderBytes) : nullptr;
+    }
+
+    void CheckWritable() const {
+        if (IsReadOnly()) {
+            throw std::logic_error("mapped vector is read-only");
+        }
+    }
+
+    void Validate() const {
+        const FileHeader& header = *Header();
+        if (header.magic != kMagic || header.version != kVersion) {
+            throw std::runtime_error("file is not a mapped vector");
+        }
+        if (header.element_size != sizeof(Type)) {
+            throw std::runtime_error("mapped vector element size mismatch");
+        }
+        if (header.size > GetCapacity()) {
+            throw std::runtime_error("mapped vector file is truncated");
+        }
+    }
+
+    void Truncate(size_t bytes) {
+        if (::ftruncate(fd_, static_cast<off_t>(bytes)) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+    }
+
+    void Map() {
+        const int prot = IsReadOnly() ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* p = ::mmap(nullptr, bytes_, prot, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        base_ = p;
+    }
+
+    // Вместимость растёт вдвое, но не меньше required
+    void Grow(size_t required) {
+        Remap(BytesFor(std::max(required, GetCapacity() * 2)));
+    }
+
+    // Меняет размер файла и отображения. При росте файл удлиняется до mremap,
+    // при сокращении — укорачивается после, чтобы отображение не выходило за конец файла.
+    // Если mremap не удался, файл возвращается к прежнему размеру
+    void Remap(size_t new_bytes) {
+        if (new_bytes > bytes_) {
+            Truncate(new_bytes);
+        }
+        void* p = ::mremap(base_, bytes_, new_bytes, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            const int error = errno;
+            if (new_bytes > bytes_) {
+                (void)::ftruncate(fd_, static_cast<off_t>(bytes_));
+            }
+            throw std::system_error(error, std::generic_category(), "mremap");
+        }
+        base_ = p;
+        const size_t old_bytes = std::exchange(bytes_, new_bytes);
+        if (new_bytes < old_bytes) {
+            Truncate(new_bytes);
+        }
+    }
+
+    void Close() noexcept {
+        if (base_ != nullptr) {
+            ::munmap(base_, bytes_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        bytes_ = 0;
+    }
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    // Размер файла и отображения в байтах
+    size_t bytes_ = 0;
+    MapMode mode_;
+};
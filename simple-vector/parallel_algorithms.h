@@ -0,0 +1,622 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "simple_span.h"
+#include "simple_vector.h"
+#include "thread_pool.h"
+
+// Параллельные алгоритмы над SimpleVector и диапазонами его итераторов.
+// Диапазон делится на блоки, кратные кэш-линии, чтобы потоки не писали в одну линию,
+// и блоков в несколько раз больше, чем потоков, чтобы перехват задач выравнивал нагрузку.
+// Все алгоритмы выполняются на пуле pool (по умолчанию ThreadPool::Default())
+// и пробрасывают первое исключение, брошенное пользовательской функцией
+
+// Размещение страниц вектора по узлам NUMA при параллельной инициализации
+enum class Placement {
+    // Страница достаётся узлу потока, который первым её коснулся. Блоки инициализации —
+    // блоки параллельных алгоритмов, округлённые до страниц, поэтому параллельный проход
+    // тем же пулом читает в основном память узлов своих потоков
+    kLocal,
+    // Страницы чередуются между всеми узлами: полоса памяти всех узлов доступна
+    // любому потоку. На Linux страницы связываются политикой MPOL_INTERLEAVE до первого
+    // касания, на других системах размещение такое же, как у kLocal
+    kInterleave,
+};
+
+namespace parallel_detail {
+
+inline constexpr size_t kCacheLineSize = 64;
+inline constexpr size_t kPageSize = 4096;
+// Во сколько раз блоков больше, чем потоков
+inline constexpr size_t kChunksPerThread = 8;
+
+inline size_t RoundUp(size_t value, size_t step) noexcept {
+    return (value + step - 1) / step * step;
+}
+
+// Размер блока в элементах для диапазона из count элементов типа Type:
+// кратен числу элементов в кэш-линии и не меньше страницы, чтобы накладные расходы
+// на задачу не превышали полезную работу
+template <typename Type>
+size_t ChunkSize(size_t count, const ThreadPool& pool) noexcept {
+    constexpr size_t kLine = std::max<size_t>(1, kCacheLineSize / sizeof(Type));
+    constexpr size_t kMinChunk = std::max<size_t>(kLine, kPageSize / sizeof(Type));
+    const size_t chunks = pool.GetThreadCount() * kChunksPerThread;
+    return RoundUp(std::max(kMinChunk, (count + chunks - 1) / chunks), kLine);
+}
+
+// Вызывает body(begin, end) для блоков, покрывающих [0, count). Диапазон делится пополам
+// по границам, кратным grain: правая половина ставится в очередь и может быть украдена
+// свободным потоком, левая делится дальше в текущем
+template <typename Body>
+void ParallelFor(ThreadPool& pool, size_t count, size_t grain, const Body& body) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<size_t>(grain, 1);
+    // split объявлен раньше группы: если body бросит исключение в этом потоке,
+    // деструктор группы дождётся задач, которые ещё вызывают split
+    auto split = [&body, grain](auto& self, TaskGroup& group, size_t begin, size_t end) -> void {
+        while (end - begin > grain) {
+            const size_t mid = begin + ((end - begin) / grain + 1) / 2 * grain;
+            group.Run([&self, &group, mid, end] { self(self, group, mid, end); });
+            end = mid;
+        }
+        body(begin, end);
+    };
+    TaskGroup group(pool);
+    split(split, group, 0, count);
+    group.Wait();
+}
+
+inline size_t ChunkCount(size_t count, size_t grain) noexcept {
+    return (count + grain - 1) / grain;
+}
+
+// Вызывает body(chunk, begin, end) для каждого из блоков [chunk * grain, ...) диапазона [0, count)
+template <typename Body>
+void ForEachChunk(ThreadPool& pool, size_t count, size_t grain, const Body& body) {
+    ParallelFor(pool, ChunkCount(count, grain), 1, [&](size_t first_chunk, size_t last_chunk) {
+        for (size_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+            body(chunk, chunk * grain, std::min(count, (chunk + 1) * grain));
+        }
+    });
+}
+
+// Параллельно создаёт элементы в неинициализированной памяти. construct(chunk) создаёт
+// элементы блока и при исключении сам разрушает созданные им. Если исключение бросил
+// хоть один блок, для остальных уже завершённых блоков вызывается destroy(chunk)
+template <typename Construct, typename Destroy>
+void ConstructChunks(ThreadPool& pool, size_t chunks, const Construct& construct, const Destroy& destroy) {
+    // Каждый блок пишет только свой флаг, а Wait публикует флаги вызывающему потоку
+    std::unique_ptr<bool[]> done(new bool[chunks]());
+    try {
+        ParallelFor(pool, chunks, 1, [&](size_t first_chunk, size_t last_chunk) {
+            for (size_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+                construct(chunk);
+                done[chunk] = true;
+            }
+        });
+    }
+    catch (...) {
+        for (size_t chunk = 0; chunk < chunks; ++chunk) {
+            if (done[chunk]) {
+                destroy(chunk);
+            }
+        }
+        throw;
+    }
+}
+
+// Создаёт элементы dest[i] = make(i) для i из [begin, end).
+// При исключении разрушает созданные и пробрасывает исключение
+template <typename Type, typename Make>
+void UninitializedGenerate(Type* dest, size_t begin, size_t end, const Make& make) {
+    size_t i = begin;
+    try {
+        for (; i < end; ++i) {
+            std::construct_at(dest + i, make(i));
+        }
+    }
+    catch (...) {
+        std::destroy(dest + begin, dest + i);
+        throw;
+    }
+}
+
+// Переносит в out элементы [first, last), для которых pred возвращает true, сохраняя их порядок.
+// Первый проход считает подходящие элементы каждого блока и запоминает ответы pred,
+// затем по префиксным суммам каждый блок копирует свои элементы на итоговые места.
+// Копии создаются std::construct_at, в обход construct аллокатора out
+template <typename RandomIt, typename Predicate, typename Vector>
+void FilterInto(RandomIt first, RandomIt last, const Predicate& pred, ThreadPool& pool, Vector& out) {
+    using Value = std::iter_value_t<RandomIt>;
+    const size_t count = static_cast<size_t>(last - first);
+    // Блок кратен кэш-линии и для флагов, и для элементов
+    const size_t grain = RoundUp(ChunkSize<Value>(count, pool), kCacheLineSize);
+    const size_t chunks = ChunkCount(count, grain);
+    std::unique_ptr<bool[]> keep(new bool[count]);
+    std::unique_ptr<size_t[]> offsets(new size_t[chunks + 1]());
+    ForEachChunk(pool, count, grain, [&](size_t chunk, size_t begin, size_t end) {
+        size_t kept = 0;
+        for (size_t i = begin; i < end; ++i) {
+            keep[i] = static_cast<bool>(pred(std::as_const(first[i])));
+            kept += keep[i];
+        }
+        offsets[chunk + 1] = kept;
+    });
+    std::partial_sum(offsets.get(), offsets.get() + chunks + 1, offsets.get());
+
+    out.AppendConstructed(offsets[chunks], [&](Value* dest, size_t) {
+        auto chunk_range = [&](size_t chunk) {
+            return std::pair(chunk * grain, std::min(count, (chunk + 1) * grain));
+        };
+        ConstructChunks(
+            pool, chunks,
+            [&](size_t chunk) {
+                const auto [begin, end] = chunk_range(chunk);
+                Value* out_first = dest + offsets[chunk];
+                Value* out_it = out_first;
+                try {
+                    for (size_t i = begin; i < end; ++i) {
+                        if (keep[i]) {
+                            std::construct_at(out_it, first[i]);
+                            ++out_it;
+                        }
+                    }
+                }
+                catch (...) {
+                    std::destroy(out_first, out_it);
+                    throw;
+                }
+            },
+            [&](size_t chunk) {
+                std::destroy(dest + offsets[chunk], dest + offsets[chunk + 1]);
+            });
+    });
+}
+
+
+// Просит ядро чередовать ещё не затронутые страницы [data, data + bytes) между всеми
+// узлами NUMA из /sys/devices/system/node/online. Ошибки не критичны: без поддержки NUMA
+// страницы размещаются как обычно. Возвращает true, если политика установлена
+inline bool InterleavePages(const void* data, size_t bytes) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+    // Список узлов вида "0-1,3"
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string nodes;
+    if (!std::getline(online, nodes)) {
+        return false;
+    }
+    constexpr size_t kMaskBits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask;
+    size_t pos = 0;
+    while (pos < nodes.size()) {
+        size_t first = 0;
+        size_t last = 0;
+        size_t used = 0;
+        try {
+            first = last = std::stoul(nodes.substr(pos), &used);
+            pos += used;
+            if (pos < nodes.size() && nodes[pos] == '-') {
+                last = std::stoul(nodes.substr(pos + 1), &used);
+                pos += used + 1;
+            }
+        }
+        catch (...) {
+            return false;
+        }
+        for (size_t node = first; node <= last; ++node) {
+            mask.resize(std::max(mask.size(), node / kMaskBits + 1));
+            mask[node / kMaskBits] |= 1ul << (node % kMaskBits);
+        }
+        pos += pos < nodes.size() && nodes[pos] == ',';
+    }
+    if (mask.empty()) {
+        return false;
+    }
+    // mbind требует начало, выровненное по странице
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data) / kPageSize * kPageSize;
+    const uintptr_t end = reinterpret_cast<uintptr_t>(data) + bytes;
+    constexpr int kMpolInterleave = 3;
+    return ::syscall(SYS_mbind, begin, end - begin, kMpolInterleave, mask.data(), mask.size() * kMaskBits + 1, 0)
+        == 0;
+#else
+    (void)data;
+    (void)bytes;
+    return false;
+#endif
+}
+
+// Сетка блоков для первого касания: границы блоков, кроме начала первого, лежат
+// на границах страниц, поэтому каждую страницу инициализирует ровно один поток.
+// Размер блока — ChunkSize, округлённый вверх до целых страниц
+template <typename Type>
+class PageChunks {
+public:
+    PageChunks(const Type* data, size_t count, const ThreadPool& pool) noexcept
+        : base_(reinterpret_cast<uintptr_t>(data)),
+        count_(count),
+        grain_(RoundUp(ChunkSize<Type>(count, pool) * sizeof(Type), kPageSize)),
+        aligned_(RoundUp(base_, kPageSize)) {
+        const uintptr_t end = base_ + count * sizeof(Type);
+        chunks_ = end > aligned_ ? std::max<size_t>(1, ChunkCount(end - aligned_, grain_)) : 1;
+    }
+
+    size_t GetCount() const noexcept {
+        return chunks_;
+    }
+
+    // Индекс первого элемента блока chunk: первый элемент, начинающийся не раньше его страницы
+    size_t Begin(size_t chunk) const noexcept {
+        if (chunk == 0) {
+            return 0;
+        }
+        const uintptr_t boundary = aligned_ + chunk * grain_;
+        return std::min(count_, (boundary - base_ + sizeof(Type) - 1) / sizeof(Type));
+    }
+
+    size_t End(size_t chunk) const noexcept {
+        return chunk + 1 == chunks_ ? count_ : Begin(chunk + 1);
+    }
+
+private:
+    uintptr_t base_;
+    size_t count_;
+    size_t grain_;
+    uintptr_t aligned_;
+    size_t chunks_ = 1;
+};
+
+// Параллельно создаёт элементы dest[i], i из [begin, end), вызовом construct(dest + i, i).
+// Блоки сетки chunks создаются в потоках пула, поэтому каждая страница впервые
+// затрагивается потоком, инициализирующим её блок. При исключении созданные элементы
+// разрушаются
+template <typename Type, typename Construct>
+void FirstTouchConstruct(ThreadPool& pool, const PageChunks<Type>& chunks, Type* dest, size_t begin, size_t end,
+                         const Construct& construct) {
+    auto range = [&](size_t chunk) {
+        return std::pair(std::clamp(chunks.Begin(chunk), begin, end), std::clamp(chunks.End(chunk), begin, end));
+    };
+    ConstructChunks(
+        pool, chunks.GetCount(),
+        [&](size_t chunk) {
+            const auto [first, last] = range(chunk);
+            size_t i = first;
+            try {
+                for (; i < last; ++i) {
+                    construct(dest + i, i);
+                }
+            }
+            catch (...) {
+                std::destroy(dest + first, dest + i);
+                throw;
+            }
+        },
+        [&](size_t chunk) {
+            const auto [first, last] = range(chunk);
+            std::destroy(dest + first, dest + last);
+        });
+}
+
+// Увеличивает v до new_size элементов, создавая новые вызовом construct(Type*).
+// Если памяти не хватает, новый буфер заполняют рабочие потоки: сначала новые элементы,
+// затем перенесённые старые, чтобы исключение при создании новых не затронуло v.
+// Старые переносятся std::move_if_noexcept, как при обычном перевыделении
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Construct>
+void ParallelGrow(SimpleVector<Type, Allocator, GrowthPolicy>& v, size_t new_size, Placement placement,
+                  ThreadPool& pool, const Construct& construct) {
+    const size_t old_size = v.GetSize();
+    if (new_size <= old_size) {
+        v.Erase(v.begin() + new_size, v.end());
+        return;
+    }
+    if (new_size <= v.GetCapacity()) {
+        v.AppendConstructed(new_size - old_size, [&](Type* dest, size_t count) {
+            if (placement == Placement::kInterleave) {
+                InterleavePages(dest, count * sizeof(Type));
+            }
+            FirstTouchConstruct(pool, PageChunks<Type>(dest, count, pool), dest, 0, count,
+                                [&](Type* p, size_t) { construct(p); });
+        });
+        return;
+    }
+    SimpleVector<Type, Allocator, GrowthPolicy> fresh(v.GetAllocator());
+    fresh.Reserve(v.GetGrowthPolicy().NextCapacity(v.GetCapacity(), new_size, sizeof(Type)));
+    Type* old = v.GetData();
+    fresh.AppendConstructed(new_size, [&](Type* dest, size_t) {
+        if (placement == Placement::kInterleave) {
+            InterleavePages(dest, fresh.GetCapacity() * sizeof(Type));
+        }
+        const PageChunks<Type> chunks(dest, new_size, pool);
+        FirstTouchConstruct(pool, chunks, dest, old_size, new_size, [&](Type* p, size_t) { construct(p); });
+        try {
+            FirstTouchConstruct(pool, chunks, dest, 0, old_size, [&](Type* p, size_t i) {
+                std::construct_at(p, std::move_if_noexcept(old[i]));
+            });
+        }
+        catch (...) {
+            std::destroy(dest + old_size, dest + new_size);
+            throw;
+        }
+    });
+    // Статистика политики v продолжается: перевыделение учитывается в ней, а не в fresh
+    GrowthPolicy growth = v.GetGrowthPolicy();
+    growth.OnReallocate(v.GetCapacity(), fresh.GetCapacity(), old_size * sizeof(Type));
+    v.swap(fresh);
+    v.GetGrowthPolicy() = std::move(growth);
+}
+
+}  // namespace parallel_detail
+
+// Вызывает f(element) для каждого элемента [first, last). Порядок вызовов не определён
+template <typename RandomIt, typename Function>
+    requires std::random_access_iterator<RandomIt>
+void ParallelForEach(RandomIt first, RandomIt last, Function f, ThreadPool& pool = ThreadPool::Default()) {
+    using namespace parallel_detail;
+    const size_t count = static_cast<size_t>(last - first);
+    ParallelFor(pool, count, ChunkSize<std::iter_value_t<RandomIt>>(count, pool), [&](size_t begin, size_t end) {
+        std::for_each(first + begin, first + end, f);
+    });
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Function>
+void ParallelForEach(SimpleVector<Type, Allocator, GrowthPolicy>& v, Function f, ThreadPool& pool = ThreadPool::Default()) {
+    ParallelForEach(v.begin(), v.end(), std::move(f), pool);
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Function>
+void ParallelForEach(const SimpleVector<Type, Allocator, GrowthPolicy>& v, Function f,
+                     ThreadPool& pool = ThreadPool::Default()) {
+    ParallelForEach(v.begin(), v.end(), std::move(f), pool);
+}
+
+template <typename Type, typename Function>
+void ParallelForEach(SimpleSpan<Type> s, Function f, ThreadPool& pool = ThreadPool::Default()) {
+    ParallelForEach(s.begin(), s.end(), std::move(f), pool);
+}
+
+// Записывает op(*it) для каждого элемента [first, last) в диапазон, начинающийся с d_first.
+// Возвращает итератор за последним записанным элементом.
+// Диапазоны не должны перекрываться, если только d_first не равен first
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+    requires std::random_access_iterator<RandomIt> && std::random_access_iterator<OutputIt>
+OutputIt ParallelTransform(RandomIt first, RandomIt last, OutputIt d_first, UnaryOp op,
+                           ThreadPool& pool = ThreadPool::Default()) {
+    using namespace parallel_detail;
+    const size_t count = static_cast<size_t>(last - first);
+    ParallelFor(pool, count, ChunkSize<std::iter_value_t<OutputIt>>(count, pool), [&](size_t begin, size_t end) {
+        std::transform(first + begin, first + end, d_first + begin, op);
+    });
+    return d_first + count;
+}
+
+// Возвращает новый вектор из значений op(element) для элементов s
+template <typename Type, typename UnaryOp>
+auto ParallelTransform(SimpleSpan<Type> s, UnaryOp op, ThreadPool& pool = ThreadPool::Default()) {
+    using namespace parallel_detail;
+    using Result = std::decay_t<std::invoke_result_t<UnaryOp&, Type&>>;
+    SimpleVector<Result> result;
+    const size_t count = s.GetSize();
+    const size_t grain = ChunkSize<Result>(count, pool);
+    result.AppendConstructed(count, [&](Result* dest, size_t) {
+        ConstructChunks(
+            pool, ChunkCount(count, grain),
+            [&](size_t chunk) {
+                UninitializedGenerate(dest, chunk * grain, std::min(count, (chunk + 1) * grain),
+                                      [&](size_t i) { return op(s[i]); });
+            },
+            [&](size_t chunk) {
+                std::destroy(dest + chunk * grain, dest + std::min(count, (chunk + 1) * grain));
+            });
+    });
+    return result;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename UnaryOp>
+auto ParallelTransform(const SimpleVector<Type, Allocator, GrowthPolicy>& v, UnaryOp op,
+                       ThreadPool& pool = ThreadPool::Default()) {
+    return ParallelTransform(ConstSimpleSpan<Type>(v), std::move(op), pool);
+}
+
+// Сворачивает [first, last) операцией op, начиная с init. op должна быть ассоциативной:
+// блоки сворачиваются независимо, а затем их итоги сворачиваются по порядку блоков
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+    requires std::random_access_iterator<RandomIt>
+T ParallelReduce(RandomIt first, RandomIt last, T init, BinaryOp op = {}, ThreadPool& pool = ThreadPool::Default()) {
+    using namespace parallel_detail;
+    const size_t count = static_cast<size_t>(last - first);
+    const size_t grain = ChunkSize<std::iter_value_t<RandomIt>>(count, pool);
+    const size_t chunks = ChunkCount(count, grain);
+    SimpleVector<std::optional<T>> partials(chunks);
+    ForEachChunk(pool, count, grain, [&](size_t chunk, size_t begin, size_t end) {
+        T acc = first[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            acc = op(std::move(acc), first[i]);
+        }
+        partials[chunk].emplace(std::move(acc));
+    });
+    for (std::optional<T>& partial : partials) {
+        init = op(std::move(init), std::move(*partial));
+    }
+    return init;
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename T, typename BinaryOp = std::plus<>>
+T ParallelReduce(const SimpleVector<Type, Allocator, GrowthPolicy>& v, T init, BinaryOp op = {},
+                 ThreadPool& pool = ThreadPool::Default()) {
+    return ParallelReduce(v.begin(), v.end(), std::move(init), std::move(op), pool);
+}
+
+template <typename Type, typename T, typename BinaryOp = std::plus<>>
+T ParallelReduce(SimpleSpan<Type> s, T init, BinaryOp op = {}, ThreadPool& pool = ThreadPool::Default()) {
+    return ParallelReduce(s.begin(), s.end(), std::move(init), std::move(op), pool);
+}
+
+// Записывает в d_first включающие префиксные свёртки [first, last) операцией op.
+// Первый проход сворачивает каждый блок, затем итоги блоков превращаются в смещения,
+// и второй проход досчитывает блоки с их смещений. op должна быть ассоциативной.
+// d_first может совпадать с first. Возвращает итератор за последним записанным элементом
+template <typename RandomIt, typename OutputIt, typename BinaryOp = std::plus<>>
+    requires std::random_access_iterator<RandomIt> && std::random_access_iterator<OutputIt>
+OutputIt ParallelInclusiveScan(RandomIt first, RandomIt last, OutputIt d_first, BinaryOp op = {},
+                               ThreadPool& pool = ThreadPool::Default()) {
+    using namespace parallel_detail;
+    using Value = std::iter_value_t<RandomIt>;
+    const size_t count = static_cast<size_t>(last - first);
+    const size_t grain = ChunkSize<Value>(count, pool);
+    const size_t chunks = ChunkCount(count, grain);
+    SimpleVector<std::optional<Value>> carry(chunks);
+    ForEachChunk(pool, count, grain, [&](size_t chunk, size_t begin, size_t end) {
+        if (chunk + 1 == chunks) {
+            return;
+        }
+        Value acc = first[begin];
+        for (size_t i = begin + 1; i < end; ++i) {
+            acc = op(std::move(acc), first[i]);
+        }
+        carry[chunk + 1].emplace(std::move(acc));
+    });
+    for (size_t chunk = 2; chunk < chunks; ++chunk) {
+        *carry[chunk] = op(*carry[chunk - 1], std::move(*carry[chunk]));
+    }
+    ForEachChunk(pool, count, grain, [&](size_t chunk, size_t begin, size_t end) {
+        Value acc = chunk == 0 ? Value(first[begin]) : op(*carry[chunk], first[begin]);
+        d_first[begin] = acc;
+        for (size_t i = begin + 1; i < end; ++i) {
+            acc = op(std::move(acc), first[i]);
+            d_first[i] = acc;
+        }
+    });
+    return d_first + count;
+}
+
+// Заменяет элементы v их включающими префиксными свёртками
+template <typename Type, typename Allocator, typename GrowthPolicy, typename BinaryOp = std::plus<>>
+void ParallelInclusiveScan(SimpleVector<Type, Allocator, GrowthPolicy>& v, BinaryOp op = {},
+                           ThreadPool& pool = ThreadPool::Default()) {
+    ParallelInclusiveScan(v.begin(), v.end(), v.begin(), std::move(op), pool);
+}
+
+template <typename Type, typename BinaryOp = std::plus<>>
+void ParallelInclusiveScan(SimpleSpan<Type> s, BinaryOp op = {}, ThreadPool& pool = ThreadPool::Default()) {
+    ParallelInclusiveScan(s.begin(), s.end(), s.begin(), std::move(op), pool);
+}
+
+// Сортирует [first, last): блоки сортируются параллельно, затем сливаются парами,
+// на каждом раунде все пары сливаются одновременно. Сортировка неустойчивая
+template <typename RandomIt, typename Compare = std::less<>>
+    requires std::random_access_iterator<RandomIt>
+void ParallelSort(RandomIt first, RandomIt last, Compare comp = {}, ThreadPool& pool = ThreadPool::Default()) {
+    using namespace parallel_detail;
+    const size_t count = static_cast<size_t>(last - first);
+    const size_t grain = ChunkSize<std::iter_value_t<RandomIt>>(count, pool);
+    if (count <= grain) {
+        std::sort(first, last, comp);
+        return;
+    }
+    ForEachChunk(pool, count, grain, [&](size_t, size_t begin, size_t end) {
+        std::sort(first + begin, first + end, comp);
+    });
+    for (size_t width = grain; width < count; width *= 2) {
+        ForEachChunk(pool, count, 2 * width, [&](size_t, size_t begin, size_t end) {
+            const size_t mid = std::min(begin + width, end);
+            std::inplace_merge(first + begin, first + mid, first + end, comp);
+        });
+    }
+}
+
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Compare = std::less<>>
+void ParallelSort(SimpleVector<Type, Allocator, GrowthPolicy>& v, Compare comp = {},
+                  ThreadPool& pool = ThreadPool::Default()) {
+    ParallelSort(v.begin(), v.end(), std::move(comp), pool);
+}
+
+template <typename Type, typename Compare = std::less<>>
+void ParallelSort(SimpleSpan<Type> s, Compare comp = {}, ThreadPool& pool = ThreadPool::Default()) {
+    ParallelSort(s.begin(), s.end(), std::move(comp), pool);
+}
+
+// Возвращает новый вектор из копий элементов [first, last), для которых pred возвращает true,
+// в исходном порядке. Элементы копируются сразу на свои места без промежуточных буферов
+template <typename RandomIt, typename Predicate>
+    requires std::random_access_iterator<RandomIt>
+SimpleVector<std::iter_value_t<RandomIt>> ParallelFilter(RandomIt first, RandomIt last, Predicate pred,
+                                                         ThreadPool& pool = ThreadPool::Default()) {
+    SimpleVector<std::iter_value_t<RandomIt>> result;
+    parallel_detail::FilterInto(first, last, pred, pool, result);
+    return result;
+}
+
+// Результат получает аллокатор и политику роста v
+template <typename Type, typename Allocator, typename GrowthPolicy, typename Predicate>
+SimpleVector<Type, Allocator, GrowthPolicy> ParallelFilter(const SimpleVector<Type, Allocator, GrowthPolicy>& v,
+                                                           Predicate pred, ThreadPool& pool = ThreadPool::Default()) {
+    SimpleVector<Type, Allocator, GrowthPolicy> result(v.GetAllocator());
+    parallel_detail::FilterInto(v.begin(), v.end(), pred, pool, result);
+    return result;
+}
+
+template <typename Type, typename Predicate>
+SimpleVector<std::remove_const_t<Type>> ParallelFilter(SimpleSpan<Type> s, Predicate pred,
+                                                       ThreadPool& pool = ThreadPool::Default()) {
+    return ParallelFilter(s.begin(), s.end(), std::move(pred), pool);
+}
+
+// Изменяет размер v, создавая новые элементы значением по умолчанию в потоках пула.
+// Для больших векторов это быстрее однопоточного Resize, а страницы памяти размещаются
+// по узлам NUMA согласно placement: каждый блок, выровненный по страницам, впервые
+// затрагивает поток, который его инициализирует. Если памяти не хватает, в новый буфер
+// параллельно переносятся и существующие элементы. Лишние элементы удаляются, как в Resize.
+// Элементы создаются std::construct_at, в обход construct аллокатора v
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void ParallelResize(SimpleVector<Type, Allocator, GrowthPolicy>& v, size_t new_size,
+                    Placement placement = Placement::kLocal, ThreadPool& pool = ThreadPool::Default()) {
+    parallel_detail::ParallelGrow(v, new_size, placement, pool, [](Type* p) { std::construct_at(p); });
+}
+
+// То же, но новые элементы — копии value
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void ParallelResize(SimpleVector<Type, Allocator, GrowthPolicy>& v, size_t new_size, const Type& value,
+                    Placement placement = Placement::kLocal, ThreadPool& pool = ThreadPool::Default()) {
+    // Копия снимается заранее: value может быть элементом v, который переедет
+    const Type copy(value);
+    parallel_detail::ParallelGrow(v, new_size, placement, pool, [&copy](Type* p) { std::construct_at(p, copy); });
+}
+
+// Параллельные аналоги SimpleVector(size) и SimpleVector(size, value): создают вектор
+// из size элементов в потоках пула с размещением страниц placement
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+SimpleVector<Type, Allocator, GrowthPolicy> ParallelMakeVector(size_t size, Placement placement = Placement::kLocal,
+                                                               ThreadPool& pool = ThreadPool::Default()) {
+    SimpleVector<Type, Allocator, GrowthPolicy> result;
+    ParallelResize(result, size, placement, pool);
+    return result;
+}
+
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+SimpleVector<Type, Allocator, GrowthPolicy> ParallelMakeVector(size_t size, const Type& value,
+                                                               Placement placement = Placement::kLocal,
+                                                               ThreadPool& pool = ThreadPool::Default()) {
+    SimpleVector<Type, Allocator, GrowthPolicy> result;
+    ParallelResize(result, size, value, placement, pool);
+    return result;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Тип тривиально перемещаем, если перенос объекта в другую память с последующим
+// «забыванием» исходника эквивалентен побайтовому копированию.
+// По умолчанию это так для тривиально копируемых типов. Остальные типы
+// (например, хранящие std::unique_ptr) могут заявить об этом специализацией:
+//     template <> struct IsTriviallyRelocatable<MyType> : std::true_type {};
+template <typename Type>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<Type> {
+};
+
+template <typename Type>
+inline constexpr bool IsTriviallyRelocatableV = IsTriviallyRelocatable<Type>::value;
+
+// Аллокатор может расширить блок на месте, если у него есть метод
+// Type* reallocate(Type* p, size_t old_size, size_t new_size)
+template <typename Allocator>
+concept ReallocatingAllocator = requires(Allocator& alloc, typename Allocator::value_type* p, size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<typename Allocator::value_type*>;
+};
+
+// Побайтовый перенос допустим, только если аллокатор не вмешивается в конструирование элементов
+template <typename Type, typename Allocator>
+inline constexpr bool kRelocateByMemmove = IsTriviallyRelocatableV<Type>
+    && !requires(Allocator& alloc, Type* p) { alloc.construct(p, std::move(*p)); }
+    && !requires(Allocator& alloc, Type* p) { alloc.destroy(p); };
+
+// Переносит count объектов из first в dest одним memmove. Диапазоны могут перекрываться.
+// После вызова объекты живут по адресу dest, а исходная память считается неинициализированной.
+// При вычислении на этапе компиляции memmove недоступен: объекты переносятся через
+// временный буфер перемещением, что верно и для перекрывающихся диапазонов
+template <typename Type>
+constexpr void TriviallyRelocate(Type* first, size_t count, Type* dest) noexcept {
+    if (std::is_constant_evaluated()) {
+        std::allocator<Type> alloc;
+        Type* tmp = alloc.allocate(count);
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(tmp + i, std::move(first[i]));
+            std::destroy_at(first + i);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            std::construct_at(dest + i, std::move(tmp[i]));
+            std::destroy_at(tmp + i);
+        }
+        alloc.deallocate(tmp, count);
+        return;
+    }
+    if (count != 0) {
+        std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), count * sizeof(Type));
+    }
+}
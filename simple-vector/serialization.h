@@ -0,0 +1,515 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "simd.h"
+#include "simple_vector.h"
+
+// Двоичный формат вектора тривиально копируемых элементов:
+// заголовок SerializedHeader из kSerializedHeaderBytes байт, за которым без промежутков
+// идут байты элементов. Числа пишутся в порядке байтов машины, а элементы начинаются
+// со смещения, кратного 64, поэтому буфер, выровненный на alignof(Type), можно читать на месте.
+// Контрольная сумма — CRC32C байтов элементов
+struct SerializedHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t element_size;
+    uint64_t count;
+    uint32_t alignment;
+    uint32_t checksum;
+    uint8_t reserved[32];
+};
+
+inline constexpr size_t kSerializedHeaderBytes = 64;
+static_assert(sizeof(SerializedHeader) == kSerializedHeaderBytes);
+
+namespace serialization_detail {
+
+inline constexpr uint64_t kMagic = 0x524556434556535f;  // "_SVECVER"
+inline constexpr uint32_t kVersion = 1;
+// Отражённый полином CRC32C (Castagnoli)
+inline constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+template <typename Type>
+void CheckSerializable() {
+    static_assert(std::is_trivially_copyable_v<Type>, "only trivially copyable types are serialized as raw bytes");
+    static_assert(alignof(Type) <= kSerializedHeaderBytes, "serialized elements support alignment up to 64 bytes");
+}
+
+// Таблицы для табличного CRC32C по 8 байт за шаг (slicing-by-8):
+// table[k][b] — вклад байта b, за которым следуют ещё k байт
+constexpr std::array<std::array<uint32_t, 256>, 8> MakeCrc32cTables() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t byte = 0; byte < 256; ++byte) {
+        uint32_t crc = byte;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (crc & 1 ? kCrc32cPolynomial : 0);
+        }
+        tables[0][byte] = crc;
+    }
+    for (size_t k = 1; k < 8; ++k) {
+        for (size_t byte = 0; byte < 256; ++byte) {
+            const uint32_t prev = tables[k - 1][byte];
+            tables[k][byte] = (prev >> 8) ^ tables[0][prev & 0xff];
+        }
+    }
+    return tables;
+}
+
+inline uint32_t Crc32cScalar(uint32_t crc, const unsigned char* data, size_t bytes) noexcept {
+    static constexpr std::array<std::array<uint32_t, 256>, 8> kTables = MakeCrc32cTables();
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        const unsigned char* d = data + i;
+        crc ^= uint32_t(d[0]) | uint32_t(d[1]) << 8 | uint32_t(d[2]) << 16 | uint32_t(d[3]) << 24;
+        crc = kTables[7][crc & 0xff] ^ kTables[6][(crc >> 8) & 0xff] ^ kTables[5][(crc >> 16) & 0xff]
+            ^ kTables[4][crc >> 24] ^ kTables[3][d[4]] ^ kTables[2][d[5]] ^ kTables[1][d[6]] ^ kTables[0][d[7]];
+    }
+    for (; i < bytes; ++i) {
+        crc = kTables[0][(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if defined(SIMPLE_VECTOR_X86_SIMD) && defined(__x86_64__)
+#define SIMPLE_VECTOR_HARDWARE_CRC32C 1
+
+// Команда crc32 из SSE4.2 обрабатывает 8 байт за раз
+__attribute__((target("sse4.2"))) inline uint32_t Crc32cSse42(uint32_t crc, const unsigned char* data,
+                                                               size_t bytes) noexcept {
+    uint64_t crc64 = crc;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+    crc = static_cast<uint32_t>(crc64);
+    for (; i < bytes; ++i) {
+        crc = _mm_crc32_u8(crc, data[i]);
+    }
+    return crc;
+}
+#endif
+
+}  // namespace serialization_detail
+
+// Накопитель CRC32C: данные можно подавать частями произвольной длины.
+// Использует команду crc32, если процессор поддерживает SSE4.2 и векторные ядра
+// не отключены через simd::SetSimdLevel(kScalar), иначе — табличный алгоритм
+class Crc32c {
+public:
+    void Update(const void* data, size_t bytes) noexcept {
+        const auto* p = static_cast<const unsigned char*>(data);
+#ifdef SIMPLE_VECTOR_HARDWARE_CRC32C
+        static const bool kHardware = __builtin_cpu_supports("sse4.2");
+        if (kHardware && simd::GetSimdLevel() != simd::SimdLevel::kScalar) {
+            crc_ = serialization_detail::Crc32cSse42(crc_, p, bytes);
+            return;
+        }
+#endif
+        crc_ = serialization_detail::Crc32cScalar(crc_, p, bytes);
+    }
+
+    uint32_t Get() const noexcept {
+        return ~crc_;
+    }
+
+private:
+    uint32_t crc_ = ~uint32_t(0);
+};
+
+// Возвращает CRC32C bytes байт, начиная с data
+inline uint32_t ComputeCrc32c(const void* data, size_t bytes) noexcept {
+    Crc32c crc;
+    crc.Update(data, bytes);
+    return crc.Get();
+}
+
+namespace serialization_detail {
+
+template <typename Type>
+SerializedHeader MakeHeader(uint64_t count, uint32_t checksum) noexcept {
+    SerializedHeader header{};
+    header.magic = kMagic;
+    header.version = kVersion;
+    header.element_size = sizeof(Type);
+    header.count = count;
+    header.alignment = alignof(Type);
+    header.checksum = checksum;
+    return header;
+}
+
+// Проверяет заголовок и возвращает размер данных в байтах.
+// available — сколько байт данных доступно после заголовка, если это известно
+template <typename Type>
+size_t ValidateHeader(const SerializedHeader& header, size_t available = SIZE_MAX) {
+    if (header.magic != kMagic) {
+        throw std::runtime_error("not a serialized vector");
+    }
+    if (header.version != kVersion) {
+        throw std::runtime_error("unsupported serialized vector version");
+    }
+    if (header.element_size != sizeof(Type) || header.alignment != alignof(Type)) {
+        throw std::runtime_error("serialized vector element type mismatch");
+    }
+    if (header.count > available / sizeof(Type)) {
+        throw std::runtime_error("serialized vector is truncated");
+    }
+    return static_cast<size_t>(header.count) * sizeof(Type);
+}
+
+inline void WriteBytes(std::ostream& out, const void* data, size_t bytes) {
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    if (!out) {
+        throw std::runtime_error("failed to write serialized vector");
+    }
+}
+
+inline void ReadBytes(std::istream& in, void* data, size_t bytes) {
+    in.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+    if (static_cast<size_t>(in.gcount()) != bytes) {
+        throw std::runtime_error("serialized vector is truncated");
+    }
+}
+
+// Сколько байт осталось в потоке до конца, или SIZE_MAX, если поток не перематывается
+inline size_t RemainingBytes(std::istream& in) {
+    const std::streampos pos = in.tellg();
+    if (pos == std::streampos(-1)) {
+        return SIZE_MAX;
+    }
+    in.seekg(0, std::ios::end);
+    const std::streampos end = in.tellg();
+    in.clear();
+    in.seekg(pos);
+    if (end == std::streampos(-1) || !in) {
+        in.clear();
+        return SIZE_MAX;
+    }
+    return static_cast<size_t>(end - pos);
+}
+
+// Данные без известной длины читаются частями такого размера: память выделяется по мере
+// поступления байтов, а не по числу элементов из заголовка, которому нельзя доверять
+inline constexpr size_t kReadChunkBytes = size_t(1) << 20;
+
+inline void CheckChecksum(uint32_t expected, uint32_t actual) {
+    if (expected != actual) {
+        throw std::runtime_error("serialized vector checksum mismatch");
+    }
+}
+
+}  // namespace serialization_detail
+
+// Пишет вектор в out: заголовок и все элементы одной записью.
+// Контрольная сумма считается отдельным проходом до записи, поэтому поток не обязан
+// поддерживать перемотку. Выбрасывает std::runtime_error при ошибке записи
+template <typename Type, typename Allocator, typename GrowthPolicy>
+void Serialize(std::ostream& out, const SimpleVector<Type, Allocator, GrowthPolicy>& v) {
+    serialization_detail::CheckSerializable<Type>();
+    const size_t bytes = v.GetSize() * sizeof(Type);
+    const SerializedHeader header = serialization_detail::MakeHeader<Type>(v.GetSize(), ComputeCrc32c(v.GetData(), bytes));
+    serialization_detail::WriteBytes(out, &header, sizeof(header));
+    serialization_detail::WriteBytes(out, v.GetData(), bytes);
+}
+
+// Читает вектор, записанный Serialize или SerializedWriter: элементы читаются прямо
+// в память вектора. Если поток перематывается, число элементов из заголовка сверяется
+// с длиной потока и память выделяется сразу; иначе вектор растёт частями по мере чтения,
+// и повреждённый заголовок не заставит выделить память под несуществующие данные.
+// Выбрасывает std::runtime_error, если данные не являются вектором элементов Type,
+// обрезаны или не сходится контрольная сумма
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+SimpleVector<Type, Allocator, GrowthPolicy> Deserialize(std::istream& in) {
+    serialization_detail::CheckSerializable<Type>();
+    SerializedHeader header;
+    serialization_detail::ReadBytes(in, &header, sizeof(header));
+    const size_t available = serialization_detail::RemainingBytes(in);
+    serialization_detail::ValidateHeader<Type>(header, available);
+    const size_t count = static_cast<size_t>(header.count);
+    const size_t chunk = available != SIZE_MAX
+        ? count
+        : std::max<size_t>(1, serialization_detail::kReadChunkBytes / sizeof(Type));
+    SimpleVector<Type, Allocator, GrowthPolicy> v;
+    Crc32c crc;
+    while (v.GetSize() < count) {
+        const size_t n = std::min(chunk, count - v.GetSize());
+        v.AppendConstructed(n, [&in, &crc](Type* first, size_t appended) {
+            serialization_detail::ReadBytes(in, first, appended * sizeof(Type));
+            crc.Update(first, appended * sizeof(Type));
+        });
+    }
+    serialization_detail::CheckChecksum(header.checksum, crc.Get());
+    return v;
+}
+
+// Вектор только для чтения поверх сериализованных данных в чужом буфере, например
+// в отображённом файле. Элементы не копируются: буфер должен быть выровнен
+// на alignof(Type) и жить дольше представления
+template <typename Type>
+class SerializedView {
+public:
+    using ConstIterator = const Type*;
+
+    SerializedView() noexcept = default;
+
+    // Проверяет заголовок, выравнивание и, если verify_checksum, контрольную сумму.
+    // Проверка суммы читает все данные, без неё создание представления стоит O(1).
+    // Выбрасывает std::runtime_error, если буфер не содержит вектор элементов Type
+    SerializedView(const void* buffer, size_t bytes, bool verify_checksum = true) {
+        serialization_detail::CheckSerializable<Type>();
+        if (bytes < kSerializedHeaderBytes) {
+            throw std::runtime_error("serialized vector is truncated");
+        }
+        if (reinterpret_cast<uintptr_t>(buffer) % alignof(Type) != 0) {
+            throw std::runtime_error("serialized vector buffer is misaligned");
+        }
+        SerializedHeader header;
+        std::memcpy(&header, buffer, sizeof(header));
+        const size_t data_bytes = serialization_detail::ValidateHeader<Type>(header, bytes - kSerializedHeaderBytes);
+        data_ = reinterpret_cast<const Type*>(static_cast<const char*>(buffer) + kSerializedHeaderBytes);
+        size_ = static_cast<size_t>(header.count);
+        if (verify_checksum) {
+            serialization_detail::CheckChecksum(header.checksum, ComputeCrc32c(data_, data_bytes));
+        }
+    }
+
+    // Возвращает количество элементов
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Сообщает, пусто ли представление
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("index >= size"); }
+        return data_[index];
+    }
+
+    // Копирует элементы в обычный вектор
+    template <typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
+    SimpleVector<Type, Allocator, GrowthPolicy> ToVector() const {
+        SimpleVector<Type, Allocator, GrowthPolicy> v;
+        v.AppendConstructed(size_, [this](Type* first, size_t count) {
+            std::memcpy(static_cast<void*>(first), data_, count * sizeof(Type));
+        });
+        return v;
+    }
+
+    ConstIterator begin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator end() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    const Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Файл с сериализованным вектором, отображённый в память только для чтения.
+// Страницы подгружаются при первом обращении, поэтому без проверки контрольной суммы
+// открытие не зависит от размера файла. Выбрасывает std::system_error при ошибке
+// системного вызова и std::runtime_error, если файл не содержит вектор элементов Type
+template <typename Type>
+class SerializedFile {
+public:
+    explicit SerializedFile(const std::string& path, bool verify_checksum = true) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "open");
+        }
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat");
+        }
+        bytes_ = static_cast<size_t>(st.st_size);
+        void* p = bytes_ != 0 ? ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0) : nullptr;
+        const int error = errno;
+        // Отображение остаётся действительным и после закрытия файла
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+        base_ = p;
+        try {
+            view_ = SerializedView<Type>(base_, bytes_, verify_checksum);
+        }
+        catch (...) {
+            Unmap();
+            throw;
+        }
+    }
+
+    SerializedFile(const SerializedFile&) = delete;
+    SerializedFile& operator=(const SerializedFile&) = delete;
+
+    ~SerializedFile() {
+        Unmap();
+    }
+
+    // Возвращает представление элементов файла
+    const SerializedView<Type>& GetView() const noexcept {
+        return view_;
+    }
+
+private:
+    void Unmap() noexcept {
+        if (base_ != nullptr) {
+            ::munmap(base_, bytes_);
+            base_ = nullptr;
+        }
+    }
+
+    void* base_ = nullptr;
+    size_t bytes_ = 0;
+    SerializedView<Type> view_;
+};
+
+// Пишет вектор в поток частями, не держа его в памяти целиком.
+// Число элементов и контрольная сумма известны только в конце, поэтому сначала пишется
+// заголовок-заглушка, а Finish() перематывает поток и дописывает его: поток должен
+// поддерживать seekp. Без вызова Finish() записанные данные не читаются
+template <typename Type>
+class SerializedWriter {
+public:
+    explicit SerializedWriter(std::ostream& out)
+        : out_(out),
+        start_(out.tellp()) {
+        serialization_detail::CheckSerializable<Type>();
+        if (start_ == std::streampos(-1)) {
+            throw std::runtime_error("serialized vector stream is not seekable");
+        }
+        const SerializedHeader placeholder{};
+        serialization_detail::WriteBytes(out_, &placeholder, sizeof(placeholder));
+    }
+
+    // Дописывает count элементов, начиная с data
+    void Write(const Type* data, size_t count) {
+        assert(!finished_);
+        const size_t bytes = count * sizeof(Type);
+        crc_.Update(data, bytes);
+        serialization_detail::WriteBytes(out_, data, bytes);
+        count_ += count;
+    }
+
+    template <typename Allocator, typename GrowthPolicy>
+    void Write(const SimpleVector<Type, Allocator, GrowthPolicy>& chunk) {
+        Write(chunk.GetData(), chunk.GetSize());
+    }
+
+    // Записывает заголовок и возвращает поток в конец данных
+    void Finish() {
+        assert(!finished_);
+        const std::streampos end = out_.tellp();
+        const SerializedHeader header = serialization_detail::MakeHeader<Type>(count_, crc_.Get());
+        out_.seekp(start_);
+        serialization_detail::WriteBytes(out_, &header, sizeof(header));
+        out_.seekp(end);
+        finished_ = true;
+    }
+
+    // Количество записанных элементов
+    size_t GetSize() const noexcept {
+        return count_;
+    }
+
+private:
+    std::ostream& out_;
+    std::streampos start_;
+    size_t count_ = 0;
+    Crc32c crc_;
+    bool finished_ = false;
+};
+
+// Читает сериализованный вектор частями. Контрольная сумма проверяется первым
+// вызовом Read, после которого непрочитанных элементов не осталось, в том числе
+// для пустого вектора
+template <typename Type>
+class SerializedReader {
+public:
+    // Читает и проверяет заголовок
+    explicit SerializedReader(std::istream& in)
+        : in_(in) {
+        serialization_detail::CheckSerializable<Type>();
+        serialization_detail::ReadBytes(in_, &header_, sizeof(header_));
+        serialization_detail::ValidateHeader<Type>(header_);
+    }
+
+    // Общее количество элементов в потоке
+    size_t GetSize() const noexcept {
+        return static_cast<size_t>(header_.count);
+    }
+
+    // Количество ещё не прочитанных элементов
+    size_t GetRemaining() const noexcept {
+        return GetSize() - read_;
+    }
+
+    // Читает до max_count элементов в dest и возвращает, сколько прочитано; 0 — конец данных.
+    // Выбрасывает std::runtime_error, если данные обрезаны или не сошлась контрольная сумма
+    size_t Read(Type* dest, size_t max_count) {
+        const size_t count = std::min(max_count, GetRemaining());
+        const size_t bytes = count * sizeof(Type);
+        serialization_detail::ReadBytes(in_, dest, bytes);
+        crc_.Update(dest, bytes);
+        read_ += count;
+        if (GetRemaining() == 0 && !verified_) {
+            serialization_detail::CheckChecksum(header_.checksum, crc_.Get());
+            verified_ = true;
+        }
+        return count;
+    }
+
+    // Заменяет содержимое chunk следующими не более чем max_count элементами
+    template <typename Allocator, typename GrowthPolicy>
+    size_t Read(SimpleVector<Type, Allocator, GrowthPolicy>& chunk, size_t max_count) {
+        chunk.Clear();
+        const size_t count = std::min(max_count, GetRemaining());
+        chunk.AppendConstructed(count, [this](Type* first, size_t n) {
+            Read(first, n);
+        });
+        return count;
+    }
+
+private:
+    std::istream& in_;
+    SerializedHeader header_{};
+    size_t read_ = 0;
+    Crc32c crc_;
+    bool verified_ = false;
+};
@@ -0,0 +1,577 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SIMPLE_VECTOR_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+// Векторные ядра сравнения, поиска и свёртки для массивов целых чисел.
+// На x86 есть реализации на SSE2 и AVX2; нужная выбирается во время выполнения
+// по возможностям процессора, на других платформах работают скалярные циклы.
+// Для чисел с плавающей точкой ядра не применяются: у них == не совпадает
+// с побайтовым равенством, а векторная сумма меняет порядок округлений
+namespace simd {
+
+// Целые типы, кроме bool, которые обрабатываются векторными ядрами
+template <typename Type>
+inline constexpr bool kVectorizable = std::is_integral_v<Type> && !std::is_same_v<Type, bool>;
+
+// Тип суммы: целые складываются в 64-битной арифметике
+template <typename Type>
+using SumType = std::conditional_t<std::is_signed_v<Type>, int64_t, uint64_t>;
+
+enum class SimdLevel {
+    kScalar,
+    kSse2,
+    kAvx2,
+};
+
+// Лучший набор инструкций, доступный на этом процессоре
+inline SimdLevel DetectSimdLevel() noexcept {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return SimdLevel::kAvx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::kSse2;
+    }
+#endif
+    return SimdLevel::kScalar;
+}
+
+namespace detail {
+
+inline std::atomic<SimdLevel>& ActiveLevel() noexcept {
+    static std::atomic<SimdLevel> level{DetectSimdLevel()};
+    return level;
+}
+
+}  // namespace detail
+
+// Набор инструкций, которым сейчас пользуются ядра
+inline SimdLevel GetSimdLevel() noexcept {
+    return detail::ActiveLevel().load(std::memory_order_relaxed);
+}
+
+// Ограничивает ядра набором инструкций level (но не выше доступного процессору).
+// Нужно тестам и замерам, чтобы сравнить реализации между собой
+inline void SetSimdLevel(SimdLevel level) noexcept {
+    detail::ActiveLevel().store(std::min(level, DetectSimdLevel()), std::memory_order_relaxed);
+}
+
+namespace scalar {
+
+inline size_t MismatchBytes(const unsigned char* a, const unsigned char* b, size_t bytes) noexcept {
+    if (bytes == 0 || std::memcmp(a, b, bytes) == 0) {
+        return bytes;
+    }
+    size_t i = 0;
+    while (i < bytes && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+template <typename T>
+size_t Find(const T* data, size_t count, T value) noexcept {
+    size_t i = 0;
+    while (i < count && data[i] != value) {
+        ++i;
+    }
+    return i;
+}
+
+template <typename T>
+size_t Count(const T* data, size_t count, T value) noexcept {
+    return static_cast<size_t>(std::count(data, data + count, value));
+}
+
+template <bool kMax, typename T>
+T MinMax(const T* data, size_t count) noexcept {
+    return kMax ? *std::max_element(data, data + count) : *std::min_element(data, data + count);
+}
+
+template <typename T>
+SumType<T> Sum(const T* data, size_t count) noexcept {
+    // Беззнаковое сложение не переполняется, а результат совпадает с 64-битной суммой
+    uint64_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+        result += static_cast<uint64_t>(static_cast<SumType<T>>(data[i]));
+    }
+    return static_cast<SumType<T>>(result);
+}
+
+inline size_t PopCount(const uint64_t* words, size_t count) noexcept {
+    size_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+        result += static_cast<size_t>(std::popcount(words[i]));
+    }
+    return result;
+}
+
+}  // namespace scalar
+
+#ifdef SIMPLE_VECTOR_X86_SIMD
+
+namespace sse2 {
+
+struct Isa {
+    using Reg = __m128i;
+    static constexpr size_t kBytes = 16;
+    static constexpr uint32_t kFullMask = 0xFFFF;
+
+    static Reg Load(const void* p) noexcept {
+        return _mm_loadu_si128(static_cast<const Reg*>(p));
+    }
+    static void Store(void* p, Reg r) noexcept {
+        _mm_storeu_si128(static_cast<Reg*>(p), r);
+    }
+    static Reg Zero() noexcept {
+        return _mm_setzero_si128();
+    }
+    template <typename T>
+    static Reg Set1(T value) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return _mm_set1_epi8(static_cast<char>(value));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm_set1_epi16(static_cast<short>(value));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm_set1_epi32(static_cast<int>(value));
+        }
+        else {
+            return _mm_set1_epi64x(static_cast<long long>(value));
+        }
+    }
+    static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm_xor_si128(a, b);
+    }
+    // Для каждой позиции берёт a, если в mask единицы, иначе b
+    static Reg Select(Reg mask, Reg a, Reg b) noexcept {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    template <size_t kSize>
+    static Reg CmpEq(Reg a, Reg b) noexcept {
+        if constexpr (kSize == 1) {
+            return _mm_cmpeq_epi8(a, b);
+        }
+        else if constexpr (kSize == 2) {
+            return _mm_cmpeq_epi16(a, b);
+        }
+        else if constexpr (kSize == 4) {
+            return _mm_cmpeq_epi32(a, b);
+        }
+        else {
+            // 64-битные числа равны, когда равны обе их 32-битные половины
+            const Reg eq = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+    // Знаковое сравнение a > b
+    template <size_t kSize>
+    static Reg CmpGt(Reg a, Reg b) noexcept {
+        if constexpr (kSize == 1) {
+            return _mm_cmpgt_epi8(a, b);
+        }
+        else if constexpr (kSize == 2) {
+            return _mm_cmpgt_epi16(a, b);
+        }
+        else if constexpr (kSize == 4) {
+            return _mm_cmpgt_epi32(a, b);
+        }
+        else {
+            // Старшие половины решают, если различаются, иначе решает знак b - a
+            Reg r = _mm_and_si128(_mm_cmpeq_epi32(a, b), _mm_sub_epi64(b, a));
+            r = _mm_or_si128(r, _mm_cmpgt_epi32(a, b));
+            return _mm_shuffle_epi32(_mm_srai_epi32(r, 31), _MM_SHUFFLE(3, 3, 1, 1));
+        }
+    }
+    static uint32_t MoveMask(Reg r) noexcept {
+        return static_cast<uint32_t>(_mm_movemask_epi8(r));
+    }
+    static Reg Add64(Reg a, Reg b) noexcept {
+        return _mm_add_epi64(a, b);
+    }
+    // Суммы каждых восьми беззнаковых байтов в 64-битных позициях
+    static Reg SadU8(Reg a) noexcept {
+        return _mm_sad_epu8(a, _mm_setzero_si128());
+    }
+    // Количество единичных битов в каждом байте: попарные суммы битов, затем пар и четвёрок
+    static Reg PopCountBytes(Reg a) noexcept {
+        const Reg m1 = _mm_set1_epi8(0x55);
+        const Reg m2 = _mm_set1_epi8(0x33);
+        const Reg m4 = _mm_set1_epi8(0x0F);
+        a = _mm_sub_epi8(a, _mm_and_si128(_mm_srli_epi64(a, 1), m1));
+        a = _mm_add_epi8(_mm_and_si128(a, m2), _mm_and_si128(_mm_srli_epi64(a, 2), m2));
+        return _mm_and_si128(_mm_add_epi8(a, _mm_srli_epi64(a, 4)), m4);
+    }
+    // Суммы соседних пар знаковых 16-битных чисел в 32-битных позициях
+    static Reg MaddI16(Reg a) noexcept {
+        return _mm_madd_epi16(a, _mm_set1_epi16(1));
+    }
+    // Суммы пар 32-битных чисел, расширенные до 64 бит
+    template <bool kSigned>
+    static Reg Widen32(Reg a) noexcept {
+        const Reg ext = kSigned ? _mm_srai_epi32(a, 31) : _mm_setzero_si128();
+        return _mm_add_epi64(_mm_unpacklo_epi32(a, ext), _mm_unpackhi_epi32(a, ext));
+    }
+    template <size_t kSize>
+    static Reg Sub(Reg a, Reg b) noexcept {
+        if constexpr (kSize == 1) {
+            return _mm_sub_epi8(a, b);
+        }
+        else if constexpr (kSize == 2) {
+            return _mm_sub_epi16(a, b);
+        }
+        else if constexpr (kSize == 4) {
+            return _mm_sub_epi32(a, b);
+        }
+        else {
+            return _mm_sub_epi64(a, b);
+        }
+    }
+    // Наименьшее или наибольшее из a и b в каждой позиции. Где нет готовой команды,
+    // беззнаковые числа сравниваются знаковой командой после инверсии старшего бита
+    template <bool kMax, typename T>
+    static Reg MinMax(Reg a, Reg b) noexcept {
+        if constexpr (std::is_unsigned_v<T> && sizeof(T) == 1) {
+            return kMax ? _mm_max_epu8(a, b) : _mm_min_epu8(a, b);
+        }
+        else if constexpr (std::is_signed_v<T> && sizeof(T) == 2) {
+            return kMax ? _mm_max_epi16(a, b) : _mm_min_epi16(a, b);
+        }
+        else {
+            const Reg flip = Set1(std::is_signed_v<T> ? T(0) : T(T(1) << (sizeof(T) * 8 - 1)));
+            const Reg a_greater = CmpGt<sizeof(T)>(Xor(a, flip), Xor(b, flip));
+            return kMax ? Select(a_greater, a, b) : Select(a_greater, b, a);
+        }
+    }
+    // Сумма неотрицательных счётчиков размера kSize по всем позициям регистра
+    template <size_t kSize>
+    static size_t HorizontalSum(Reg counters) noexcept {
+        Reg sums;
+        if constexpr (kSize == 1) {
+            sums = SadU8(counters);
+        }
+        else if constexpr (kSize == 2) {
+            sums = Widen32<false>(MaddI16(counters));
+        }
+        else if constexpr (kSize == 4) {
+            sums = Widen32<false>(counters);
+        }
+        else {
+            sums = counters;
+        }
+        uint64_t lanes[kBytes / 8];
+        Store(lanes, sums);
+        uint64_t result = 0;
+        for (const uint64_t lane : lanes) {
+            result += lane;
+        }
+        return static_cast<size_t>(result);
+    }
+};
+
+#include "simd_kernels.inc"
+
+}  // namespace sse2
+
+// Ядра AVX2 компилируются для AVX2 без -mavx2, а вызываются только после проверки процессора.
+// Clang не поддерживает #pragma GCC target, поэтому атрибут target навешивается на каждую
+// функцию блока через #pragma clang attribute
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,popcnt"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,popcnt")
+#endif
+
+namespace avx2 {
+
+struct Isa {
+    using Reg = __m256i;
+    static constexpr size_t kBytes = 32;
+    static constexpr uint32_t kFullMask = 0xFFFFFFFF;
+
+    static Reg Load(const void* p) noexcept {
+        return _mm256_loadu_si256(static_cast<const Reg*>(p));
+    }
+    static void Store(void* p, Reg r) noexcept {
+        _mm256_storeu_si256(static_cast<Reg*>(p), r);
+    }
+    static Reg Zero() noexcept {
+        return _mm256_setzero_si256();
+    }
+    template <typename T>
+    static Reg Set1(T value) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            return _mm256_set1_epi8(static_cast<char>(value));
+        }
+        else if constexpr (sizeof(T) == 2) {
+            return _mm256_set1_epi16(static_cast<short>(value));
+        }
+        else if constexpr (sizeof(T) == 4) {
+            return _mm256_set1_epi32(static_cast<int>(value));
+        }
+        else {
+            return _mm256_set1_epi64x(static_cast<long long>(value));
+        }
+    }
+    static Reg Xor(Reg a, Reg b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+    static Reg Select(Reg mask, Reg a, Reg b) noexcept {
+        return _mm256_blendv_epi8(b, a, mask);
+    }
+    template <size_t kSize>
+    static Reg CmpEq(Reg a, Reg b) noexcept {
+        if constexpr (kSize == 1) {
+            return _mm256_cmpeq_epi8(a, b);
+        }
+        else if constexpr (kSize == 2) {
+            return _mm256_cmpeq_epi16(a, b);
+        }
+        else if constexpr (kSize == 4) {
+            return _mm256_cmpeq_epi32(a, b);
+        }
+        else {
+            return _mm256_cmpeq_epi64(a, b);
+        }
+    }
+    template <size_t kSize>
+    static Reg CmpGt(Reg a, Reg b) noexcept {
+        if constexpr (kSize == 1) {
+            return _mm256_cmpgt_epi8(a, b);
+        }
+        else if constexpr (kSize == 2) {
+            return _mm256_cmpgt_epi16(a, b);
+        }
+        else if constexpr (kSize == 4) {
+            return _mm256_cmpgt_epi32(a, b);
+        }
+        else {
+            return _mm256_cmpgt_epi64(a, b);
+        }
+    }
+    static uint32_t MoveMask(Reg r) noexcept {
+        return static_cast<uint32_t>(_mm256_movemask_epi8(r));
+    }
+    static Reg Add64(Reg a, Reg b) noexcept {
+        return _mm256_add_epi64(a, b);
+    }
+    static Reg SadU8(Reg a) noexcept {
+        return _mm256_sad_epu8(a, _mm256_setzero_si256());
+    }
+    // Количество единичных битов в каждом байте по таблице для младшей и старшей тетрад
+    static Reg PopCountBytes(Reg a) noexcept {
+        const Reg table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                           0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const Reg low = _mm256_set1_epi8(0x0F);
+        return _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(a, low)),
+                               _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(a, 4), low)));
+    }
+    static Reg MaddI16(Reg a) noexcept {
+        return _mm256_madd_epi16(a, _mm256_set1_epi16(1));
+    }
+    template <bool kSigned>
+    static Reg Widen32(Reg a) noexcept {
+        const Reg ext = kSigned ? _mm256_srai_epi32(a, 31) : _mm256_setzero_si256();
+        return _mm256_add_epi64(_mm256_unpacklo_epi32(a, ext), _mm256_unpackhi_epi32(a, ext));
+    }
+    template <size_t kSize>
+    static Reg Sub(Reg a, Reg b) noexcept {
+        if constexpr (kSize == 1) {
+            return _mm256_sub_epi8(a, b);
+        }
+        else if constexpr (kSize == 2) {
+            return _mm256_sub_epi16(a, b);
+        }
+        else if constexpr (kSize == 4) {
+            return _mm256_sub_epi32(a, b);
+        }
+        else {
+            return _mm256_sub_epi64(a, b);
+        }
+    }
+    template <bool kMax, typename T>
+    static Reg MinMax(Reg a, Reg b) noexcept {
+        if constexpr (sizeof(T) == 1) {
+            if constexpr (std::is_signed_v<T>) {
+                return kMax ? _mm256_max_epi8(a, b) : _mm256_min_epi8(a, b);
+            }
+            else {
+                return kMax ? _mm256_max_epu8(a, b) : _mm256_min_epu8(a, b);
+            }
+        }
+        else if constexpr (sizeof(T) == 2) {
+            if constexpr (std::is_signed_v<T>) {
+                return kMax ? _mm256_max_epi16(a, b) : _mm256_min_epi16(a, b);
+            }
+            else {
+                return kMax ? _mm256_max_epu16(a, b) : _mm256_min_epu16(a, b);
+            }
+        }
+        else if constexpr (sizeof(T) == 4) {
+            if constexpr (std::is_signed_v<T>) {
+                return kMax ? _mm256_max_epi32(a, b) : _mm256_min_epi32(a, b);
+            }
+            else {
+                return kMax ? _mm256_max_epu32(a, b) : _mm256_min_epu32(a, b);
+            }
+        }
+        else {
+            const Reg flip = Set1(std::is_signed_v<T> ? T(0) : T(T(1) << 63));
+            const Reg a_greater = CmpGt<8>(Xor(a, flip), Xor(b, flip));
+            return kMax ? Select(a_greater, a, b) : Select(a_greater, b, a);
+        }
+    }
+    // Сумма неотрицательных счётчиков размера kSize по всем позициям регистра
+    template <size_t kSize>
+    static size_t HorizontalSum(Reg counters) noexcept {
+        Reg sums;
+        if constexpr (kSize == 1) {
+            sums = SadU8(counters);
+        }
+        else if constexpr (kSize == 2) {
+            sums = Widen32<false>(MaddI16(counters));
+        }
+        else if constexpr (kSize == 4) {
+            sums = Widen32<false>(counters);
+        }
+        else {
+            sums = counters;
+        }
+        uint64_t lanes[kBytes / 8];
+        Store(lanes, sums);
+        uint64_t result = 0;
+        for (const uint64_t lane : lanes) {
+            result += lane;
+        }
+        return static_cast<size_t>(result);
+    }
+};
+
+#include "simd_kernels.inc"
+
+}  // namespace avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif  // SIMPLE_VECTOR_X86_SIMD
+
+namespace detail {
+
+// Вызывает реализацию ядра для текущего набора инструкций.
+// Данных меньше одного регистра SSE2 сразу отдаются скалярному циклу
+template <typename Scalar, typename Sse2, typename Avx2>
+decltype(auto) Dispatch(size_t bytes, Scalar scalar, [[maybe_unused]] Sse2 sse2, [[maybe_unused]] Avx2 avx2) {
+#ifdef SIMPLE_VECTOR_X86_SIMD
+    if (bytes >= 16) {
+        switch (GetSimdLevel()) {
+            case SimdLevel::kAvx2:
+                if (bytes >= 32) {
+                    return avx2();
+                }
+                return sse2();
+            case SimdLevel::kSse2:
+                return sse2();
+            case SimdLevel::kScalar:
+                break;
+        }
+    }
+#else
+    (void)bytes;
+#endif
+    return scalar();
+}
+
+}  // namespace detail
+
+#ifdef SIMPLE_VECTOR_X86_SIMD
+#define SIMPLE_VECTOR_SIMD_DISPATCH(bytes, call) \
+    detail::Dispatch((bytes), [&] { return scalar::call; }, [&] { return sse2::call; }, [&] { return avx2::call; })
+#else
+#define SIMPLE_VECTOR_SIMD_DISPATCH(bytes, call) \
+    detail::Dispatch((bytes), [&] { return scalar::call; }, [] {}, [] {})
+#endif
+
+// Возвращает индекс первого элемента, в котором a и b различаются, или count
+template <typename T>
+size_t Mismatch(const T* a, const T* b, size_t count) noexcept {
+    static_assert(kVectorizable<T>);
+    const size_t bytes = count * sizeof(T);
+    const auto* a_bytes = reinterpret_cast<const unsigned char*>(a);
+    const auto* b_bytes = reinterpret_cast<const unsigned char*>(b);
+    return SIMPLE_VECTOR_SIMD_DISPATCH(bytes, MismatchBytes(a_bytes, b_bytes, bytes)) / sizeof(T);
+}
+
+// Сообщает, равны ли count элементов a и b
+template <typename T>
+bool Equal(const T* a, const T* b, size_t count) noexcept {
+    return Mismatch(a, b, count) == count;
+}
+
+// Лексикографическое сравнение [a, a + a_count) < [b, b + b_count)
+template <typename T>
+bool LexicographicalLess(const T* a, size_t a_count, const T* b, size_t b_count) noexcept {
+    const size_t common = std::min(a_count, b_count);
+    const size_t i = Mismatch(a, b, common);
+    return i < common ? a[i] < b[i] : a_count < b_count;
+}
+
+// Возвращает индекс первого элемента, равного value, или count
+template <typename T>
+size_t Find(const T* data, size_t count, T value) noexcept {
+    static_assert(kVectorizable<T>);
+    return SIMPLE_VECTOR_SIMD_DISPATCH(count * sizeof(T), Find(data, count, value));
+}
+
+// Возвращает количество элементов, равных value
+template <typename T>
+size_t Count(const T* data, size_t count, T value) noexcept {
+    static_assert(kVectorizable<T>);
+    return SIMPLE_VECTOR_SIMD_DISPATCH(count * sizeof(T), Count(data, count, value));
+}
+
+// Возвращает наименьший элемент непустого диапазона
+template <typename T>
+T Min(const T* data, size_t count) noexcept {
+    static_assert(kVectorizable<T>);
+    return SIMPLE_VECTOR_SIMD_DISPATCH(count * sizeof(T), MinMax<false>(data, count));
+}
+
+// Возвращает наибольший элемент непустого диапазона
+template <typename T>
+T Max(const T* data, size_t count) noexcept {
+    static_assert(kVectorizable<T>);
+    return SIMPLE_VECTOR_SIMD_DISPATCH(count * sizeof(T), MinMax<true>(data, count));
+}
+
+// Возвращает сумму элементов в 64-битной арифметике (по модулю 2^64)
+template <typename T>
+SumType<T> Sum(const T* data, size_t count) noexcept {
+    static_assert(kVectorizable<T>);
+    return SIMPLE_VECTOR_SIMD_DISPATCH(count * sizeof(T), Sum(data, count));
+}
+
+// Возвращает количество единичных битов в count 64-битных словах
+inline size_t PopCount(const uint64_t* words, size_t count) noexcept {
+    return SIMPLE_VECTOR_SIMD_DISPATCH(count * sizeof(uint64_t), PopCount(words, count));
+}
+
+#undef SIMPLE_VECTOR_SIMD_DISPATCH
+
+}  // namespace simd
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+#include "simd.h"
+
+// Невладеющее представление непрерывного диапазона элементов: указатель и длина.
+// Копируется за O(1), срезы Subspan, First и Last не выделяют память.
+// SimpleSpan<const Type> (ConstSimpleSpan<Type>) даёт доступ только для чтения,
+// SimpleSpan<Type> неявно преобразуется в него. SimpleVector неявно преобразуется в оба.
+// Представление действительно, пока жив диапазон и его элементы не переехали
+template <typename Type>
+class SimpleSpan {
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+    using ValueType = std::remove_const_t<Type>;
+
+    constexpr SimpleSpan() noexcept = default;
+
+    constexpr SimpleSpan(Type* data, size_t size) noexcept
+        : data_(data),
+        size_(size) {
+    }
+
+    constexpr SimpleSpan(Type* first, Type* last) noexcept
+        : data_(first),
+        size_(static_cast<size_t>(last - first)) {
+        assert(first <= last);
+    }
+
+    // SimpleSpan<Type> преобразуется в SimpleSpan<const Type>, но не наоборот
+    template <typename Other>
+        requires std::is_convertible_v<Other (*)[], Type (*)[]>
+    constexpr SimpleSpan(SimpleSpan<Other> other) noexcept
+        : data_(other.begin()),
+        size_(other.GetSize()) {
+    }
+
+    // Возвращает количество элементов
+    constexpr size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Сообщает, пусто ли представление
+    constexpr bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    constexpr Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    constexpr Type& At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("index >= size"); }
+        return data_[index];
+    }
+
+    // Возвращает count элементов, начиная с offset
+    constexpr SimpleSpan Subspan(size_t offset, size_t count) const noexcept {
+        assert(offset <= size_ && count <= size_ - offset);
+        return SimpleSpan(data_ + offset, count);
+    }
+
+    // Возвращает элементы, начиная с offset и до конца
+    constexpr SimpleSpan Subspan(size_t offset) const noexcept {
+        assert(offset <= size_);
+        return SimpleSpan(data_ + offset, size_ - offset);
+    }
+
+    // Возвращает первые count элементов
+    constexpr SimpleSpan First(size_t count) const noexcept {
+        return Subspan(0, count);
+    }
+
+    // Возвращает последние count элементов
+    constexpr SimpleSpan Last(size_t count) const noexcept {
+        assert(count <= size_);
+        return Subspan(size_ - count, count);
+    }
+
+    constexpr Iterator begin() const noexcept {
+        return data_;
+    }
+
+    constexpr Iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    constexpr ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    Type* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Type>
+using ConstSimpleSpan = SimpleSpan<const Type>;
+
+// Представления сравниваются по содержимому, как SimpleVector: для целых чисел
+// работают векторные ядра simd.h. Сравнивать можно изменяемое представление с константным
+template <typename Lhs, typename Rhs>
+concept SameSpanElement = std::same_as<std::remove_const_t<Lhs>, std::remove_const_t<Rhs>>;
+
+template <typename Lhs, typename Rhs>
+    requires SameSpanElement<Lhs, Rhs>
+constexpr bool operator==(SimpleSpan<Lhs> lhs, SimpleSpan<Rhs> rhs) {
+    if (lhs.GetSize() != rhs.GetSize()) {
+        return false;
+    }
+    if constexpr (simd::kVectorizable<std::remove_const_t<Lhs>>) {
+        if (!std::is_constant_evaluated()) {
+            return simd::Equal(lhs.cbegin(), rhs.cbegin(), lhs.GetSize());
+        }
+    }
+    return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <typename Lhs, typename Rhs>
+    requires SameSpanElement<Lhs, Rhs>
+constexpr bool operator!=(SimpleSpan<Lhs> lhs, SimpleSpan<Rhs> rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Lhs, typename Rhs>
+    requires SameSpanElement<Lhs, Rhs>
+constexpr bool operator<(SimpleSpan<Lhs> lhs, SimpleSpan<Rhs> rhs) {
+    if constexpr (simd::kVectorizable<std::remove_const_t<Lhs>>) {
+        if (!std::is_constant_evaluated()) {
+            return simd::LexicographicalLess(lhs.cbegin(), lhs.GetSize(), rhs.cbegin(), rhs.GetSize());
+        }
+    }
+    return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <typename Lhs, typename Rhs>
+    requires SameSpanElement<Lhs, Rhs>
+constexpr bool operator<=(SimpleSpan<Lhs> lhs, SimpleSpan<Rhs> rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Lhs, typename Rhs>
+    requires SameSpanElement<Lhs, Rhs>
+constexpr bool operator>(SimpleSpan<Lhs> lhs, SimpleSpan<Rhs> rhs) {
+    return rhs < lhs;
+}
+
+template <typename Lhs, typename Rhs>
+    requires SameSpanElement<Lhs, Rhs>
+constexpr bool operator>=(SimpleSpan<Lhs> lhs, SimpleSpan<Rhs> rhs) {
+    return !(lhs < rhs);
+}
+
+// Поиск и свёртки. Для целых чисел работают векторные ядра simd.h,
+// для остальных типов и при вычислении на этапе компиляции — алгоритмы стандартной библиотеки
+
+// Возвращает итератор на первый элемент, равный value, или end()
+template <typename Type>
+constexpr auto Find(SimpleSpan<Type> s, const std::remove_const_t<Type>& value) {
+    if constexpr (simd::kVectorizable<std::remove_const_t<Type>>) {
+        if (!std::is_constant_evaluated()) {
+            return s.begin() + simd::Find(s.cbegin(), s.GetSize(), value);
+        }
+    }
+    return std::find(s.begin(), s.end(), value);
+}
+
+// Возвращает количество элементов, равных value
+template <typename Type>
+constexpr size_t Count(SimpleSpan<Type> s, const std::remove_const_t<Type>& value) {
+    if constexpr (simd::kVectorizable<std::remove_const_t<Type>>) {
+        if (!std::is_constant_evaluated()) {
+            return simd::Count(s.cbegin(), s.GetSize(), value);
+        }
+    }
+    return static_cast<size_t>(std::count(s.begin(), s.end(), value));
+}
+
+// Сообщает, есть ли элемент, равный value
+template <typename Type>
+constexpr bool Contains(SimpleSpan<Type> s, const std::remove_const_t<Type>& value) {
+    return Find(s, value) != s.end();
+}
+
+// Возвращает итератор на первый наименьший элемент или end() для пустого представления
+template <typename Type>
+constexpr auto MinElement(SimpleSpan<Type> s) {
+    if constexpr (simd::kVectorizable<std::remove_const_t<Type>>) {
+        if (!std::is_constant_evaluated()) {
+            // Значение находит одно ядро, его первое вхождение — другое
+            return s.IsEmpty() ? s.end() : Find(s, simd::Min(s.cbegin(), s.GetSize()));
+        }
+    }
+    return std::min_element(s.begin(), s.end());
+}
+
+// Возвращает итератор на первый наибольший элемент или end() для пустого представления
+template <typename Type>
+constexpr auto MaxElement(SimpleSpan<Type> s) {
+    if constexpr (simd::kVectorizable<std::remove_const_t<Type>>) {
+        if (!std::is_constant_evaluated()) {
+            return s.IsEmpty() ? s.end() : Find(s, simd::Max(s.cbegin(), s.GetSize()));
+        }
+    }
+    return std::max_element(s.begin(), s.end());
+}
+
+// Возвращает сумму элементов. Целые числа складываются в 64-битном типе
+// (int64_t или uint64_t), поэтому сумма байтов не переполняется
+template <typename Type>
+constexpr auto Sum(SimpleSpan<Type> s) {
+    if constexpr (simd::kVectorizable<std::remove_const_t<Type>>) {
+        if (std::is_constant_evaluated()) {
+            return std::accumulate(s.begin(), s.end(), simd::SumType<std::remove_const_t<Type>>{});
+        }
+        return simd::Sum(s.cbegin(), s.GetSize());
+    }
+    else {
+        return std::accumulate(s.begin(), s.end(), std::remove_const_t<Type>{});
+    }
+}
@@ -2,321 +2,1058 @@
 
 #include <cassert>
 #include <initializer_list>
+#include <iterator>
 #include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <ranges>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "array_ptr.h"
+#include "growth_policy.h"
+#include "relocate.h"
+#include "simd.h"
+#include "simple_span.h"
 
+#ifdef SIMPLE_VECTOR_CHECKED
+#include "checked.h"
+#endif
+
+// Горячий путь добавления элемента (проверка вместимости и запись) встраивается
+// в место вызова целиком, а рост вынесен в холодную невстраиваемую функцию: так он
+// не раздувает код вызывающего цикла и не занимает регистры на быстром пути
+#if defined(__GNUC__) || defined(__clang__)
+#define SIMPLE_VECTOR_ALWAYS_INLINE [[gnu::always_inline]] inline
+#define SIMPLE_VECTOR_COLD [[gnu::cold, gnu::noinline]]
+#elif defined(_MSC_VER)
+#define SIMPLE_VECTOR_ALWAYS_INLINE __forceinline
+#define SIMPLE_VECTOR_COLD __declspec(noinline)
+#else
+#define SIMPLE_VECTOR_ALWAYS_INLINE inline
+#define SIMPLE_VECTOR_COLD
+#endif
 
 struct ReserveProxyObj {
-    ReserveProxyObj(size_t capacity_to_reserve)
+    constexpr ReserveProxyObj(size_t capacity_to_reserve)
         :capacity_(capacity_to_reserve) {};
     size_t capacity_;
 };
 
-ReserveProxyObj Reserve(size_t capacity_to_reserve) {
+constexpr ReserveProxyObj Reserve(size_t capacity_to_reserve) {
     return ReserveProxyObj(capacity_to_reserve);
 }
 
-template <typename Type>
+// Элементы хранятся в сырой памяти ArrayPtr: живыми объектами являются
+// только элементы из диапазона [0, size_), остальные GetCapacity() - size_ ячеек
+// не сконструированы и ничего не стоят до первого использования.
+// Allocator должен удовлетворять требованиям std::allocator_traits,
+// в том числе поддерживаются аллокаторы с состоянием и propagate_on_container_*.
+// GrowthPolicy выбирает новую вместимость при нехватке места и получает
+// уведомления о перевыделениях (см. growth_policy.h).
+// Вектор можно использовать при вычислении на этапе компиляции (constexpr), но, как
+// и std::vector, его память должна быть освобождена до конца вычисления: результат
+// переносится в StaticVector или std::array.
+// С макросом SIMPLE_VECTOR_CHECKED итераторы вектора проверяются (см. checked.h):
+// Insert и Erase в середину, удаление элементов и перевыделение памяти делают
+// недействительными все выданные итераторы, а не только следующие за позицией
+template <typename Type, typename Allocator = std::allocator<Type>, typename GrowthPolicy = DoublingGrowth>
 class SimpleVector {
+    using AllocTraits = std::allocator_traits<Allocator>;
+
 public:
+#ifdef SIMPLE_VECTOR_CHECKED
+    using Iterator = checked::CheckedIterator<Type>;
+    using ConstIterator = checked::CheckedIterator<const Type>;
+#else
     using Iterator = Type*;
     using ConstIterator = const Type*;
+#endif
+    using AllocatorType = Allocator;
+    using GrowthPolicyType = GrowthPolicy;
 
-    SimpleVector() noexcept = default;
+    constexpr SimpleVector() noexcept(noexcept(Allocator())) = default;
+
+    constexpr explicit SimpleVector(const Allocator& alloc) noexcept
+        : items_(alloc) {
+    }
 
     // Создаёт вектор из size элементов, инициализированных значением по умолчанию
-    explicit SimpleVector(size_t size) 
-    :size_(size),
-        capacity_(size),
-        items_(size)
+    constexpr explicit SimpleVector(size_t size, const Allocator& alloc = Allocator())
+        : items_(size, alloc)
     {
-            std::generate(begin(), end(), []() {return Type{}; });
+        UninitializedConstruct(items_.Get(), size, [this](Type* p) { items_.Construct(p); });
+        size_ = size;
+        ReportInitialAllocation();
     }
 
     // Создаёт вектор из size элементов, инициализированных значением value
-    SimpleVector(size_t size, const Type& value)
-        : SimpleVector(size)
+    constexpr SimpleVector(size_t size, const Type& value, const Allocator& alloc = Allocator())
+        : items_(size, alloc)
     {
-            std::fill(begin(), end(), value);
+        UninitializedConstruct(items_.Get(), size, [this, &value](Type* p) { items_.Construct(p, value); });
+        size_ = size;
+        ReportInitialAllocation();
     }
 
     // Создаёт вектор из std::initializer_list
-    SimpleVector(std::initializer_list<Type> init) 
-        : SimpleVector(init.size())
+    constexpr SimpleVector(std::initializer_list<Type> init, const Allocator& alloc = Allocator())
+        : items_(init.size(), alloc)
+    {
+        auto it = init.begin();
+        UninitializedConstruct(items_.Get(), init.size(), [this, &it](Type* p) { items_.Construct(p, *it++); });
+        size_ = init.size();
+        ReportInitialAllocation();
+    }
+
+    constexpr SimpleVector(const SimpleVector& other)
+        : SimpleVector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    constexpr SimpleVector(const SimpleVector& other, const Allocator& alloc)
+        : items_(other.size_, alloc)
     {
-        std::copy(init.begin(), init.end(), items_.Get());
+        const Type* src = other.items_.Get();
+        UninitializedConstruct(items_.Get(), other.size_, [this, &src](Type* p) { items_.Construct(p, *src++); });
+        size_ = other.size_;
+        ReportInitialAllocation();
     }
 
-    SimpleVector(const SimpleVector& other) 
-        : SimpleVector(other.size_)
+    // Статистика политики роста переходит вместе с буфером
+
+    constexpr SimpleVector(SimpleVector&& other) noexcept
+        : items_(std::move(other.items_)),
+        size_(std::exchange(other.size_, 0)),
+        growth_(std::exchange(other.growth_, GrowthPolicy()))
     {
-        std::copy(other.begin(), other.end(), items_.Get());
+        other.InvalidateIterators();
     }
 
-    SimpleVector(SimpleVector&& other)
+    // Если alloc не равен аллокатору other, элементы перемещаются по одному
+    constexpr SimpleVector(SimpleVector&& other, const Allocator& alloc)
+        : items_(alloc)
     {
-        swap(other);
+        if constexpr (!AllocTraits::is_always_equal::value) {
+            if (alloc != other.GetAllocator()) {
+                MoveElementsFrom(other);
+                return;
+            }
+        }
+        items_.swap(other.items_);
+        std::swap(size_, other.size_);
+        std::swap(growth_, other.growth_);
+        other.InvalidateIterators();
     }
 
-    SimpleVector(ReserveProxyObj capacity_to_reserve) {
+    constexpr SimpleVector(ReserveProxyObj capacity_to_reserve, const Allocator& alloc = Allocator())
+        : items_(alloc) {
         Reserve(capacity_to_reserve.capacity_);
     }
 
+    // Разрушает только живые элементы, память освобождает ArrayPtr
+    constexpr ~SimpleVector() {
+        items_.Destroy(items_.Get(), size_);
+        InvalidateIterators();
+    }
+
+    // Возвращает копию аллокатора вектора
+    constexpr Allocator GetAllocator() const noexcept {
+        return items_.GetAllocator();
+    }
+
+    // Возвращает политику роста вместе с накопленной ею статистикой
+    constexpr const GrowthPolicy& GetGrowthPolicy() const noexcept {
+        return growth_;
+    }
+
+    // Даёт внешнему коду, который сам перевыделяет буфер (например, ParallelResize),
+    // сообщить политике о перевыделении
+    constexpr GrowthPolicy& GetGrowthPolicy() noexcept {
+        return growth_;
+    }
+
     // Возвращает количество элементов в массиве
-    size_t GetSize() const noexcept {
+    constexpr size_t GetSize() const noexcept {
         return size_;
     }
 
     // Возвращает вместимость массива
-    size_t GetCapacity() const noexcept {
-        return capacity_;
+    constexpr size_t GetCapacity() const noexcept {
+        return items_.GetSize();
     }
 
     // Сообщает, пустой ли массив
-    bool IsEmpty() const noexcept {
+    constexpr bool IsEmpty() const noexcept {
         return size_ == 0;
     }
 
     // Возвращает ссылку на элемент с индексом index
-    Type& operator[](size_t index) noexcept {
+    constexpr Type& operator[](size_t index) noexcept {
         assert(index < size_);
         return items_[index];
     }
 
     // Возвращает константную ссылку на элемент с индексом index
-    const Type& operator[](size_t index) const noexcept {
+    constexpr const Type& operator[](size_t index) const noexcept {
         assert(index < size_);
         return items_[index];
     }
 
-    SimpleVector& operator=(const SimpleVector& rhs) {
-        //SimpleVector* hs = &rhs;
+    constexpr SimpleVector& operator=(const SimpleVector& rhs) {
         if (this != &rhs) {
-            SimpleVector tmp(rhs);
-            swap(tmp);
+            // При propagate_on_container_copy_assignment вектор получает аллокатор rhs
+            SimpleVector tmp(rhs, AllocTraits::propagate_on_container_copy_assignment::value
+                                  ? rhs.GetAllocator() : GetAllocator());
+            items_.swap(tmp.items_);
+            std::swap(size_, tmp.size_);
+            std::swap(growth_, tmp.growth_);
+            InvalidateIterators();
+        }
+        return *this;
+    }
+
+    constexpr SimpleVector& operator=(SimpleVector&& rhs) noexcept(
+        AllocTraits::propagate_on_container_move_assignment::value || AllocTraits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if constexpr (!AllocTraits::propagate_on_container_move_assignment::value
+                      && !AllocTraits::is_always_equal::value) {
+            if (GetAllocator() != rhs.GetAllocator()) {
+                // Память rhs нельзя освободить нашим аллокатором, переносим элементы поштучно
+                SimpleVector tmp(GetAllocator());
+                tmp.MoveElementsFrom(rhs);
+                items_.swap(tmp.items_);
+                std::swap(size_, tmp.size_);
+                std::swap(growth_, tmp.growth_);
+                InvalidateIterators();
+                return *this;
+            }
         }
+        Clear();
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+            items_ = std::move(rhs.items_);
+        }
+        else {
+            // Аллокаторы равны, поэтому память rhs можно освободить нашим аллокатором
+            const size_t capacity = rhs.GetCapacity();
+            items_ = ArrayPtr<Type, Allocator>(rhs.items_.Release(), capacity, GetAllocator());
+        }
+        size_ = std::exchange(rhs.size_, 0);
+        growth_ = std::exchange(rhs.growth_, GrowthPolicy());
+        rhs.InvalidateIterators();
         return *this;
     }
 
     // Возвращает константную ссылку на элемент с индексом index
     // Выбрасывает исключение std::out_of_range, если index >= size
-    Type& At(size_t index) {
+    constexpr Type& At(size_t index) {
         if (index >= size_) { throw std::out_of_range("out of range"); }
         return items_[index];
     }
 
     // Возвращает константную ссылку на элемент с индексом index
     // Выбрасывает исключение std::out_of_range, если index >= size
-    const Type& At(size_t index) const {
+    constexpr const Type& At(size_t index) const {
         if (index >= size_) { throw std::out_of_range("out of range"); }
         return items_[index];
     }
 
-    // Обнуляет размер массива, не изменяя его вместимость
-    void Clear() noexcept {
+    // Разрушает все элементы, не изменяя вместимость массива
+    constexpr void Clear() noexcept {
+        items_.Destroy(items_.Get(), size_);
         size_ = 0;
+        InvalidateIterators();
     }
 
     // Добавляет элемент в конец вектора
-    // При нехватке места увеличивает вдвое вместимость вектора
-    void PushBack(const Type& item) {
-        //Как и std::vector, класс SimpleVector может изменять свой размер в сторону увеличения и уменьшения.Для этого служит метод Resize :
-        if (capacity_ == size_) {
-            size_t new_capacity = 1;
-            Reserve(std::max(new_capacity, capacity_ * 2));
-         //   size_t new_capacity = capacity_;
-         //   if (new_capacity <= 1) { new_capacity = capacity_ + 1; }
-         //   else {
-         //       new_capacity = capacity_ * 2;
-         //   }
-        //    Reserve(new_capacity);
-        }
-        items_[size_] = item;
-        ++size_;
+    // При нехватке места увеличивает вместимость по политике роста (по умолчанию вдвое)
+    SIMPLE_VECTOR_ALWAYS_INLINE constexpr void PushBack(const Type& item) {
+        EmplaceBack(item);
     }
 
-    void PushBack(Type&& item) {
-        //Как и std::vector, класс SimpleVector может изменять свой размер в сторону увеличения и уменьшения.Для этого служит метод Resize :
-        if (capacity_ == size_) {
-            size_t new_capacity = 1;
-            Reserve(std::max(new_capacity, capacity_ * 2));
-          //  size_t new_capacity = capacity_;
-          //  if (new_capacity <= 1) { new_capacity = capacity_ + 1; }
-          //  else {
-          //      new_capacity = capacity_ * 2;
-          //  }
-         //   Reserve( new_capacity);
+    SIMPLE_VECTOR_ALWAYS_INLINE constexpr void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора прямо в его памяти из аргументов args.
+    // Возвращает ссылку на созданный элемент.
+    // Если при этом вектор растёт, даёт строгую гарантию исключений
+    template <typename... Args>
+    SIMPLE_VECTOR_ALWAYS_INLINE constexpr Type& EmplaceBack(Args&&... args) {
+        if (size_ != GetCapacity()) [[likely]] {
+            Type* slot = items_.Get() + size_;
+            items_.Construct(slot, std::forward<Args>(args)...);
+            ++size_;
+            return *slot;
+        }
+        if constexpr (kPassByValue) {
+            // Медленному пути передаётся готовая копия: иначе адрес аргумента утекает
+            // в невстраиваемую функцию, и на каждой итерации цикла аргумент пришлось бы
+            // сохранять в память
+            return EmplaceBackSlow(Type(std::forward<Args>(args)...));
+        }
+        else {
+            return EmplaceBackSlow(std::forward<Args>(args)...);
         }
-        items_[size_] = std::move(item);
-        ++size_;
     }
 
-    // "Удаляет" последний элемент вектора. Вектор не должен быть пустым
-    void PopBack() noexcept {
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    constexpr void PopBack() noexcept {
         assert(!IsEmpty());
-         --size_;
+        --size_;
+        items_.Destroy(items_.Get() + size_, 1);
+        InvalidateIterators();
+        if constexpr (GrowthPolicy::kAutoShrink) {
+            ShrinkByPolicy();
+        }
     }
 
-    // Обменивает значение с другим вектором
-    void swap(SimpleVector& other) noexcept {
-        std::swap(capacity_, other.capacity_);
+    // Обменивает значение с другим вектором вместе со статистикой политики роста.
+    // Без propagate_on_container_swap аллокаторы векторов должны быть равны
+    constexpr void swap(SimpleVector& other) noexcept {
+        assert(AllocTraits::propagate_on_container_swap::value || AllocTraits::is_always_equal::value
+               || GetAllocator() == other.GetAllocator());
         std::swap(size_, other.size_);
         items_.swap(other.items_);
+        std::swap(growth_, other.growth_);
+        InvalidateIterators();
+        other.InvalidateIterators();
     }
 
     // Изменяет размер массива.
     // При увеличении размера новые элементы получают значение по умолчанию для типа Type
-    void Resize(size_t new_size) {
-        if (new_size >= capacity_) {
-            size_t new_capacity = capacity_;
-            if (new_size <= 1) { new_capacity = capacity_+1; }
-            else {
-                new_capacity = std::max(new_size, capacity_ * 2);
-            }
-            ArrayPtr<Type> tmp(new_capacity);
-            std::move(items_.Get(), items_.Get()+size_, tmp.Get());
-            std::generate(tmp.Get() + size_, tmp.Get() + new_capacity, []() {return Type{}; });
-            items_.swap(tmp);
-            size_ = new_size;
-            capacity_ = new_capacity;
+    constexpr void Resize(size_t new_size) {
+        if (new_size > GetCapacity()) {
+            Reallocate(NextCapacity(new_size));
+        }
+        if (new_size > size_) {
+            UninitializedConstruct(items_.Get() + size_, new_size - size_, [this](Type* p) { items_.Construct(p); });
         }
         else {
-            if (new_size > size_) {
-                std::generate(items_.Get() + size_, items_.Get() + new_size, []() {return Type{}; });
-                size_ = new_size;
-            }
-            else { size_ = new_size; }
+            items_.Destroy(items_.Get() + new_size, size_ - new_size);
+            InvalidateIterators();
         }
-        // Напишите тело самостоятельно
+        size_ = new_size;
     }
 
-    void Reserve(size_t new_capacity) {
-        if (new_capacity > capacity_) {
-            ArrayPtr<Type> tmp(new_capacity);
-            std::move(items_.Get(), items_.Get() + size_, tmp.Get());
-            items_.swap(tmp);
-            capacity_ = new_capacity;
+    // Выделяет память под new_capacity элементов и переносит в неё существующие.
+    // Новые ячейки не конструируются
+    constexpr void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Reallocate(new_capacity);
+        }
+    }
+
+    // Освобождает память сверх текущего размера
+    constexpr void ShrinkToFit() {
+        if (GetCapacity() > size_) {
+            ShrinkTo(size_);
         }
     }
 
+    // Освобождает память сверх текущего размера, если вектор заполнен меньше чем на 1/k.
+    // Возвращает количество освобождённых байт
+    constexpr size_t Reclaim(size_t k = 4) {
+        assert(k > 0);
+        if (size_ >= GetCapacity() / k) {
+            return 0;
+        }
+        return ShrinkTo(size_);
+    }
+
     // Вставляет значение value в позицию pos.
     // Возвращает итератор на вставленное значение
-    // Если перед вставкой значения вектор был заполнен полностью,
-    // вместимость вектора должна увеличиться вдвое, а для вектора вместимостью 0 стать равной 1
-    Iterator Insert(ConstIterator pos, const Type& value) {
-        assert(pos>=begin() && pos <= end());
-        auto dist = pos - begin();
-        if (capacity_ == size_) {
-            size_t new_capacity = capacity_;
-            if (new_capacity <= 1) { new_capacity = capacity_ + 1; }
+    // Если перед вставкой значения вектор был заполнен полностью, вместимость растёт
+    // по политике роста: по умолчанию вдвое, а для вектора вместимостью 0 становится равной 1
+    constexpr Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos.
+    // Возвращает итератор на созданный элемент.
+    // Если при этом вектор растёт, даёт строгую гарантию исключений
+    template <typename... Args>
+    constexpr Iterator Emplace(ConstIterator pos, Args&&... args) {
+        CheckPosition(pos);
+        assert(pos >= begin() && pos <= end());
+        const size_t dist = pos - cbegin();
+        if (size_ == GetCapacity()) [[unlikely]] {
+            if constexpr (kPassByValue) {
+                return EmplaceSlow(dist, Type(std::forward<Args>(args)...));
+            }
             else {
-                new_capacity = capacity_ * 2;
+                return EmplaceSlow(dist, std::forward<Args>(args)...);
             }
-            Reserve(new_capacity);
         }
-        std::move_backward(cbegin()+dist, cend(), end() + 1);
-        items_[dist] = value;
-        ++size_;
-        return begin()+dist;
-    }
-
-    Iterator Insert(ConstIterator pos,Type&& value) {
-        //Как и std::vector, класс SimpleVector может изменять свой размер в сторону увеличения и уменьшения.Для этого служит метод Resize :
-        assert(pos>= begin() && pos <= end());
-        auto dist = pos - begin();
-        if (capacity_ == size_) {
-            size_t new_capacity = capacity_;
-            if (new_capacity <= 1) { new_capacity = capacity_ + 1; }
+        if (dist == size_) {
+            items_.Construct(items_.Get() + size_, std::forward<Args>(args)...);
+        }
+        else if constexpr (kRelocateByMemmove<Type, Allocator>) {
+            InvalidateIterators();
+            if (std::is_constant_evaluated()) {
+                // На этапе компиляции объект нельзя создать в массиве байт
+                Type tmp(std::forward<Args>(args)...);
+                TriviallyRelocate(items_.Get() + dist, size_ - dist, items_.Get() + dist + 1);
+                items_.Construct(items_.Get() + dist, std::move(tmp));
+            }
             else {
-                new_capacity = capacity_ * 2;
+                // Элемент создаётся заранее: аргументы могут ссылаться на сдвигаемые элементы
+                alignas(Type) std::byte buffer[sizeof(Type)];
+                Type* value = reinterpret_cast<Type*>(buffer);
+                items_.Construct(value, std::forward<Args>(args)...);
+                TriviallyRelocate(items_.Get() + dist, size_ - dist, items_.Get() + dist + 1);
+                TriviallyRelocate(value, 1, items_.Get() + dist);
             }
-            Reserve(new_capacity);
         }
-        std::move_backward(begin() + dist, end(), end() + 1);
-        items_[dist] = std::move(value);
+        else {
+            InvalidateIterators();
+            // Элемент создаётся заранее: аргументы могут ссылаться на сдвигаемые элементы
+            Type tmp(std::forward<Args>(args)...);
+            items_.Construct(items_.Get() + size_, std::move(items_[size_ - 1]));
+            std::move_backward(items_.Get() + dist, items_.Get() + size_ - 1, items_.Get() + size_);
+            items_[dist] = std::move(tmp);
+        }
         ++size_;
         return begin() + dist;
     }
 
+    // Вставляет count копий value в позицию pos.
+    // Возвращает итератор на первый вставленный элемент
+    constexpr Iterator Insert(ConstIterator pos, size_t count, const Type& value) {
+        CheckPosition(pos);
+        assert(pos >= begin() && pos <= end());
+        // Копия снимается заранее: value может ссылаться на сдвигаемый элемент
+        const Type copy(value);
+        return InsertForward(pos - cbegin(), RepeatIterator(&copy), count);
+    }
+
+    // Вставляет элементы [first, last) в позицию pos не более чем за одно перевыделение памяти.
+    // Для однопроходных итераторов элементы добавляются в конец и затем поворачиваются на место.
+    // Возвращает итератор на первый вставленный элемент.
+    // Как и у std::vector, [first, last) не должен указывать внутрь этого вектора,
+    // если только вставка не выполняется в конец
+    template <typename InputIt>
+        requires std::input_iterator<InputIt>
+    constexpr Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        CheckPosition(pos);
+        assert(pos >= begin() && pos <= end());
+        const size_t dist = pos - cbegin();
+        if constexpr (kIsForwardIterator<InputIt>) {
+            return InsertForward(dist, first, static_cast<size_t>(std::distance(first, last)));
+        }
+        else {
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            InvalidateIterators(dist != old_size);
+            std::rotate(items_.Get() + dist, items_.Get() + old_size, items_.Get() + size_);
+            return begin() + dist;
+        }
+    }
+
+    constexpr Iterator Insert(ConstIterator pos, std::initializer_list<Type> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    // Добавляет в конец все элементы range; элементы временного диапазона перемещаются.
+    // range должен возвращать итераторы одного типа из begin и end
+    template <typename Range>
+    constexpr void Append(Range&& range) {
+        if constexpr (std::is_lvalue_reference_v<Range>) {
+            Insert(cend(), std::ranges::begin(range), std::ranges::end(range));
+        }
+        else {
+            Insert(cend(), std::make_move_iterator(std::ranges::begin(range)),
+                   std::make_move_iterator(std::ranges::end(range)));
+        }
+    }
+
+    // Добавляет в конец count элементов, которые init(Type* first, size_t count) создаёт
+    // прямо в неинициализированной памяти вектора не более чем за одно перевыделение.
+    // init должен создать все count элементов, а при исключении разрушить созданные им.
+    // Позволяет заполнять вектор параллельно, не конструируя элементы дважды
+    template <typename Initializer>
+    constexpr void AppendConstructed(size_t count, Initializer init) {
+        if (count > GetCapacity() - size_) {
+            Reallocate(NextCapacity(size_ + count));
+        }
+        init(items_.Get() + size_, count);
+        size_ += count;
+    }
+
     // Удаляет элемент вектора в указанной позиции
-    Iterator Erase(ConstIterator pos) {
-        assert(pos>= begin() && pos < end());
-        int64_t dist = std::distance(cbegin(), pos) ;
-        std::move(begin()+dist + 1, end(), begin()+dist);
-        --size_;
+    constexpr Iterator Erase(ConstIterator pos) {
+        CheckPosition(pos);
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last) одним сдвигом хвоста.
+    // Возвращает итератор на элемент, следовавший за удалёнными
+    constexpr Iterator Erase(ConstIterator first, ConstIterator last) {
+        CheckPosition(first);
+        CheckPosition(last);
+        assert(first >= begin() && first <= last && last <= end());
+        const size_t dist = first - cbegin();
+        const size_t count = last - first;
+        if (count == 0) {
+            return begin() + dist;
+        }
+        InvalidateIterators();
+        Type* gap = items_.Get() + dist;
+        if constexpr (kRelocateByMemmove<Type, Allocator>) {
+            items_.Destroy(gap, count);
+            TriviallyRelocate(gap + count, size_ - dist - count, gap);
+        }
+        else {
+            std::move(gap + count, items_.Get() + size_, gap);
+            items_.Destroy(items_.Get() + size_ - count, count);
+        }
+        size_ -= count;
+        if constexpr (GrowthPolicy::kAutoShrink) {
+            ShrinkByPolicy();
+        }
         return begin() + dist;
     }
 
+    // Удаляет все элементы, для которых pred возвращает true, за один проход,
+    // сохраняя порядок остальных. Возвращает количество удалённых элементов
+    template <typename Predicate>
+    constexpr size_t EraseIf(Predicate pred) {
+        Type* data = items_.Get();
+        size_t write = 0;
+        if constexpr (std::is_arithmetic_v<Type>) {
+            // Без ветвлений: каждый элемент записывается на место write,
+            // но позиция сдвигается только для сохраняемых. Такой цикл компилятор векторизует
+            for (size_t read = 0; read < size_; ++read) {
+                const Type value = data[read];
+                data[write] = value;
+                write += !static_cast<bool>(pred(value));
+            }
+        }
+        else {
+            while (write < size_ && !pred(std::as_const(data[write]))) {
+                ++write;
+            }
+            for (size_t read = write; read < size_; ++read) {
+                if (!pred(std::as_const(data[read]))) {
+                    data[write++] = std::move(data[read]);
+                }
+            }
+        }
+        const size_t removed = size_ - write;
+        items_.Destroy(data + write, removed);
+        size_ = write;
+        InvalidateIterators(removed != 0);
+        if constexpr (GrowthPolicy::kAutoShrink) {
+            ShrinkByPolicy();
+        }
+        return removed;
+    }
+
+    // Удаляет элементы с индексами из indices за один проход, сохраняя порядок остальных.
+    // Индексы должны идти строго по возрастанию и быть меньше размера вектора.
+    // Возвращает количество удалённых элементов
+    template <typename IndexRange>
+    constexpr size_t EraseIndices(const IndexRange& indices) {
+        Type* data = items_.Get();
+        size_t read = 0;
+        size_t write = 0;
+        for (const size_t index : indices) {
+            assert(index < size_ && index >= read);
+            if (write != read) {
+                if constexpr (kRelocateByMemmove<Type, Allocator>) {
+                    TriviallyRelocate(data + read, index - read, data + write);
+                }
+                else {
+                    std::move(data + read, data + index, data + write);
+                }
+            }
+            if constexpr (kRelocateByMemmove<Type, Allocator>) {
+                items_.Destroy(data + index, 1);
+            }
+            write += index - read;
+            read = index + 1;
+        }
+        if constexpr (kRelocateByMemmove<Type, Allocator>) {
+            TriviallyRelocate(data + read, size_ - read, data + write);
+        }
+        else {
+            std::move(data + read, data + size_, data + write);
+            items_.Destroy(data + write + (size_ - read), read - write);
+        }
+        const size_t removed = read - write;
+        size_ -= removed;
+        InvalidateIterators(removed != 0);
+        if constexpr (GrowthPolicy::kAutoShrink) {
+            ShrinkByPolicy();
+        }
+        return removed;
+    }
+
     // Возвращает итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator begin() noexcept {
-        return items_.Get();
+    constexpr Iterator begin() noexcept {
+        return MakeIterator(items_.Get());
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    Iterator end() noexcept {
-        return items_.Get() + size_;
+    constexpr Iterator end() noexcept {
+        return MakeIterator(items_.Get() + size_);
     }
 
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator begin() const noexcept {
-        return items_.Get();
+    constexpr ConstIterator begin() const noexcept {
+        return MakeIterator(items_.Get());
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator end() const noexcept {
-        return items_.Get() + size_;
+    constexpr ConstIterator end() const noexcept {
+        return MakeIterator(items_.Get() + size_);
     }
 
     // Возвращает константный итератор на начало массива
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cbegin() const noexcept {
-        return items_.Get();
+    constexpr ConstIterator cbegin() const noexcept {
+        return begin();
     }
 
     // Возвращает итератор на элемент, следующий за последним
     // Для пустого массива может быть равен (или не равен) nullptr
-    ConstIterator cend() const noexcept {
-        return items_.Get() + size_;
+    constexpr ConstIterator cend() const noexcept {
+        return end();
+    }
+
+    // Возвращает указатель на первый элемент (nullptr, если память не выделена).
+    // В отличие от begin(), это сырой указатель и в проверяемом режиме
+    constexpr Type* GetData() noexcept {
+        return items_.Get();
+    }
+
+    constexpr const Type* GetData() const noexcept {
+        return items_.Get();
+    }
+
+    // Представление всех элементов вектора; действительно до перевыделения памяти
+    constexpr operator SimpleSpan<Type>() noexcept {
+        return SimpleSpan<Type>(items_.Get(), size_);
     }
+
+    constexpr operator ConstSimpleSpan<Type>() const noexcept {
+        return ConstSimpleSpan<Type>(items_.Get(), size_);
+    }
+
+private:
+    template <typename It>
+    static constexpr bool kIsForwardIterator = std::forward_iterator<It>
+        || std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<It>::iterator_category>;
+
+    // Однонаправленный итератор, повторяющий одно значение: позволяет вставлять
+    // count копий значения тем же кодом, что и диапазон
+    class RepeatIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Type*;
+        using reference = const Type&;
+
+        constexpr RepeatIterator() = default;
+        constexpr explicit RepeatIterator(const Type* value) noexcept
+            : value_(value) {
+        }
+
+        constexpr reference operator*() const noexcept {
+            return *value_;
+        }
+        constexpr RepeatIterator& operator++() noexcept {
+            return *this;
+        }
+        constexpr RepeatIterator operator++(int) noexcept {
+            return *this;
+        }
+        constexpr bool operator==(const RepeatIterator&) const = default;
+
     private:
-        ArrayPtr<Type> items_;
-        size_t size_ = 0;
-        size_t capacity_ = 0;
+        const Type* value_ = nullptr;
+    };
+
+    // Вставляет count элементов, начиная с first, в позицию dist.
+    // Если места не хватает, новые элементы создаются в новом буфере раньше переноса
+    // старых, и при исключении вектор не меняется
+    template <typename ForwardIt>
+    constexpr Iterator InsertForward(size_t dist, ForwardIt first, size_t count) {
+        if (count == 0) {
+            return begin() + dist;
+        }
+        if (count > GetCapacity() - size_) {
+            const size_t old_capacity = GetCapacity();
+            const size_t new_capacity = NextCapacity(size_ + count);
+            ArrayPtr<Type, Allocator> tmp(new_capacity, items_.GetAllocator());
+            Type* gap = tmp.Get() + dist;
+            UninitializedConstruct(gap, count, [this, &first](Type* p) { items_.Construct(p, *first); ++first; });
+            if constexpr (kRelocateByMemmove<Type, Allocator>) {
+                TriviallyRelocate(items_.Get(), dist, tmp.Get());
+                TriviallyRelocate(items_.Get() + dist, size_ - dist, gap + count);
+            }
+            else {
+                size_t relocated = 0;
+                try {
+                    UninitializedRelocate(items_.Get(), dist, tmp.Get());
+                    relocated = dist;
+                    UninitializedRelocate(items_.Get() + dist, size_ - dist, gap + count);
+                }
+                catch (...) {
+                    items_.Destroy(tmp.Get(), relocated);
+                    items_.Destroy(gap, count);
+                    throw;
+                }
+                items_.Destroy(items_.Get(), size_);
+            }
+            items_.swap(tmp);
+            growth_.OnReallocate(old_capacity, new_capacity, size_ * sizeof(Type));
+            InvalidateIterators();
+            size_ += count;
+        }
+        else if constexpr (kRelocateByMemmove<Type, Allocator>) {
+            // Хвост отодвигается одним memmove и возвращается на место, если создание элементов не удалось
+            InvalidateIterators(dist != size_);
+            Type* gap = items_.Get() + dist;
+            TriviallyRelocate(gap, size_ - dist, gap + count);
+            try {
+                UninitializedConstruct(gap, count, [this, &first](Type* p) { items_.Construct(p, *first); ++first; });
+            }
+            catch (...) {
+                TriviallyRelocate(gap + count, size_ - dist, gap);
+                throw;
+            }
+            size_ += count;
+        }
+        else {
+            InvalidateIterators(dist != size_);
+            Type* pos = items_.Get() + dist;
+            Type* old_end = items_.Get() + size_;
+            const size_t elems_after = size_ - dist;
+            if (elems_after > count) {
+                // Последние count элементов переезжают в свободную память, остальные сдвигаются присваиванием
+                UninitializedRelocate(old_end - count, count, old_end);
+                size_ += count;
+                std::move_backward(pos, old_end - count, old_end);
+                std::copy_n(first, count, pos);
+            }
+            else {
+                // Часть новых элементов создаётся сразу за концом, за ними переезжает хвост
+                ForwardIt mid = std::next(first, elems_after);
+                UninitializedConstruct(old_end, count - elems_after, [this, &mid](Type* p) { items_.Construct(p, *mid); ++mid; });
+                size_ += count - elems_after;
+                UninitializedRelocate(pos, elems_after, pos + count);
+                size_ += elems_after;
+                std::copy_n(first, elems_after, pos);
+            }
+        }
+        return begin() + dist;
+    }
+
+    // Создаёт count элементов начиная с dest, вызывая construct для каждой ячейки.
+    // Если конструктор бросит исключение, уже созданные элементы разрушаются
+    template <typename Constructor>
+    constexpr void UninitializedConstruct(Type* dest, size_t count, Constructor construct) {
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                construct(dest + i);
+            }
+        }
+        catch (...) {
+            items_.Destroy(dest, i);
+            throw;
+        }
+    }
+
+    // Переносит элементы [first, first + count) в неинициализированную память dest.
+    // Перемещает, если это не нарушает строгую гарантию, иначе копирует
+    constexpr void UninitializedRelocate(Type* first, size_t count, Type* dest) {
+        UninitializedConstruct(dest, count, [this, &first](Type* p) { items_.Construct(p, std::move_if_noexcept(*first++)); });
+    }
+
+    // Поштучно перемещает элементы other в собственную память
+    constexpr void MoveElementsFrom(SimpleVector& other) {
+        ArrayPtr<Type, Allocator> tmp(other.size_, items_.GetAllocator());
+        Type* src = other.items_.Get();
+        UninitializedConstruct(tmp.Get(), other.size_, [this, &src](Type* p) { items_.Construct(p, std::move(*src++)); });
+        Clear();
+        items_.swap(tmp);
+        size_ = other.size_;
+        // Элементы переехали в новый буфер: для статистики это перевыделение буфера other
+        growth_ = other.growth_;
+        growth_.OnReallocate(other.GetCapacity(), GetCapacity(), size_ * sizeof(Type));
+    }
+
+    // Сообщает политике роста о буфере, выделенном конструктором
+    constexpr void ReportInitialAllocation() noexcept {
+        if (GetCapacity() != 0) {
+            growth_.OnReallocate(0, GetCapacity(), 0);
+        }
+    }
+
+    constexpr Iterator MakeIterator(Type* p) noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        return Iterator(p, &generation_);
+#else
+        return p;
+#endif
+    }
+
+    constexpr ConstIterator MakeIterator(const Type* p) const noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        return ConstIterator(p, &generation_);
+#else
+        return p;
+#endif
+    }
+
+    // В проверяемом режиме делает недействительными все выданные итераторы
+    constexpr void InvalidateIterators([[maybe_unused]] bool invalidate = true) noexcept {
+#ifdef SIMPLE_VECTOR_CHECKED
+        if (invalidate) {
+            generation_.Advance();
+        }
+#endif
+    }
+
+    // В проверяемом режиме убеждается, что позиция выдана этим вектором и не устарела
+    constexpr void CheckPosition([[maybe_unused]] ConstIterator pos) const {
+#ifdef SIMPLE_VECTOR_CHECKED
+        pos.CheckOwner(&generation_);
+#endif
+    }
+
+    // Вместимость, которую политика роста выбирает для размещения required элементов
+    constexpr size_t NextCapacity(size_t required) const noexcept {
+        return growth_.NextCapacity(GetCapacity(), required, sizeof(Type));
+    }
+
+    // Переносит элементы в память под new_capacity элементов и сообщает об этом политике роста
+    constexpr void Reallocate(size_t new_capacity) {
+        const size_t old_capacity = GetCapacity();
+        MoveToCapacity(new_capacity);
+        growth_.OnReallocate(old_capacity, new_capacity, size_ * sizeof(Type));
+    }
+
+    // Переносит элементы в память под new_capacity элементов, не извещая политику роста.
+    // Тривиально перемещаемые типы переносятся одним memmove, а если аллокатор
+    // умеет reallocate, блок по возможности расширяется на месте
+    constexpr void MoveToCapacity(size_t new_capacity) {
+        if constexpr (kRelocateByMemmove<Type, Allocator> && ReallocatingAllocator<Allocator>) {
+            items_.Reallocate(new_capacity);
+        }
+        else {
+            ArrayPtr<Type, Allocator> tmp(new_capacity, items_.GetAllocator());
+            if constexpr (kRelocateByMemmove<Type, Allocator>) {
+                TriviallyRelocate(items_.Get(), size_, tmp.Get());
+            }
+            else {
+                UninitializedRelocate(items_.Get(), size_, tmp.Get());
+                items_.Destroy(items_.Get(), size_);
+            }
+            items_.swap(tmp);
+        }
+        InvalidateIterators();
+    }
+
+    // Уменьшает вместимость до new_capacity (не меньше размера) и сообщает политике роста,
+    // сколько байт освобождено. Возвращает это количество
+    constexpr size_t ShrinkTo(size_t new_capacity) {
+        assert(new_capacity >= size_ && new_capacity <= GetCapacity());
+        const size_t old_capacity = GetCapacity();
+        if (new_capacity == 0) {
+            items_ = ArrayPtr<Type, Allocator>(items_.GetAllocator());
+            InvalidateIterators();
+        }
+        else {
+            // Сжатие учитывается только в OnShrink, а не как ещё одно перевыделение
+            MoveToCapacity(new_capacity);
+        }
+        const size_t bytes_reclaimed = (old_capacity - new_capacity) * sizeof(Type);
+        growth_.OnShrink(old_capacity, new_capacity, bytes_reclaimed);
+        return bytes_reclaimed;
+    }
+
+    // Сжатие по политике роста после удаления элементов. Если память выделить
+    // не удалось, вектор остаётся прежним: сжатие лишь оптимизация
+    constexpr void ShrinkByPolicy() noexcept {
+        const size_t new_capacity = growth_.ShrinkCapacity(size_, GetCapacity(), sizeof(Type));
+        if (new_capacity < GetCapacity()) {
+            try {
+                ShrinkTo(std::max(new_capacity, size_));
+            }
+            catch (...) {
+            }
+        }
+    }
+
+    // Небольшие элементы, которые копируются побайтово, медленные пути роста
+    // получают уже созданными, а не аргументами для конструктора
+    static constexpr bool kPassByValue = std::is_trivially_copyable_v<Type> && kRelocateByMemmove<Type, Allocator>
+        && sizeof(Type) <= 2 * sizeof(void*);
+
+    // Медленный путь EmplaceBack: вектор заполнен и должен вырасти
+    template <typename... Args>
+    SIMPLE_VECTOR_COLD constexpr Type& EmplaceBackSlow(Args&&... args) {
+        ReallocateAndEmplace(NextCapacity(size_ + 1), size_, std::forward<Args>(args)...);
+        return items_[size_++];
+    }
+
+    // Медленный путь Emplace: вектор заполнен и должен вырасти
+    template <typename... Args>
+    SIMPLE_VECTOR_COLD constexpr Iterator EmplaceSlow(size_t dist, Args&&... args) {
+        ReallocateAndEmplace(NextCapacity(size_ + 1), dist, std::forward<Args>(args)...);
+        ++size_;
+        return begin() + dist;
+    }
+
+    // Переносит элементы в память под new_capacity элементов, оставляя в позиции dist
+    // место под новый элемент, созданный из args. Новый элемент создаётся раньше переноса
+    // старых: аргументы могут ссылаться на элементы этого вектора.
+    // При исключении вектор остаётся в исходном состоянии
+    template <typename... Args>
+    constexpr void ReallocateAndEmplace(size_t new_capacity, size_t dist, Args&&... args) {
+        const size_t old_capacity = GetCapacity();
+        if constexpr (kRelocateByMemmove<Type, Allocator> && ReallocatingAllocator<Allocator>) {
+            alignas(Type) std::byte buffer[sizeof(Type)];
+            Type* value = reinterpret_cast<Type*>(buffer);
+            items_.Construct(value, std::forward<Args>(args)...);
+            try {
+                items_.Reallocate(new_capacity);
+            }
+            catch (...) {
+                items_.Destroy(value, 1);
+                throw;
+            }
+            TriviallyRelocate(items_.Get() + dist, size_ - dist, items_.Get() + dist + 1);
+            TriviallyRelocate(value, 1, items_.Get() + dist);
+        }
+        else {
+            ArrayPtr<Type, Allocator> tmp(new_capacity, items_.GetAllocator());
+            items_.Construct(tmp.Get() + dist, std::forward<Args>(args)...);
+            if constexpr (kRelocateByMemmove<Type, Allocator>) {
+                TriviallyRelocate(items_.Get(), dist, tmp.Get());
+                TriviallyRelocate(items_.Get() + dist, size_ - dist, tmp.Get() + dist + 1);
+            }
+            else {
+                size_t relocated = 0;
+                try {
+                    UninitializedRelocate(items_.Get(), dist, tmp.Get());
+                    relocated = dist;
+                    UninitializedRelocate(items_.Get() + dist, size_ - dist, tmp.Get() + dist + 1);
+                }
+                catch (...) {
+                    items_.Destroy(tmp.Get(), relocated);
+                    items_.Destroy(tmp.Get() + dist, 1);
+                    throw;
+                }
+                items_.Destroy(items_.Get(), size_);
+            }
+            items_.swap(tmp);
+        }
+        growth_.OnReallocate(old_capacity, new_capacity, size_ * sizeof(Type));
+        InvalidateIterators();
+    }
+
+    ArrayPtr<Type, Allocator> items_;
+    size_t size_ = 0;
+    [[no_unique_address]] GrowthPolicy growth_;
+#ifdef SIMPLE_VECTOR_CHECKED
+    checked::Generation generation_;
+#endif
 };
 
-template <typename Type>
-inline bool operator==(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return (lhs.GetSize() == rhs.GetSize()) && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+// Векторы сравниваются так же, как их представления (см. simple_span.h)
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool operator==(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                          const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return ConstSimpleSpan<Type>(lhs) == ConstSimpleSpan<Type>(rhs);
 }
 
-template <typename Type>
-inline bool operator!=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool operator!=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                          const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs == rhs);
 }
 
-template <typename Type>
-inline bool operator<(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
-    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool operator<(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                         const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
+    return ConstSimpleSpan<Type>(lhs) < ConstSimpleSpan<Type>(rhs);
 }
 
-template <typename Type>
-inline bool operator<=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool operator<=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                          const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(rhs < lhs);
 }
 
-template <typename Type>
-inline bool operator>(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool operator>(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                         const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return rhs < lhs;
 }
 
-template <typename Type>
-inline bool operator>=(const SimpleVector<Type>& lhs, const SimpleVector<Type>& rhs) {
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool operator>=(const SimpleVector<Type, Allocator, GrowthPolicy>& lhs,
+                          const SimpleVector<Type, Allocator, GrowthPolicy>& rhs) {
     return !(lhs < rhs);
-}
\ No newline at end of file
+}
+
+// Поиск и свёртки по всему вектору, см. одноимённые функции для представлений в simple_span.h
+
+// Возвращает итератор на первый элемент, равный value, или end()
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr auto Find(const SimpleVector<Type, Allocator, GrowthPolicy>& v, const Type& value) {
+    const ConstSimpleSpan<Type> s(v);
+    return v.begin() + (Find(s, value) - s.begin());
+}
+
+// Возвращает количество элементов, равных value
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr size_t Count(const SimpleVector<Type, Allocator, GrowthPolicy>& v, const Type& value) {
+    return Count(ConstSimpleSpan<Type>(v), value);
+}
+
+// Сообщает, есть ли в векторе элемент, равный value
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr bool Contains(const SimpleVector<Type, Allocator, GrowthPolicy>& v, const Type& value) {
+    return Contains(ConstSimpleSpan<Type>(v), value);
+}
+
+// Возвращает итератор на первый наименьший элемент или end() для пустого вектора
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr auto MinElement(const SimpleVector<Type, Allocator, GrowthPolicy>& v) {
+    const ConstSimpleSpan<Type> s(v);
+    return v.begin() + (MinElement(s) - s.begin());
+}
+
+// Возвращает итератор на первый наибольший элемент или end() для пустого вектора
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr auto MaxElement(const SimpleVector<Type, Allocator, GrowthPolicy>& v) {
+    const ConstSimpleSpan<Type> s(v);
+    return v.begin() + (MaxElement(s) - s.begin());
+}
+
+// Возвращает сумму элементов. Целые числа складываются в 64-битном типе
+template <typename Type, typename Allocator, typename GrowthPolicy>
+constexpr auto Sum(const SimpleVector<Type, Allocator, GrowthPolicy>& v) {
+    return Sum(ConstSimpleSpan<Type>(v));
+}
@@ -0,0 +1,383 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "relocate.h"
+
+// Вектор с интерфейсом SimpleVector, хранящий до N элементов прямо в объекте.
+// Куча задействуется, только когда размер превышает N; после этого
+// элементы живут в ArrayPtr и обратно во встроенный буфер не возвращаются
+template <typename Type, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs a non-empty inline buffer");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    SmallVector() noexcept = default;
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    explicit SmallVector(size_t size) {
+        Resize(size);
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    SmallVector(size_t size, const Type& value) {
+        Reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            EmplaceBack(value);
+        }
+    }
+
+    // Создаёт вектор из std::initializer_list
+    SmallVector(std::initializer_list<Type> init) {
+        Reserve(init.size());
+        for (const Type& value : init) {
+            EmplaceBack(value);
+        }
+    }
+
+    SmallVector(const SmallVector& other) {
+        Reserve(other.size_);
+        for (const Type& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    // Забирает кучу other целиком, а встроенные элементы переносит поштучно
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (other.IsInline()) {
+            RelocateElements(other.data_, other.size_, data_);
+            size_ = std::exchange(other.size_, 0);
+        }
+        else {
+            heap_.swap(other.heap_);
+            data_ = heap_.Get();
+            size_ = std::exchange(other.size_, 0);
+            other.data_ = other.InlineData();
+        }
+    }
+
+    ~SmallVector() {
+        heap_.Destroy(data_, size_);
+    }
+
+    SmallVector& operator=(const SmallVector& rhs) {
+        if (this != &rhs) {
+            SmallVector tmp(rhs);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &rhs) {
+            Clear();
+            if (rhs.IsInline()) {
+                Reserve(rhs.size_);
+                RelocateElements(rhs.data_, rhs.size_, data_);
+                size_ = std::exchange(rhs.size_, 0);
+            }
+            else {
+                heap_ = std::move(rhs.heap_);
+                data_ = heap_.Get();
+                size_ = std::exchange(rhs.size_, 0);
+                rhs.data_ = rhs.InlineData();
+            }
+        }
+        return *this;
+    }
+
+    // Возвращает количество элементов в массиве
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива: N, пока элементы во встроенном буфере
+    size_t GetCapacity() const noexcept {
+        return IsInline() ? N : heap_.GetSize();
+    }
+
+    // Сообщает, пустой ли массив
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, хранятся ли элементы во встроенном буфере
+    bool IsInline() const noexcept {
+        return data_ == InlineData();
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Type& At(size_t index) {
+        if (index >= size_) { throw std::out_of_range("out of range"); }
+        return data_[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    const Type& At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("out of range"); }
+        return data_[index];
+    }
+
+    // Разрушает все элементы, не изменяя вместимость массива
+    void Clear() noexcept {
+        heap_.Destroy(data_, size_);
+        size_ = 0;
+    }
+
+    void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args
+    template <typename... Args>
+    Type& EmplaceBack(Args&&... args) {
+        if (size_ == GetCapacity()) {
+            ReallocateAndEmplace(GetCapacity() * 2, size_, std::forward<Args>(args)...);
+        }
+        else {
+            heap_.Construct(data_ + size_, std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        heap_.Destroy(data_ + size_, 1);
+    }
+
+    void swap(SmallVector& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Изменяет размер массива.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    void Resize(size_t new_size) {
+        if (new_size > GetCapacity()) {
+            Reallocate(std::max(new_size, GetCapacity() * 2));
+        }
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+        heap_.Destroy(data_ + new_size, size_ - std::min(size_, new_size));
+        size_ = std::min(size_, new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > GetCapacity()) {
+            Reallocate(new_capacity);
+        }
+    }
+
+    Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos
+    template <typename... Args>
+    Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        const size_t dist = pos - cbegin();
+        if (size_ == GetCapacity()) {
+            ReallocateAndEmplace(GetCapacity() * 2, dist, std::forward<Args>(args)...);
+        }
+        else if (dist == size_) {
+            heap_.Construct(data_ + size_, std::forward<Args>(args)...);
+        }
+        else {
+            // Элемент создаётся заранее: аргументы могут ссылаться на сдвигаемые элементы
+            Type tmp(std::forward<Args>(args)...);
+            if constexpr (IsTriviallyRelocatableV<Type>) {
+                TriviallyRelocate(data_ + dist, size_ - dist, data_ + dist + 1);
+                heap_.Construct(data_ + dist, std::move(tmp));
+            }
+            else {
+                heap_.Construct(data_ + size_, std::move(data_[size_ - 1]));
+                std::move_backward(data_ + dist, data_ + size_ - 1, data_ + size_);
+                data_[dist] = std::move(tmp);
+            }
+        }
+        ++size_;
+        return data_ + dist;
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        const size_t dist = pos - cbegin();
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            heap_.Destroy(data_ + dist, 1);
+            TriviallyRelocate(data_ + dist + 1, size_ - dist - 1, data_ + dist);
+            --size_;
+        }
+        else {
+            std::move(data_ + dist + 1, data_ + size_, data_ + dist);
+            PopBack();
+        }
+        return data_ + dist;
+    }
+
+    Iterator begin() noexcept {
+        return data_;
+    }
+
+    Iterator end() noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator begin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return data_;
+    }
+
+    ConstIterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+private:
+    Type* InlineData() noexcept {
+        return reinterpret_cast<Type*>(inline_);
+    }
+
+    const Type* InlineData() const noexcept {
+        return reinterpret_cast<const Type*>(inline_);
+    }
+
+    // Создаёт в неинициализированной памяти dest копии или перемещённые значения
+    // count элементов из first. При исключении созданные элементы разрушаются
+    void UninitializedRelocate(Type* first, size_t count, Type* dest) {
+        size_t i = 0;
+        try {
+            for (; i < count; ++i) {
+                heap_.Construct(dest + i, std::move_if_noexcept(first[i]));
+            }
+        }
+        catch (...) {
+            heap_.Destroy(dest, i);
+            throw;
+        }
+    }
+
+    // Переносит count элементов в неинициализированную память dest, разрушая исходные
+    void RelocateElements(Type* first, size_t count, Type* dest) {
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            TriviallyRelocate(first, count, dest);
+        }
+        else {
+            UninitializedRelocate(first, count, dest);
+            heap_.Destroy(first, count);
+        }
+    }
+
+    // Переносит элементы в кучу под new_capacity элементов
+    void Reallocate(size_t new_capacity) {
+        ArrayPtr<Type> tmp(new_capacity);
+        RelocateElements(data_, size_, tmp.Get());
+        heap_.swap(tmp);
+        data_ = heap_.Get();
+    }
+
+    // Переносит элементы в кучу, создавая в позиции dist новый элемент из args.
+    // При исключении вектор остаётся в исходном состоянии
+    template <typename... Args>
+    void ReallocateAndEmplace(size_t new_capacity, size_t dist, Args&&... args) {
+        ArrayPtr<Type> tmp(new_capacity);
+        heap_.Construct(tmp.Get() + dist, std::forward<Args>(args)...);
+        if constexpr (IsTriviallyRelocatableV<Type>) {
+            TriviallyRelocate(data_, dist, tmp.Get());
+            TriviallyRelocate(data_ + dist, size_ - dist, tmp.Get() + dist + 1);
+        }
+        else {
+            size_t relocated = 0;
+            try {
+                UninitializedRelocate(data_, dist, tmp.Get());
+                relocated = dist;
+                UninitializedRelocate(data_ + dist, size_ - dist, tmp.Get() + dist + 1);
+            }
+            catch (...) {
+                heap_.Destroy(tmp.Get(), relocated);
+                heap_.Destroy(tmp.Get() + dist, 1);
+                throw;
+            }
+            heap_.Destroy(data_, size_);
+        }
+        heap_.swap(tmp);
+        data_ = heap_.Get();
+    }
+
+    alignas(Type) std::byte inline_[N * sizeof(Type)];
+    ArrayPtr<Type> heap_;
+    Type* data_ = InlineData();
+    size_t size_ = 0;
+};
+
+template <typename Type, size_t N>
+inline bool operator==(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return (lhs.GetSize() == rhs.GetSize()) && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+}
+
+template <typename Type, size_t N>
+inline bool operator!=(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N>
+inline bool operator<(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename Type, size_t N>
+inline bool operator<=(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N>
+inline bool operator>(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N>
+inline bool operator>=(const SmallVector<Type, N>& lhs, const SmallVector<Type, N>& rhs) {
+    return !(lhs < rhs);
+}
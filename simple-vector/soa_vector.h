@@ -0,0 +1,508 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "array_ptr.h"
+#include "growth_policy.h"
+#include "relocate.h"
+#include "simple_span.h"
+
+// Вектор записей из полей Fields..., хранящий каждое поле отдельным непрерывным столбцом
+// (структура массивов). Цикл, которому нужно одно поле, читает только его столбец:
+// не тратит пропускную способность памяти на остальные поля и векторизуется компилятором.
+// Все столбцы растут вместе: у них общие размер, вместимость и политика роста GrowthPolicy.
+// Записи передаются кортежами std::tuple<Fields...>, а доступ к записи на месте даёт
+// прокси-ссылка std::tuple<Fields&...>, которую можно разобрать структурной привязкой.
+// Поля должны перемещаться без исключений: тогда перенос столбцов при росте, сдвиг
+// при вставке и удалении не могут оставить вектор наполовину изменённым
+template <typename GrowthPolicy, typename... Fields>
+class BasicSoaVector {
+    static_assert(sizeof...(Fields) > 0, "SoaVector needs at least one field");
+    static_assert((std::is_nothrow_move_constructible_v<Fields> && ...)
+                      && (std::is_nothrow_move_assignable_v<Fields> && ...),
+                  "SoaVector fields must be nothrow movable");
+
+    using Columns = std::tuple<ArrayPtr<Fields>...>;
+    using FieldIndices = std::index_sequence_for<Fields...>;
+
+    // Размер одной записи во всех столбцах: его получает политика роста
+    static constexpr size_t kRowBytes = (sizeof(Fields) + ...);
+
+    template <bool kConst>
+    class BasicIterator;
+
+public:
+    using ValueType = std::tuple<Fields...>;
+    using Reference = std::tuple<Fields&...>;
+    using ConstReference = std::tuple<const Fields&...>;
+    using Iterator = BasicIterator<false>;
+    using ConstIterator = BasicIterator<true>;
+    using GrowthPolicyType = GrowthPolicy;
+
+    template <size_t kField>
+    using FieldType = std::tuple_element_t<kField, ValueType>;
+
+    BasicSoaVector() noexcept = default;
+
+    // Создаёт вектор из size записей, поля которых инициализированы значением по умолчанию
+    explicit BasicSoaVector(size_t size)
+        : BasicSoaVector() {
+        Resize(size);
+    }
+
+    // Создаёт вектор из std::initializer_list записей
+    BasicSoaVector(std::initializer_list<ValueType> init)
+        : BasicSoaVector() {
+        Reserve(init.size());
+        for (const ValueType& row : init) {
+            PushBack(row);
+        }
+    }
+
+    BasicSoaVector(const BasicSoaVector& other)
+        : BasicSoaVector() {
+        Reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i) {
+            std::apply([this](const Fields&... fields) { EmplaceBack(fields...); }, other[i]);
+        }
+    }
+
+    BasicSoaVector(BasicSoaVector&& other) noexcept {
+        swap(other);
+    }
+
+    ~BasicSoaVector() {
+        DestroyRows(0, size_);
+    }
+
+    BasicSoaVector& operator=(const BasicSoaVector& rhs) {
+        if (this != &rhs) {
+            BasicSoaVector tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    BasicSoaVector& operator=(BasicSoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            BasicSoaVector tmp(std::move(rhs));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Возвращает политику роста вместе с накопленной ею статистикой
+    const GrowthPolicy& GetGrowthPolicy() const noexcept {
+        return growth_;
+    }
+
+    // Возвращает количество записей
+    size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает общую вместимость столбцов
+    size_t GetCapacity() const noexcept {
+        return capacity_;
+    }
+
+    // Сообщает, пустой ли вектор
+    bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Возвращает прокси-ссылку на запись с индексом index
+    Reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return RowAt<Reference>(columns_, index, FieldIndices{});
+    }
+
+    ConstReference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return RowAt<ConstReference>(columns_, index, FieldIndices{});
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    Reference At(size_t index) {
+        if (index >= size_) { throw std::out_of_range("index >= size"); }
+        return (*this)[index];
+    }
+
+    ConstReference At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("index >= size"); }
+        return (*this)[index];
+    }
+
+    // Возвращает столбец поля kField целиком
+    template <size_t kField>
+    SimpleSpan<FieldType<kField>> Column() noexcept {
+        return SimpleSpan<FieldType<kField>>(std::get<kField>(columns_).Get(), size_);
+    }
+
+    template <size_t kField>
+    ConstSimpleSpan<FieldType<kField>> Column() const noexcept {
+        return ConstSimpleSpan<FieldType<kField>>(std::get<kField>(columns_).Get(), size_);
+    }
+
+    // Разрушает все записи, не изменяя вместимость
+    void Clear() noexcept {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    void PushBack(const ValueType& row) {
+        std::apply([this](const Fields&... fields) { EmplaceBack(fields...); }, row);
+    }
+
+    void PushBack(ValueType&& row) {
+        std::apply([this](Fields&... fields) { EmplaceBack(std::move(fields)...); }, row);
+    }
+
+    // Создаёт запись в конце вектора: args[i] передаётся конструктору i-го поля.
+    // Аргументы могут ссылаться на записи этого же вектора
+    template <typename... Args>
+        requires(sizeof...(Args) == sizeof...(Fields))
+    Reference EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            // Новая запись создаётся в новых столбцах до переноса старых
+            const size_t new_capacity = NextCapacity(size_ + 1);
+            Columns fresh{ArrayPtr<Fields>(new_capacity)...};
+            ConstructRow(fresh, size_, FieldIndices{}, std::forward<Args>(args)...);
+            AdoptColumns(fresh, new_capacity);
+        }
+        else {
+            ConstructRow(columns_, size_, FieldIndices{}, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    // Удаляет последнюю запись. Вектор не должен быть пустым
+    void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        DestroyRows(size_, size_ + 1);
+    }
+
+    void swap(BasicSoaVector& other) noexcept {
+        using std::swap;
+        ForEachField([&]<size_t kField>() { std::get<kField>(columns_).swap(std::get<kField>(other.columns_)); });
+        swap(size_, other.size_);
+        swap(capacity_, other.capacity_);
+        swap(growth_, other.growth_);
+    }
+
+    // Изменяет количество записей. Поля новых записей инициализируются значением по умолчанию
+    void Resize(size_t new_size) {
+        if (new_size > capacity_) {
+            Reallocate(NextCapacity(new_size));
+        }
+        while (size_ < new_size) {
+            ConstructRow(columns_, size_, FieldIndices{});
+            ++size_;
+        }
+        DestroyRows(new_size, size_);
+        size_ = std::min(size_, new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            Reallocate(new_capacity);
+        }
+    }
+
+    // Вставляет запись перед pos: запись добавляется в конец и сдвигается на место
+    // поворотом каждого столбца. Возвращает итератор на вставленную запись
+    Iterator Insert(ConstIterator pos, const ValueType& row) {
+        const size_t dist = Offset(pos);
+        PushBack(row);
+        RotateLastTo(dist);
+        return begin() + dist;
+    }
+
+    Iterator Insert(ConstIterator pos, ValueType&& row) {
+        const size_t dist = Offset(pos);
+        PushBack(std::move(row));
+        RotateLastTo(dist);
+        return begin() + dist;
+    }
+
+    // Удаляет запись в позиции pos
+    Iterator Erase(ConstIterator pos) {
+        assert(pos != cend());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет записи [first, last) и возвращает итератор на запись, следовавшую за ними
+    Iterator Erase(ConstIterator first, ConstIterator last) {
+        const size_t from = Offset(first);
+        const size_t to = Offset(last);
+        assert(from <= to);
+        ForEachField([&]<size_t kField>() {
+            auto* column = std::get<kField>(columns_).Get();
+            std::move(column + to, column + size_, column + from);
+        });
+        DestroyRows(size_ - (to - from), size_);
+        size_ -= to - from;
+        return begin() + from;
+    }
+
+    Iterator begin() noexcept {
+        return Iterator(&columns_, 0);
+    }
+
+    Iterator end() noexcept {
+        return Iterator(&columns_, size_);
+    }
+
+    ConstIterator begin() const noexcept {
+        return ConstIterator(&columns_, 0);
+    }
+
+    ConstIterator end() const noexcept {
+        return ConstIterator(&columns_, size_);
+    }
+
+    ConstIterator cbegin() const noexcept {
+        return begin();
+    }
+
+    ConstIterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    // Итератор произвольного доступа с прокси-ссылкой: разыменование возвращает кортеж ссылок
+    // на поля записи. Поскольку ссылка не является value_type&, итератор объявлен
+    // input_iterator по старой классификации, как итераторы представлений std::ranges
+    template <bool kConst>
+    class BasicIterator {
+        using ColumnsPtr = std::conditional_t<kConst, const Columns*, Columns*>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<kConst, ConstReference, Reference>;
+
+        BasicIterator() noexcept = default;
+
+        // Изменяемый итератор преобразуется в константный
+        template <bool kOtherConst>
+            requires(kConst && !kOtherConst)
+        BasicIterator(const BasicIterator<kOtherConst>& other) noexcept
+            : columns_(other.columns_),
+            index_(other.index_) {
+        }
+
+        reference operator*() const noexcept {
+            return RowAt<reference>(*columns_, index_, FieldIndices{});
+        }
+
+        reference operator[](difference_type offset) const noexcept {
+            return *(*this + offset);
+        }
+
+        // Индекс записи в векторе
+        size_t GetIndex() const noexcept {
+            return index_;
+        }
+
+        BasicIterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+
+        BasicIterator operator++(int) noexcept {
+            BasicIterator old = *this;
+            ++index_;
+            return old;
+        }
+
+        BasicIterator& operator--() noexcept {
+            --index_;
+            return *this;
+        }
+
+        BasicIterator operator--(int) noexcept {
+            BasicIterator old = *this;
+            --index_;
+            return old;
+        }
+
+        BasicIterator& operator+=(difference_type offset) noexcept {
+            index_ += offset;
+            return *this;
+        }
+
+        BasicIterator& operator-=(difference_type offset) noexcept {
+            index_ -= offset;
+            return *this;
+        }
+
+        friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+            return it += offset;
+        }
+
+        friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+            return it -= offset;
+        }
+
+        friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+        }
+
+        friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend std::strong_ordering operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+            return lhs.index_ <=> rhs.index_;
+        }
+
+    private:
+        friend class BasicSoaVector;
+        friend class BasicIterator<true>;
+
+        BasicIterator(ColumnsPtr columns, size_t index) noexcept
+            : columns_(columns),
+            index_(index) {
+        }
+
+        ColumnsPtr columns_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    // Вызывает f.template operator()<kField>() для каждого поля по порядку
+    template <typename Function>
+    static void ForEachField(Function&& f) {
+        [&]<size_t... kFields>(std::index_sequence<kFields...>) {
+            (f.template operator()<kFields>(), ...);
+        }(FieldIndices{});
+    }
+
+    template <typename Row, typename ColumnsRef, size_t... kFields>
+    static Row RowAt(ColumnsRef& columns, size_t index, std::index_sequence<kFields...>) noexcept {
+        return Row(std::get<kFields>(columns).Get()[index]...);
+    }
+
+    // Создаёт поля записи index в columns по одному. Если конструктор поля бросит
+    // исключение, уже созданные поля этой записи разрушаются
+    template <size_t... kFields, typename... Args>
+    static void ConstructRow(Columns& columns, size_t index, std::index_sequence<kFields...>, Args&&... args) {
+        size_t constructed = 0;
+        try {
+            if constexpr (sizeof...(Args) == 0) {
+                ((std::get<kFields>(columns).Construct(std::get<kFields>(columns).Get() + index), ++constructed), ...);
+            }
+            else {
+                ((std::get<kFields>(columns).Construct(std::get<kFields>(columns).Get() + index,
+                                                       std::forward<Args>(args)),
+                  ++constructed),
+                 ...);
+            }
+        }
+        catch (...) {
+            ForEachField([&]<size_t kField>() {
+                if (kField < constructed) {
+                    std::get<kField>(columns).Destroy(std::get<kField>(columns).Get() + index, 1);
+                }
+            });
+            throw;
+        }
+    }
+
+    // Разрушает записи [first, last) во всех столбцах
+    void DestroyRows(size_t first, size_t last) noexcept {
+        if (first >= last) {
+            return;
+        }
+        ForEachField([&]<size_t kField>() {
+            std::get<kField>(columns_).Destroy(std::get<kField>(columns_).Get() + first, last - first);
+        });
+    }
+
+    size_t Offset(ConstIterator pos) const noexcept {
+        assert(pos.columns_ == &columns_ && pos.index_ <= size_);
+        return pos.index_;
+    }
+
+    // Вместимость, которую политика роста выбирает для размещения required записей
+    size_t NextCapacity(size_t required) const noexcept {
+        return growth_.NextCapacity(capacity_, required, kRowBytes);
+    }
+
+    // Переносит записи в столбцы вместимостью new_capacity. Все столбцы выделяются
+    // до переноса, поэтому нехватка памяти оставляет вектор нетронутым
+    void Reallocate(size_t new_capacity) {
+        Columns fresh{ArrayPtr<Fields>(new_capacity)...};
+        AdoptColumns(fresh, new_capacity);
+    }
+
+    // Переносит записи [0, size_) в fresh и делает fresh своими столбцами. Не бросает исключений
+    void AdoptColumns(Columns& fresh, size_t new_capacity) noexcept {
+        ForEachField([&]<size_t kField>() {
+            using Field = FieldType<kField>;
+            ArrayPtr<Field>& from = std::get<kField>(columns_);
+            ArrayPtr<Field>& to = std::get<kField>(fresh);
+            if constexpr (IsTriviallyRelocatableV<Field>) {
+                TriviallyRelocate(from.Get(), size_, to.Get());
+            }
+            else {
+                std::uninitialized_move_n(from.Get(), size_, to.Get());
+                from.Destroy(from.Get(), size_);
+            }
+            from.swap(to);
+        });
+        growth_.OnReallocate(std::exchange(capacity_, new_capacity), new_capacity, size_ * kRowBytes);
+    }
+
+    // Переставляет последнюю запись в позицию dist, сдвигая записи [dist, size_ - 1) вправо
+    void RotateLastTo(size_t dist) noexcept {
+        ForEachField([&]<size_t kField>() {
+            auto* column = std::get<kField>(columns_).Get();
+            std::rotate(column + dist, column + size_ - 1, column + size_);
+        });
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    [[no_unique_address]] GrowthPolicy growth_;
+};
+
+// Вектор-структура массивов с политикой роста по умолчанию
+template <typename... Fields>
+using SoaVector = BasicSoaVector<DoublingGrowth, Fields...>;
+
+template <typename GrowthPolicy, typename... Fields>
+inline bool operator==(const BasicSoaVector<GrowthPolicy, Fields...>& lhs,
+                       const BasicSoaVector<GrowthPolicy, Fields...>& rhs) {
+    if (lhs.GetSize() != rhs.GetSize()) {
+        return false;
+    }
+    return [&]<size_t... kFields>(std::index_sequence<kFields...>) {
+        return ((lhs.template Column<kFields>() == rhs.template Column<kFields>()) && ...);
+    }(std::index_sequence_for<Fields...>{});
+}
+
+template <typename GrowthPolicy, typename... Fields>
+inline bool operator!=(const BasicSoaVector<GrowthPolicy, Fields...>& lhs,
+                       const BasicSoaVector<GrowthPolicy, Fields...>& rhs) {
+    return !(lhs == rhs);
+}
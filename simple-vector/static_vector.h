@@ -0,0 +1,417 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "simple_span.h"
+
+// Вектор с интерфейсом SimpleVector и постоянной вместимостью N, хранящий элементы
+// прямо в объекте: куча не используется никогда. Превышение вместимости — ошибка
+// программы, которую проверяет assert; при вычислении на этапе компиляции она
+// становится ошибкой компиляции.
+// Все операции constexpr. Вектор тривиальных типов можно целиком вычислить на этапе
+// компиляции и сохранить в constexpr-переменной, например как таблицу поиска
+template <typename Type, size_t N>
+class StaticVector {
+    static_assert(N > 0, "StaticVector needs a non-empty buffer");
+
+public:
+    using Iterator = Type*;
+    using ConstIterator = const Type*;
+
+    static constexpr size_t kCapacity = N;
+
+    constexpr StaticVector() noexcept {
+        InitStorage();
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением по умолчанию
+    constexpr explicit StaticVector(size_t size)
+        : StaticVector() {
+        Resize(size);
+    }
+
+    // Создаёт вектор из size элементов, инициализированных значением value
+    constexpr StaticVector(size_t size, const Type& value)
+        : StaticVector() {
+        assert(size <= N);
+        while (size_ < size) {
+            EmplaceBack(value);
+        }
+    }
+
+    // Создаёт вектор из std::initializer_list
+    constexpr StaticVector(std::initializer_list<Type> init)
+        : StaticVector() {
+        assert(init.size() <= N);
+        for (const Type& value : init) {
+            EmplaceBack(value);
+        }
+    }
+
+    constexpr StaticVector(const StaticVector& other)
+        : StaticVector() {
+        for (const Type& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    // Элементы переносятся поштучно, other становится пустым
+    constexpr StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+        : StaticVector() {
+        for (Type& value : other) {
+            EmplaceBack(std::move(value));
+        }
+        other.Clear();
+    }
+
+    constexpr ~StaticVector() requires(!std::is_trivially_destructible_v<Type>) {
+        Clear();
+    }
+
+    constexpr ~StaticVector() = default;
+
+    constexpr StaticVector& operator=(const StaticVector& rhs) {
+        if (this != &rhs) {
+            Clear();
+            for (const Type& value : rhs) {
+                EmplaceBack(value);
+            }
+        }
+        return *this;
+    }
+
+    constexpr StaticVector& operator=(StaticVector&& rhs) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+        if (this != &rhs) {
+            Clear();
+            for (Type& value : rhs) {
+                EmplaceBack(std::move(value));
+            }
+            rhs.Clear();
+        }
+        return *this;
+    }
+
+    // Возвращает количество элементов в массиве
+    constexpr size_t GetSize() const noexcept {
+        return size_;
+    }
+
+    // Возвращает вместимость массива: всегда N
+    constexpr size_t GetCapacity() const noexcept {
+        return N;
+    }
+
+    // Сообщает, пустой ли массив
+    constexpr bool IsEmpty() const noexcept {
+        return size_ == 0;
+    }
+
+    // Сообщает, заполнен ли массив до вместимости
+    constexpr bool IsFull() const noexcept {
+        return size_ == N;
+    }
+
+    // Возвращает ссылку на элемент с индексом index
+    constexpr Type& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Возвращает константную ссылку на элемент с индексом index
+    constexpr const Type& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    constexpr Type& At(size_t index) {
+        if (index >= size_) { throw std::out_of_range("out of range"); }
+        return Data()[index];
+    }
+
+    // Выбрасывает исключение std::out_of_range, если index >= size
+    constexpr const Type& At(size_t index) const {
+        if (index >= size_) { throw std::out_of_range("out of range"); }
+        return Data()[index];
+    }
+
+    // Разрушает все элементы
+    constexpr void Clear() noexcept {
+        std::destroy(Data(), Data() + size_);
+        size_ = 0;
+    }
+
+    // Добавляет элемент в конец вектора. Вектор не должен быть заполнен
+    constexpr void PushBack(const Type& item) {
+        EmplaceBack(item);
+    }
+
+    constexpr void PushBack(Type&& item) {
+        EmplaceBack(std::move(item));
+    }
+
+    // Создаёт элемент в конце вектора из аргументов args и возвращает ссылку на него.
+    // Вектор не должен быть заполнен
+    template <typename... Args>
+    constexpr Type& EmplaceBack(Args&&... args) {
+        assert(size_ < N);
+        Type* slot = std::construct_at(Data() + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    // Удаляет последний элемент вектора. Вектор не должен быть пустым
+    constexpr void PopBack() noexcept {
+        assert(!IsEmpty());
+        --size_;
+        std::destroy_at(Data() + size_);
+    }
+
+    // Обменивает содержимое с другим вектором: общая часть обменивается поэлементно,
+    // остаток длинного вектора переезжает в короткий
+    constexpr void swap(StaticVector& other) noexcept(std::is_nothrow_swappable_v<Type>
+                                                      && std::is_nothrow_move_constructible_v<Type>) {
+        StaticVector& longer = size_ >= other.size_ ? *this : other;
+        StaticVector& shorter = size_ >= other.size_ ? other : *this;
+        const size_t common = shorter.size_;
+        std::swap_ranges(shorter.Data(), shorter.Data() + common, longer.Data());
+        for (size_t i = common; i < longer.size_; ++i) {
+            shorter.EmplaceBack(std::move(longer.Data()[i]));
+        }
+        std::destroy(longer.Data() + common, longer.Data() + longer.size_);
+        longer.size_ = common;
+    }
+
+    // Изменяет размер массива, не больше N.
+    // При увеличении размера новые элементы получают значение по умолчанию для типа Type
+    constexpr void Resize(size_t new_size) {
+        assert(new_size <= N);
+        while (size_ < new_size) {
+            EmplaceBack();
+        }
+        std::destroy(Data() + std::min(new_size, size_), Data() + size_);
+        size_ = std::min(new_size, size_);
+    }
+
+    // Вместимость постоянна: проверяет лишь, что new_capacity не больше N
+    constexpr void Reserve([[maybe_unused]] size_t new_capacity) noexcept {
+        assert(new_capacity <= N);
+    }
+
+    // Вставляет значение value в позицию pos.
+    // Возвращает итератор на вставленное значение
+    constexpr Iterator Insert(ConstIterator pos, const Type& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr Iterator Insert(ConstIterator pos, Type&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Создаёт элемент из аргументов args в позиции pos.
+    // Возвращает итератор на созданный элемент
+    template <typename... Args>
+    constexpr Iterator Emplace(ConstIterator pos, Args&&... args) {
+        assert(pos >= begin() && pos <= end());
+        assert(size_ < N);
+        const size_t dist = pos - cbegin();
+        if (dist == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+        }
+        else {
+            // Элемент создаётся заранее: аргументы могут ссылаться на сдвигаемые элементы
+            Type tmp(std::forward<Args>(args)...);
+            EmplaceBack(std::move(Data()[size_ - 1]));
+            std::move_backward(Data() + dist, Data() + size_ - 2, Data() + size_ - 1);
+            Data()[dist] = std::move(tmp);
+        }
+        return Data() + dist;
+    }
+
+    // Вставляет count копий value в позицию pos.
+    // Возвращает итератор на первый вставленный элемент
+    constexpr Iterator Insert(ConstIterator pos, size_t count, const Type& value) {
+        assert(pos >= begin() && pos <= end());
+        assert(count <= N - size_);
+        // Копия снимается заранее: value может ссылаться на сдвигаемый элемент
+        const Type copy(value);
+        const size_t dist = pos - cbegin();
+        const size_t old_size = size_;
+        for (size_t i = 0; i < count; ++i) {
+            EmplaceBack(copy);
+        }
+        std::rotate(Data() + dist, Data() + old_size, Data() + size_);
+        return Data() + dist;
+    }
+
+    // Вставляет элементы [first, last) в позицию pos: они добавляются в конец
+    // и поворачиваются на место. Возвращает итератор на первый вставленный элемент
+    template <typename InputIt>
+        requires std::input_iterator<InputIt>
+    constexpr Iterator Insert(ConstIterator pos, InputIt first, InputIt last) {
+        assert(pos >= begin() && pos <= end());
+        const size_t dist = pos - cbegin();
+        const size_t old_size = size_;
+        for (; first != last; ++first) {
+            EmplaceBack(*first);
+        }
+        std::rotate(Data() + dist, Data() + old_size, Data() + size_);
+        return Data() + dist;
+    }
+
+    constexpr Iterator Insert(ConstIterator pos, std::initializer_list<Type> init) {
+        return Insert(pos, init.begin(), init.end());
+    }
+
+    // Удаляет элемент вектора в указанной позиции
+    constexpr Iterator Erase(ConstIterator pos) {
+        assert(pos >= begin() && pos < end());
+        return Erase(pos, pos + 1);
+    }
+
+    // Удаляет элементы [first, last) одним сдвигом хвоста.
+    // Возвращает итератор на элемент, следовавший за удалёнными
+    constexpr Iterator Erase(ConstIterator first, ConstIterator last) {
+        assert(first >= begin() && first <= last && last <= end());
+        const size_t dist = first - cbegin();
+        const size_t count = last - first;
+        std::move(Data() + dist + count, Data() + size_, Data() + dist);
+        std::destroy(Data() + size_ - count, Data() + size_);
+        size_ -= count;
+        return Data() + dist;
+    }
+
+    // Удаляет все элементы, для которых pred возвращает true, сохраняя порядок остальных.
+    // Возвращает количество удалённых элементов
+    template <typename Predicate>
+    constexpr size_t EraseIf(Predicate pred) {
+        Type* kept_end = std::remove_if(Data(), Data() + size_, [&pred](const Type& value) {
+            return static_cast<bool>(pred(value));
+        });
+        const size_t removed = static_cast<size_t>(Data() + size_ - kept_end);
+        std::destroy(kept_end, Data() + size_);
+        size_ -= removed;
+        return removed;
+    }
+
+    constexpr Iterator begin() noexcept {
+        return Data();
+    }
+
+    constexpr Iterator end() noexcept {
+        return Data() + size_;
+    }
+
+    constexpr ConstIterator begin() const noexcept {
+        return Data();
+    }
+
+    constexpr ConstIterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    constexpr ConstIterator cbegin() const noexcept {
+        return Data();
+    }
+
+    constexpr ConstIterator cend() const noexcept {
+        return Data() + size_;
+    }
+
+    // Возвращает указатель на первый элемент
+    constexpr Type* GetData() noexcept {
+        return Data();
+    }
+
+    constexpr const Type* GetData() const noexcept {
+        return Data();
+    }
+
+    // Представление всех элементов вектора
+    constexpr operator SimpleSpan<Type>() noexcept {
+        return SimpleSpan<Type>(Data(), size_);
+    }
+
+    constexpr operator ConstSimpleSpan<Type>() const noexcept {
+        return ConstSimpleSpan<Type>(Data(), size_);
+    }
+
+private:
+    // Массив в объединении не конструирует элементы: они создаются по одному
+    // через std::construct_at, как в сырой памяти, но без reinterpret_cast,
+    // недоступного при вычислении на этапе компиляции
+    union Storage {
+        constexpr Storage() noexcept {
+        }
+
+        constexpr ~Storage() requires(!std::is_trivially_destructible_v<Type>) {
+        }
+
+        constexpr ~Storage() = default;
+
+        Type items[N];
+    };
+
+    // Значение constexpr-переменной должно быть инициализировано целиком,
+    // поэтому на этапе компиляции свободные ячейки тривиального типа заполняются нулями.
+    // Во время выполнения буфер не трогается
+    constexpr void InitStorage() noexcept {
+        if constexpr (std::is_trivial_v<Type>) {
+            if (std::is_constant_evaluated()) {
+                for (size_t i = 0; i < N; ++i) {
+                    storage_.items[i] = Type();
+                }
+            }
+        }
+    }
+
+    constexpr Type* Data() noexcept {
+        return storage_.items;
+    }
+
+    constexpr const Type* Data() const noexcept {
+        return storage_.items;
+    }
+
+    Storage storage_;
+    size_t size_ = 0;
+};
+
+// Векторы сравниваются так же, как их представления (см. simple_span.h)
+template <typename Type, size_t N>
+constexpr bool operator==(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return ConstSimpleSpan<Type>(lhs) == ConstSimpleSpan<Type>(rhs);
+}
+
+template <typename Type, size_t N>
+constexpr bool operator!=(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return !(lhs == rhs);
+}
+
+template <typename Type, size_t N>
+constexpr bool operator<(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return ConstSimpleSpan<Type>(lhs) < ConstSimpleSpan<Type>(rhs);
+}
+
+template <typename Type, size_t N>
+constexpr bool operator<=(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename Type, size_t N>
+constexpr bool operator>(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename Type, size_t N>
+constexpr bool operator>=(const StaticVector<Type, N>& lhs, const StaticVector<Type, N>& rhs) {
+    return !(lhs < rhs);
+}
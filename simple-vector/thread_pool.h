@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Пул потоков с перехватом задач (work stealing).
+// У каждого участника своя очередь: владелец берёт задачи с конца (свежие, ещё в кэше),
+// а простаивающие потоки крадут с начала чужих очередей (самые крупные, ещё не поделённые).
+// ThreadPool(n) запускает n - 1 фоновых потоков: n-м участником считается поток,
+// ожидающий задачи в TaskGroup::Wait, поэтому ThreadPool(1) выполняет всё в вызывающем потоке
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count = std::max(1u, std::thread::hardware_concurrency()))
+        : thread_count_(std::max<size_t>(thread_count, 1)) {
+        for (size_t i = 0; i < thread_count_; ++i) {
+            queues_.push_back(std::make_unique<Queue>());
+        }
+        for (size_t i = 1; i < thread_count_; ++i) {
+            threads_.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(sleep_mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // Пул по умолчанию на все аппаратные потоки
+    static ThreadPool& Default() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    // Количество участников, включая ожидающий поток
+    size_t GetThreadCount() const noexcept {
+        return thread_count_;
+    }
+
+    // Ставит задачу в очередь текущего потока пула, а для посторонних потоков — в общую очередь 0
+    void Submit(std::function<void()> task) {
+        Queue& queue = *queues_[current_pool_ == this ? current_index_ : 0];
+        // Счётчик растёт раньше, чем задача попадает в очередь, поэтому никогда не меньше числа задач.
+        // Если очередь не смогла выделить память, счётчик откатывается, иначе потоки не уснут
+        pending_.fetch_add(1, std::memory_order_release);
+        try {
+            std::lock_guard guard(queue.mutex);
+            queue.tasks.push_back(std::move(task));
+        }
+        catch (...) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+        if (!threads_.empty()) {
+            // Пустой захват мьютекса не даёт уведомлению проскочить между проверкой
+            // условия засыпающим потоком и его засыпанием
+            { std::lock_guard guard(sleep_mutex_); }
+            wake_.notify_one();
+        }
+    }
+
+    // Выполняет одну задачу из своей очереди или украденную у других.
+    // Возвращает false, если задач не нашлось
+    bool TryRunPendingTask() {
+        const size_t own = current_pool_ == this ? current_index_ : 0;
+        std::function<void()> task;
+        if (!PopBack(own, task)) {
+            for (size_t i = 1; i <= thread_count_; ++i) {
+                if (StealFront((own + i) % thread_count_, task)) {
+                    break;
+                }
+            }
+        }
+        if (!task) {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool PopBack(size_t index, std::function<void()>& task) {
+        Queue& queue = *queues_[index];
+        std::lock_guard guard(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool StealFront(size_t index, std::function<void()>& task) {
+        Queue& queue = *queues_[index];
+        std::lock_guard guard(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void WorkerLoop(size_t index) {
+        current_pool_ = this;
+        current_index_ = index;
+        while (true) {
+            if (TryRunPendingTask()) {
+                continue;
+            }
+            std::unique_lock lock(sleep_mutex_);
+            wake_.wait(lock, [this] { return stop_ || pending_.load(std::memory_order_acquire) != 0; });
+            if (stop_) {
+                return;
+            }
+        }
+    }
+
+    inline static thread_local ThreadPool* current_pool_ = nullptr;
+    inline static thread_local size_t current_index_ = 0;
+
+    const size_t thread_count_;
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> pending_{0};
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stop_ = false;
+};
+
+// Группа задач с общим ожиданием. Wait не блокирует поток, а выполняет задачи пула,
+// поэтому группы можно вкладывать друг в друга без риска взаимной блокировки.
+// Первое исключение из задач группы пробрасывается из Wait
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) noexcept
+        : pool_(pool) {
+    }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    ~TaskGroup() {
+        WaitAll();
+    }
+
+    // Если задачу не удалось поставить в очередь (копирование задачи или выделение памяти
+    // бросило исключение), она не считается запущенной, а исключение пробрасывается
+    template <typename Task>
+    void Run(Task task) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        try {
+            pool_.Submit([this, task = std::move(task)]() mutable {
+                try {
+                    task();
+                }
+                catch (...) {
+                    std::lock_guard guard(error_mutex_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                }
+                pending_.fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        catch (...) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+    }
+
+    void Wait() {
+        WaitAll();
+        if (error_) {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+private:
+    void WaitAll() noexcept {
+        while (pending_.load(std::memory_order_acquire) != 0) {
+            if (!pool_.TryRunPendingTask()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    ThreadPool& pool_;
+    std::atomic<size_t> pending_{0};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};